@@ -0,0 +1,138 @@
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_FAILURE_USERMSG
+#include "stb/stb_image.h"
+
+#include "parameters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/// <summary>
+/// Compare the float (USE_SINGLE_PRECISION_REAL) and double builds of the core on a set of scenes :
+/// render time of each build and RMSE / PSNR / max error of the float render against the double one
+/// The double build renders each scene twice, the RMSE between those two renders is the sampling noise floor
+/// (a float RMSE close to it means the precision loss is hidden by the noise)
+/// </summary>
+
+struct image_diff
+{
+    bool valid = false;
+    double rmse = 0.0; // [0,1] channel values
+    double psnr = 0.0; // dB
+    int max_error = 0; // 8 bits
+};
+
+// Render a scene with one build of the core, returns the wall time in seconds (negative on failure)
+double render(const std::string& executable, const std::string& scene, const std::string& output, const std::string& args)
+{
+    std::string command = "\"\"" + executable + "\" -quiet -scene \"" + scene + "\" -save \"" + output + "\" " + args + "\"";
+
+    auto start = std::chrono::steady_clock::now();
+    int result = std::system(command.c_str());
+    auto end = std::chrono::steady_clock::now();
+
+    if (result != 0)
+    {
+        std::cerr << "[ERROR] Render failed (" << result << ") : " << command << std::endl;
+        return -1.0;
+    }
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+image_diff compare(const std::string& reference_path, const std::string& image_path)
+{
+    image_diff diff;
+
+    int depth = 3; // Force 3 channels (RGB)
+    int rw, rh, iw, ih, channels;
+
+    unsigned char* reference = stbi_load(reference_path.c_str(), &rw, &rh, &channels, depth);
+    unsigned char* image = stbi_load(image_path.c_str(), &iw, &ih, &channels, depth);
+
+    if (!reference || !image)
+    {
+        std::cerr << "[ERROR] Failed to load render to compare " << (reference ? image_path : reference_path) << " : " << stbi_failure_reason() << std::endl;
+    }
+    else if (rw != iw || rh != ih)
+    {
+        std::cerr << "[ERROR] Renders to compare have different sizes " << reference_path << " " << image_path << std::endl;
+    }
+    else
+    {
+        double sum = 0.0;
+        size_t count = static_cast<size_t>(rw) * rh * depth;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int error = std::abs(static_cast<int>(reference[i]) - static_cast<int>(image[i]));
+            sum += (error / 255.0) * (error / 255.0);
+            diff.max_error = std::max(diff.max_error, error);
+        }
+
+        diff.valid = true;
+        diff.rmse = std::sqrt(sum / count);
+        diff.psnr = diff.rmse > 0.0 ? 20.0 * std::log10(1.0 / diff.rmse) : INFINITY;
+    }
+
+    stbi_image_free(reference);
+    stbi_image_free(image);
+
+    return diff;
+}
+
+int main(int argc, char* argv[])
+{
+    parameters params = parameters::getArgs(argc, argv);
+
+    if (params.doublepath.empty() || params.floatpath.empty() || params.scenes.empty())
+    {
+        std::cerr << "[ERROR] Usage : -double <core exe> -float <core exe built with USE_SINGLE_PRECISION_REAL> -scenes <a.scene,b.scene> [-output <dir>] [-args \"<render args>\"]" << std::endl;
+        return -1;
+    }
+
+    std::filesystem::create_directories(params.outputpath);
+
+    int failures = 0;
+
+    for (const auto& scene : params.scenes)
+    {
+        std::string stem = std::filesystem::path(scene).stem().string();
+        std::string double_render = (std::filesystem::path(params.outputpath) / (stem + "_double.png")).string();
+        std::string noise_render = (std::filesystem::path(params.outputpath) / (stem + "_double2.png")).string();
+        std::string float_render = (std::filesystem::path(params.outputpath) / (stem + "_float.png")).string();
+
+        std::cout << "[INFO] Rendering " << scene << std::endl;
+
+        double double_time = render(params.doublepath, scene, double_render, params.renderargs);
+        double noise_time = render(params.doublepath, scene, noise_render, params.renderargs);
+        double float_time = render(params.floatpath, scene, float_render, params.renderargs);
+
+        if (double_time < 0.0 || noise_time < 0.0 || float_time < 0.0)
+        {
+            failures++;
+            continue;
+        }
+
+        image_diff noise = compare(double_render, noise_render);
+        image_diff precision = compare(double_render, float_render);
+        if (!noise.valid || !precision.valid)
+        {
+            failures++;
+            continue;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+            << "[INFO] " << stem << " : double " << double_time << " s, float " << float_time << " s (x" << double_time / float_time << ")" << std::endl
+            << std::setprecision(5)
+            << "[INFO] " << stem << " : float RMSE " << precision.rmse << " (PSNR " << std::setprecision(1) << precision.psnr << " dB, max error " << precision.max_error << "/255)"
+            << std::setprecision(5) << ", noise floor RMSE " << noise.rmse << std::defaultfloat << std::endl;
+    }
+
+    return failures;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <filesystem>
+#include <vector>
+
+using namespace std;
+
+class parameters
+{
+public:
+
+	// core built in double (default) and with USE_SINGLE_PRECISION_REAL
+	std::string doublepath;
+	std::string floatpath;
+
+	// scenes rendered by both, comma separated
+	std::vector<std::string> scenes;
+
+	// renders directory
+	std::string outputpath = std::filesystem::current_path().string();
+
+	// extra arguments given to both renders (size, spp, cores...)
+	std::string renderargs = "-width 256 -spp 64";
+
+
+	static std::string absolutePath(const string& value)
+	{
+		std::filesystem::path dir(std::filesystem::current_path());
+		std::filesystem::path file(value.c_str());
+
+		return std::filesystem::absolute(dir / file).string();
+	}
+
+	static parameters getArgs(int argc, char* argv[])
+	{
+		parameters params;
+
+		int count;
+		for (count = 0; count < argc - 1; count++)
+		{
+			string arg = argv[count];
+
+			if (arg.starts_with("-"))
+			{
+				string param = arg.substr(1);
+				string value = argv[count + 1];
+
+				if (param == "double")
+				{
+					params.doublepath = absolutePath(value);
+				}
+				else if (param == "float")
+				{
+					params.floatpath = absolutePath(value);
+				}
+				else if (param == "scenes")
+				{
+					std::stringstream list(value);
+					string scene;
+					while (std::getline(list, scene, ','))
+					{
+						if (!scene.empty())
+							params.scenes.push_back(absolutePath(scene));
+					}
+				}
+				else if (param == "output")
+				{
+					params.outputpath = absolutePath(value);
+				}
+				else if (param == "args")
+				{
+					params.renderargs = value;
+				}
+			}
+		}
+
+		return params;
+	}
+};
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include "../constants.h"
 #include "../pdf/hittable_pdf.h"
+#include "../pdf/light_sampler_pdf.h"
 #include "../pdf/mixture_pdf.h"
+#include "../pdf/guiding_pdf.h"
 #include "../misc/hit_record.h"
 #include "../misc/scatter_record.h"
 #include "../misc/singleton.h"
@@ -12,6 +14,9 @@
 #include "../textures/solid_color_texture.h"
 #include "../textures/image_texture.h"
 
+#include <algorithm>
+#include <cmath>
+
 camera::camera()
 {
 }
@@ -67,6 +72,11 @@ const ray camera::get_ray(int i, int j, int s_i, int s_j, std::shared_ptr<sample
 /// Recursive version
 /// </summary>
 color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd)
+{
+    return ray_color(r, depth, _scene, rnd, 1.0);
+}
+
+color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd, double emission_weight, bool skip_caustics)
 {
     hit_record rec;
 
@@ -80,8 +90,8 @@ color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd)
     auto unit_dir = unit_vector(r.direction());
 
     // If the ray hits nothing, return the background color.
-    // 0.001 is to fix shadow acne interval
-    if (!_scene.get_world().hit(r, interval(SHADOW_ACNE_FIX, infinity), rec, depth, rnd))
+    // offset relative to the ray origin magnitude to fix shadow acne (robust in single precision too)
+    if (!_scene.get_world().hit(r, interval(robust_epsilon(r.origin()), infinity), rec, depth, rnd))
     {
         if (background_texture)
         {
@@ -94,6 +104,8 @@ color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd)
     }
 
     // ray hit a world object
+    set_texture_footprint(r, rec);
+
     scatter_record srec;
     color color_from_emission = rec.mat->emitted(r, rec, rec.u, rec.v, rec.hit_point);
 
@@ -104,6 +116,9 @@ color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd)
         _scene.get_world().hit(r, interval(rec.t + 0.001, infinity), rec, depth, rnd);
     }
 
+    // lights already sampled by next event estimation at the previous bounce only get their MIS share
+    color_from_emission *= emission_weight;
+
     if (!rec.mat->scatter(r, _scene.get_emissive_objects(), rec, srec, rnd))
     {
         return color_from_emission;
@@ -113,14 +128,78 @@ color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd)
     {
         // no lights
         // no importance sampling
-        return srec.attenuation * ray_color(srec.skip_pdf_ray, depth - 1, _scene, rnd);
+        return srec.attenuation * ray_color(spawn_cone(r, rec, srec.skip_pdf_ray), depth - 1, _scene, rnd);
     }
 
     // no importance sampling
     if (srec.skip_pdf)
-        return srec.attenuation * ray_color(srec.skip_pdf_ray, depth - 1, _scene, rnd);
+        return srec.attenuation * ray_color(spawn_cone(r, rec, srec.skip_pdf_ray), depth - 1, _scene, rnd, skip_caustics ? 0.0 : 1.0, skip_caustics);
 
-    auto light_ptr = std::make_shared<hittable_pdf>(_scene.get_emissive_objects(), rec.hit_point);
+    if (!background_texture)
+    {
+        // radiance cache : smooth diffuse bounces past the query depth reuse the cached estimate
+        radiance_cache* cache = _scene.get_radiance_cache();
+        int bounce = max_depth - depth;
+        bool double_sided = false;
+        bool cacheable = cache && rec.mat->is_diffuse() && !rec.mat->has_alpha_texture(double_sided);
+
+        if (cacheable && bounce >= cache->get_config().query_depth)
+        {
+            color cached;
+            if (cache->lookup(rec.hit_point, rec.normal, rnd, cached))
+                return color_from_emission + srec.attenuation * cached;
+        }
+
+        // path guiding : the BSDF strategy also samples the learned incident radiance
+        path_guiding* guiding = _scene.get_path_guiding();
+        if (guiding)
+        {
+            auto distribution = guiding->get_distribution();
+            const guiding_quadtree* guide = distribution ? distribution->find(rec.hit_point) : nullptr;
+            if (guide)
+                srec.pdf_ptr = std::make_shared<mixture_pdf>(std::make_shared<guiding_pdf>(distribution, guide), srec.pdf_ptr, guiding->get_config().guiding_probability);
+        }
+
+        // next event estimation : explicit light sample with a shadow ray
+        color color_from_scatter = sample_direct_light(r, rec, srec, depth, _scene, rnd);
+
+        // caustics come from the photon map at diffuse hits, the BSDF sample must not find them again
+        photon_map* photons = _scene.get_photon_map();
+        bool photon_caustics = photons && rec.mat->is_diffuse();
+        if (photon_caustics)
+            color_from_scatter += srec.attenuation * photons->estimate(rec.hit_point, rec.normal);
+
+        // BSDF sample, the emission it finds is weighted against the light sampling strategy
+        ray scattered = ray(rec.hit_point, srec.pdf_ptr->generate(srec, rnd), r.time());
+        double bsdf_pdf = srec.pdf_ptr->value(scattered.direction(), rnd);
+
+        if (bsdf_pdf > 0.0)
+        {
+            double light_pdf = _scene.get_light_sampler().pdf_value(rec.hit_point, scattered.direction(), rnd);
+            double scattering_pdf = rec.mat->scattering_pdf(r, rec, scattered);
+
+            color sample_color = ray_color(spawn_cone(r, rec, scattered, bsdf_pdf), depth - 1, _scene, rnd, power_heuristic(bsdf_pdf, light_pdf), photon_caustics);
+            color_from_scatter = color_from_scatter + srec.attenuation * (scattering_pdf / bsdf_pdf) * sample_color;
+
+            if (guiding)
+                guiding->record(rec.hit_point, scattered.direction(), sample_color, bsdf_pdf);
+        }
+
+        // the cache is built from the first bounce estimates only (same remaining depth for all of them)
+        if (cacheable && bounce == 1)
+            cache->record(rec.hit_point, rec.normal, srec.attenuation, color_from_scatter);
+
+        if (rec.mat->has_alpha_texture(double_sided))
+        {
+            // render transparent object (having an alpha texture)
+            return color::blend_colors(color_from_emission + color_from_scatter, ray_color(spawn_cone(r, rec, ray(rec.hit_point, r.direction(), r.x, r.y, r.time())), depth - 1, _scene, rnd), srec.alpha_value);
+        }
+
+        // render opaque object
+        return color_from_emission + color_from_scatter;
+    }
+
+    auto light_ptr = std::make_shared<light_sampler_pdf>(_scene.get_light_sampler(), rec.hit_point);
 
     mixture_pdf p;
 
@@ -193,32 +272,93 @@ color camera::ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd)
         else
         {
             // render opaque object
-            color color_from_scatter = ray_color(scattered, depth - 1, _scene, rnd) / pdf_val;
-            final_color = color_from_emission + srec.attenuation * scattering_pdf * color_from_scatter;
-        }
-    }
-    else
-    {
-        // with background color
-        color sample_color = ray_color(scattered, depth - 1, _scene, rnd);
-        color color_from_scatter = (srec.attenuation * scattering_pdf * sample_color) / pdf_val;
-
-        bool double_sided = false;
-        if (rec.mat->has_alpha_texture(double_sided))
-        {
-            // render transparent object (having an alpha texture)
-            final_color = color::blend_colors(color_from_emission + color_from_scatter, ray_color(ray(rec.hit_point, r.direction(), r.x, r.y, r.time()), depth - 1, _scene, rnd), srec.alpha_value);
-        }
-        else
-        {
-            // render opaque object
-            final_color = color_from_emission + color_from_scatter;
+            // fold the scalar weights first so the color math is a single multiply-add
+            color color_from_scatter = ray_color(spawn_cone(r, rec, scattered, pdf_val), depth - 1, _scene, rnd);
+            final_color = color_from_emission + srec.attenuation * (scattering_pdf / pdf_val) * color_from_scatter;
         }
     }
 
     return final_color;
 }
 
+void camera::set_texture_footprint(const ray& r, hit_record& rec)
+{
+    rec.footprint = 0.0;
+    if (rec.uv_density <= 0)
+        return;
+
+    rreal length = vector_length(r.direction());
+    rreal width = r.cone_width + r.cone_spread * rec.t * length;
+    if (width <= 0 || length <= 0)
+        return;
+
+    // grazing angles stretch the footprint (clamped, trilinear filtering can't follow very elongated footprints anyway)
+    rreal cos_theta = std::max(std::abs(glm::dot(r.direction(), rec.normal)) / length, rreal(0.1));
+
+    rec.footprint = width / (cos_theta * rec.uv_density);
+}
+
+ray camera::spawn_cone(const ray& r_in, const hit_record& rec, const ray& scattered, double bsdf_pdf)
+{
+    ray r = scattered;
+    r.cone_width = r_in.cone_width + r_in.cone_spread * rec.t * vector_length(r_in.direction());
+    r.cone_spread = r_in.cone_spread;
+
+    if (bsdf_pdf > 0.0)
+        r.cone_spread = std::max(r.cone_spread, rreal(1.0 / std::sqrt(bsdf_pdf)));
+
+    return r;
+}
+
+bool camera::importance(const point3& p, int& i, int& j, double& we, double& pdf_dir) const
+{
+    return false;
+}
+
+color camera::get_background(const ray& r)
+{
+    if (background_texture)
+        return get_background_image_color(r.x, r.y, unit_vector(r.direction()), background_texture, background_iskybox);
+
+    return background_color;
+}
+
+color camera::sample_direct_light(const ray& r_in, const hit_record& rec, const scatter_record& srec, int depth, scene& _scene, randomizer& rnd) const
+{
+    const light_sampler& lights = _scene.get_light_sampler();
+
+    double light_pmf = 0.0;
+    int light_id = lights.sample(rec.hit_point, rnd, light_pmf);
+    if (light_id < 0 || light_pmf <= 0.0)
+        return color(0, 0, 0);
+
+    vector3 direction = lights.get_light(light_id)->random(rec.hit_point, rnd);
+
+    // pdf of the whole light strategy (any light crossed by this direction could have been picked)
+    double light_pdf = lights.pdf_value(rec.hit_point, direction, rnd);
+    if (light_pdf <= 0.0)
+        return color(0, 0, 0);
+
+    ray shadow_ray(rec.hit_point, direction, r_in.time());
+    double scattering_pdf = rec.mat->scattering_pdf(r_in, rec, shadow_ray);
+    if (scattering_pdf <= 0.0)
+        return color(0, 0, 0);
+
+    // shadow ray, the first object hit must be emissive
+    hit_record shadow_rec;
+    if (!_scene.get_world().hit(shadow_ray, interval(robust_epsilon(rec.hit_point), infinity), shadow_rec, depth - 1, rnd))
+        return color(0, 0, 0);
+
+    color emitted = shadow_rec.mat->emitted(shadow_ray, shadow_rec, shadow_rec.u, shadow_rec.v, shadow_rec.hit_point);
+    if (emitted.a() == 0.0)
+        return color(0, 0, 0);
+
+    double bsdf_pdf = srec.pdf_ptr->value(direction, rnd);
+    double weight = power_heuristic(light_pdf, bsdf_pdf);
+
+    return srec.attenuation * (scattering_pdf * weight / light_pdf) * emitted;
+}
+
 
 point3 camera::defocus_disk_sample(randomizer& rnd) const
 {
@@ -236,7 +376,7 @@ vector3 camera::direction_from(const point3& light_pos, const point3& hit_point)
 
 color camera::get_background_image_color(int x, int y, const vector3& unit_dir, std::shared_ptr<image_texture> background_texture, bool background_iskybox)
 {
-	double u, v;
+	rreal u, v;
 
 	if (background_iskybox)
         get_spherical_uv(unit_dir, background_texture->getWidth(), background_texture->getHeight(), getImageWidth(), getImageHeight(), u, v);
@@ -10,6 +10,9 @@
 #include "../misc/renderParameters.h"
 #include "../samplers/sampler.h"
 
+class hit_record;
+class scatter_record;
+
 class camera
 {
 public:
@@ -55,6 +58,17 @@ public:
 	/// </summary>
 	virtual color ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd);
 
+	/// <summary>
+	/// Importance emitted towards point p (light tracing) : pixel seen in this direction, importance We and solid angle pdf of a camera ray in this direction
+	/// False if p is outside the image or if the camera can't be connected to (only the pinhole perspective camera can)
+	/// </summary>
+	virtual bool importance(const point3& p, int& i, int& j, double& we, double& pdf_dir) const;
+
+	/// <summary>
+	/// Color of a ray escaping the scene (background color or image)
+	/// </summary>
+	color get_background(const ray& r);
+
 	const int getImageHeight() const;
 	const int getImageWidth() const;
 	const int getSqrtSpp() const;
@@ -82,4 +96,27 @@ protected:
 	vector3 direction_from(const point3& light_pos, const point3& hit_point) const;
 
 	color get_background_image_color(int x, int y, const vector3& unit_dir, std::shared_ptr<image_texture> background_texture, bool background_iskybox);
+
+	/// <summary>
+	/// Calculate ray color, emission found by this ray is scaled by emission_weight (MIS weight of the BSDF sample that spawned it)
+	/// With skip_caustics, emission reached through specular bounces is ignored (already estimated by the caustic photon map)
+	/// </summary>
+	color ray_color(const ray& r, int depth, scene& _scene, randomizer& rnd, double emission_weight, bool skip_caustics = false);
+
+	/// <summary>
+	/// Next event estimation : sample one light, trace one shadow ray and weight the result against BSDF sampling (power heuristic)
+	/// </summary>
+	color sample_direct_light(const ray& r_in, const hit_record& rec, const scatter_record& srec, int depth, scene& _scene, randomizer& rnd) const;
+
+	/// <summary>
+	/// Ray cone at the hit point (ray differentials reduced to a width and a spread angle, Akenine-Moller 2019)
+	/// Sets the texture footprint of the hit record
+	/// </summary>
+	static void set_texture_footprint(const ray& r, hit_record& rec);
+
+	/// <summary>
+	/// Continue the ray cone of r_in on a ray scattered at the hit point
+	/// Specular bounces keep the spread, other ones widen it to the angle of one sample of the lobe (bsdf_pdf)
+	/// </summary>
+	static ray spawn_cone(const ray& r_in, const hit_record& rec, const ray& scattered, double bsdf_pdf = 0.0);
 };
\ No newline at end of file
@@ -39,8 +39,8 @@ void orthographic_camera::initialize(const renderParameters& params)
     v = glm::cross(w, u);
 
     // Calculate the vectors across the horizontal and down the vertical viewport edges.
-    vector3 viewport_u = viewport_width * u;    // Vector across viewport horizontal edge
-    vector3 viewport_v = viewport_height * -v;  // Vector down viewport vertical edge
+    vector3 viewport_u = rreal(viewport_width) * u;    // Vector across viewport horizontal edge
+    vector3 viewport_v = rreal(viewport_height) * -v;  // Vector down viewport vertical edge
 
     // Calculate the horizontal and vertical delta vectors from pixel to pixel.
     pixel_delta_u = viewport_u / vector3(image_width);
@@ -48,7 +48,7 @@ void orthographic_camera::initialize(const renderParameters& params)
 
     // Calculate the location of the upper left pixel.
     vector3 viewport_upper_left = center - viewport_u / vector3(2) - viewport_v / vector3(2);
-    pixel00_loc = viewport_upper_left + 0.5 * (pixel_delta_u + pixel_delta_v);
+    pixel00_loc = viewport_upper_left + rreal(0.5) * (pixel_delta_u + pixel_delta_v);
 }
 
 const ray orthographic_camera::get_ray(int i, int j, int s_i, int s_j, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const
@@ -74,5 +74,10 @@ const ray orthographic_camera::get_ray(int i, int j, int s_i, int s_j, std::shar
     auto ray_direction = -w;
     auto ray_time = rnd.get_real(0.0, 1.0); // for motion blur
 
-    return ray(ray_origin, ray_direction, i, j, ray_time);
+    ray r(ray_origin, ray_direction, i, j, ray_time);
+
+    // parallel rays, the footprint is one pixel wide everywhere (texture filtering)
+    r.cone_width = vector_length(pixel_delta_v);
+
+    return r;
 }
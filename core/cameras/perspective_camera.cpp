@@ -31,7 +31,7 @@ void perspective_camera::initialize(const renderParameters& params)
     {
         double default_distance = 10.0; // Default camera distance
         vector3 default_direction(0.0, 0.0, -1.0); // Default forward direction
-        lookfrom = lookat - default_distance * default_direction;
+        lookfrom = lookat - rreal(default_distance) * default_direction;
     }
 
     center = lookfrom;
@@ -52,8 +52,8 @@ void perspective_camera::initialize(const renderParameters& params)
     v = glm::cross(w, u);
 
     // Calculate the vectors across the horizontal and down the vertical viewport edges.
-    vector3 viewport_u = viewport_width * u;    // Vector across viewport horizontal edge
-    vector3 viewport_v = viewport_height * -v;  // Vector down viewport vertical edge
+    vector3 viewport_u = rreal(viewport_width) * u;    // Vector across viewport horizontal edge
+    vector3 viewport_v = rreal(viewport_height) * -v;  // Vector down viewport vertical edge
 
 
 
@@ -63,13 +63,13 @@ void perspective_camera::initialize(const renderParameters& params)
 
 
     // Calculate the location of the upper left pixel.
-    vector3 viewport_upper_left = center - (focus_dist * w) - viewport_u / vector3(2) - viewport_v / vector3(2);
-    pixel00_loc = viewport_upper_left + 0.5 * (pixel_delta_u + pixel_delta_v);
+    vector3 viewport_upper_left = center - (rreal(focus_dist) * w) - viewport_u / vector3(2) - viewport_v / vector3(2);
+    pixel00_loc = viewport_upper_left + rreal(0.5) * (pixel_delta_u + pixel_delta_v);
 
     // Calculate the camera defocus disk basis vectors.
     double defocus_radius = focus_dist * tan(degrees_to_radians(defocus_angle / 2));
-    defocus_disk_u = u * defocus_radius;
-    defocus_disk_v = v * defocus_radius;
+    defocus_disk_u = u * rreal(defocus_radius);
+    defocus_disk_v = v * rreal(defocus_radius);
 }
 
 const ray perspective_camera::get_ray(int i, int j, int s_i, int s_j, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const
@@ -95,5 +95,47 @@ const ray perspective_camera::get_ray(int i, int j, int s_i, int s_j, std::share
     auto ray_direction = pixel_sample - ray_origin;
     auto ray_time = rnd.get_real(0.0, 1.0); // for motion blur
 
-    return ray(ray_origin, ray_direction, i, j, ray_time);
-}
\ No newline at end of file
+    ray r(ray_origin, ray_direction, i, j, ray_time);
+
+    // ray cone of one pixel (texture filtering)
+    r.cone_spread = vector_length(pixel_delta_v) / focus_dist;
+
+    return r;
+}
+
+bool perspective_camera::importance(const point3& p, int& i, int& j, double& we, double& pdf_dir) const
+{
+    // a lens would need its own sampling
+    if (defocus_angle > 0)
+        return false;
+
+    vector3 d = p - center;
+    double distance = vector_length(d);
+    if (distance <= 0.0)
+        return false;
+
+    double cos_theta = glm::dot(d, -w) / distance;
+    if (cos_theta <= 0.0)
+        return false;
+
+    // intersection with the viewport plane, then pixel coordinates
+    point3 on_plane = center + d * rreal(focus_dist / (cos_theta * distance));
+    vector3 from_corner = on_plane - (pixel00_loc - rreal(0.5) * (pixel_delta_u + pixel_delta_v));
+
+    double x = glm::dot(from_corner, pixel_delta_u) / vector_length_squared(pixel_delta_u);
+    double y = glm::dot(from_corner, pixel_delta_v) / vector_length_squared(pixel_delta_v);
+    if (x < 0.0 || y < 0.0 || x >= image_width || y >= image_height)
+        return false;
+
+    i = static_cast<int>(x);
+    j = static_cast<int>(y);
+
+    // viewport area at distance 1
+    double area = vector_length(pixel_delta_u) * image_width * vector_length(pixel_delta_v) * image_height / (focus_dist * focus_dist);
+    double cos2 = cos_theta * cos_theta;
+
+    we = 1.0 / (area * cos2 * cos2);
+    pdf_dir = 1.0 / (area * cos2 * cos_theta);
+
+    return true;
+}
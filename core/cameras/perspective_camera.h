@@ -29,6 +29,11 @@ public:
     /// <returns></returns>
     const ray get_ray(int i, int j, int s_i, int s_j, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const override;
 
+    /// <summary>
+    /// Pinhole importance (no depth of field)
+    /// </summary>
+    bool importance(const point3& p, int& i, int& j, double& we, double& pdf_dir) const override;
+
 private:
 
 };
\ No newline at end of file
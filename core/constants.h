@@ -3,6 +3,14 @@
 #include <limits>
 #include <numbers>
 
+// Real type used by the core geometry (vectors, colors, rays, intervals, bounding boxes and primitives)
+// Define USE_SINGLE_PRECISION_REAL to build the core in float instead of double
+#ifdef USE_SINGLE_PRECISION_REAL
+typedef float rreal;
+#else
+typedef double rreal;
+#endif
+
 // Constants
 const double infinity = std::numeric_limits<double>::infinity();
 //const double M_PI = 3.1415926535897932385; //3.141592653589793238462643383279502884 ???
@@ -15,7 +23,19 @@ const double M_1_PI = 0.318309886183790671538;  // 1/pi
 
 const double M_PI_2 = 1.57079632679489661923;   // pi/2
 
-const double SHADOW_ACNE_FIX = 0.00001;
+#ifdef USE_SINGLE_PRECISION_REAL
+// float has ~7 significant digits, epsilons must be larger to stay above the rounding error
+const rreal SHADOW_ACNE_FIX = 0.0005f;
+const rreal PARALLEL_EPSILON = 1e-6f;
+const rreal ZERO_EPSILON = 1e-6f;
+#else
+const rreal SHADOW_ACNE_FIX = 0.00001;
+const rreal PARALLEL_EPSILON = 1e-8;
+const rreal ZERO_EPSILON = 1e-9;
+#endif
+
+// ray/triangle parallel test (determinant of the edges, large enough for both precisions)
+const rreal TRIANGLE_EPSILON = 0.000001;
 
 // to test !!!!!!!!!!!!!!
 //const float SHADOW_BIAS = 1e-4;
\ No newline at end of file
@@ -2,11 +2,15 @@
 
 #include "../constants.h"
 #include "../misc/singleton.h"
+#include "../misc/onb.h"
 #include "../materials/diffuse_light.h"
 #include "../utilities/math_utils.h"
+#include "../utilities/spherical_sampling.h"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+
 directional_light::directional_light(const point3& _position, const vector3& _u, const vector3& _v, double _intensity, color _color, std::string _name, bool _invisible)
     : light(_position, _intensity, _color, _invisible, _name), m_u(_u), m_v(_v)
 {
@@ -25,8 +29,8 @@ directional_light::directional_light(const point3& _position, const vector3& _u,
 void directional_light::set_bounding_box()
 {
     // Calculate the quad's corners
-    point3 corner1 = m_position - 0.5 * (m_u + m_v);
-    point3 corner2 = m_position + 0.5 * (m_u + m_v);
+    point3 corner1 = m_position - rreal(0.5) * (m_u + m_v);
+    point3 corner2 = m_position + rreal(0.5) * (m_u + m_v);
 
     m_bbox = aabb(corner1, corner2).pad();
 }
@@ -112,27 +116,119 @@ bool directional_light::is_interior(double a, double b, hit_record& rec) const
 
 double directional_light::pdf_value(const point3& origin, const vector3& v, randomizer& rnd) const
 {
-    hit_record rec;
+    // analytic pdf, the same sampling strategy as random() is selected from origin
+    point3 p0 = m_position - rreal(0.5) * (m_u + m_v), p1 = p0 + m_u, p2 = p0 + m_u + m_v, p3 = p0 + m_v;
+
+    double solid_angle_1 = spherical_triangle_solid_angle(origin, p0, p1, p2);
+    double solid_angle_2 = spherical_triangle_solid_angle(origin, p0, p2, p3);
+    double solid_angle = solid_angle_1 + solid_angle_2;
+
+    if (solid_angle >= MIN_SPHERICAL_SAMPLING_SOLID_ANGLE)
+    {
+        if (!spherical_triangle_contains(origin, p0, p1, p2, v) && !spherical_triangle_contains(origin, p0, p2, p3, v))
+            return 0;
+
+        return 1.0 / solid_angle;
+    }
+
+    // small or far light : area sampling, plane coordinates of the crossing point without filling a hit record
+    auto denom = glm::dot(m_normal, v);
+    if (fabs(denom) < 1e-8)
+        return 0;
+
+    auto t = (D - glm::dot(m_normal, origin)) / denom;
+    if (t <= SHADOW_ACNE_FIX)
+        return 0;
 
-    if (!this->hit(ray(origin, v), interval(SHADOW_ACNE_FIX, infinity), rec, 0, rnd))
+    vector3 planar_hitpt_vector = origin + rreal(t) * v - m_position;
+    auto alpha = glm::dot(w, glm::cross(planar_hitpt_vector, m_v));
+    auto beta = glm::dot(w, glm::cross(m_u, planar_hitpt_vector));
+    if ((alpha < -0.5) || (0.5 < alpha) || (beta < -0.5) || (0.5 < beta))
         return 0;
 
-    auto distance_squared = rec.t * rec.t * vector_length_squared(v);
-    auto cosine = fabs(dot(v, rec.normal) / vector_length(v));
+    auto distance_squared = t * t * vector_length_squared(v);
+    auto cosine = fabs(denom / vector_length(v));
 
     return distance_squared / (cosine * area);
 }
 
 /// <summary>
 /// Random special implementation for quad light (override base)
+/// Uniform in the solid angle subtended by the quad (split in two spherical triangles picked proportionally to their solid angle)
 /// </summary>
 /// <param name="origin"></param>
 /// <returns></returns>
 vector3 directional_light::random(const point3& origin, randomizer& rnd) const
 {
-    auto p = m_position 
-        + (rnd.get_real(0.0, 1.0) - 0.5) * m_u 
-        + (rnd.get_real(0.0, 1.0) - 0.5) * m_v;
+    double r1 = rnd.get_real(0.0, 1.0);
+    double r2 = rnd.get_real(0.0, 1.0);
+
+    point3 p0 = m_position - rreal(0.5) * (m_u + m_v), p1 = p0 + m_u, p2 = p0 + m_u + m_v, p3 = p0 + m_v;
+
+    double solid_angle_1 = spherical_triangle_solid_angle(origin, p0, p1, p2);
+    double solid_angle_2 = spherical_triangle_solid_angle(origin, p0, p2, p3);
+    double solid_angle = solid_angle_1 + solid_angle_2;
+
+    if (solid_angle >= MIN_SPHERICAL_SAMPLING_SOLID_ANGLE)
+    {
+        // r1 picks the triangle then is remapped to [0, 1) to sample inside it
+        double p_first = solid_angle_1 / solid_angle;
+        if (r1 < p_first)
+            return sample_spherical_triangle(origin, p0, p1, p2, r1 / p_first, r2);
+
+        return sample_spherical_triangle(origin, p0, p2, p3, std::min((r1 - p_first) / (1.0 - p_first), 0.99999999999999989), r2);
+    }
+
+    auto p = p0
+        + rreal(r1) * m_u 
+        + rreal(r2) * m_v;
 
     return p - origin;
+}
+
+double directional_light::getArea() const
+{
+    return area;
+}
+
+light_bounds directional_light::getLightBounds() const
+{
+    light_bounds lb;
+    lb.bounds = m_bbox;
+    lb.axis = m_normal;
+    lb.theta_o = m_invisible ? 0.0 : M_PI; // visible quads emit on both faces
+    lb.theta_e = M_PI_2;
+    lb.power = getPower();
+    return lb;
+}
+
+bool directional_light::sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const
+{
+    if (area <= 0.0)
+        return false;
+
+    point3 p = m_position
+        + rreal(rnd.get_real(0.0, 1.0) - 0.5) * m_u
+        + rreal(rnd.get_real(0.0, 1.0) - 0.5) * m_v;
+
+    // the front face emits along the normal, visible quads emit on both faces
+    normal = m_normal;
+    if (!m_invisible && rnd.get_real(0.0, 1.0) < 0.5)
+        normal = -normal;
+
+    onb uvw;
+    uvw.build_from_w(normal);
+    photon = ray(p, uvw.local(rnd.get_cosine_direction()));
+    radiance = m_color * rreal(m_intensity);
+    pdf_dir = emission_pdf(p, normal, photon.direction(), pdf_pos);
+
+    return true;
+}
+
+double directional_light::emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const
+{
+    pdf_pos = area > 0.0 ? 1.0 / area : 0.0;
+
+    double cosine = std::abs(glm::dot(normal, unit_vector(direction)));
+    return m_invisible ? cosine / M_PI : 0.5 * cosine / M_PI;
 }
\ No newline at end of file
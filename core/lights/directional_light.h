@@ -26,6 +26,11 @@ public:
     /// <returns></returns>
     vector3 random(const point3& origin, randomizer& rnd) const override;
 
+    double getArea() const override;
+    light_bounds getLightBounds() const override;
+    bool sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const override;
+    double emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const override;
+
 
 private:
     vector3 m_u{}; // vector representing the first side of the quadrilateral
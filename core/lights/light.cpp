@@ -1,5 +1,9 @@
 #include "light.h"
 
+#include <cmath>
+
+#include <glm/glm.hpp>
+
 light::light(point3 _position, double _intensity, color _color, bool _invisible, std::string _name)
     : m_position(_position), m_intensity(_intensity), m_color(_color), m_invisible(_invisible)
 {
@@ -26,6 +30,49 @@ point3 light::getPosition() const
     return m_position;
 }
 
+double light::getArea() const
+{
+    return 1.0;
+}
+
+double light::getPower() const
+{
+    double luminance = 0.2126 * m_color.r() + 0.7152 * m_color.g() + 0.0722 * m_color.b();
+    return m_intensity * luminance * getArea();
+}
+
+light_bounds light::getLightBounds() const
+{
+    // omni directional emission by default
+    light_bounds lb;
+    lb.bounds = bounding_box();
+    lb.power = getPower();
+    return lb;
+}
+
+bool light::sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const
+{
+    return false;
+}
+
+double light::emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const
+{
+    // uniform position, cosine weighted direction
+    double area = getArea();
+    pdf_pos = area > 0.0 ? 1.0 / area : 0.0;
+
+    double cosine = std::abs(glm::dot(normal, unit_vector(direction)));
+    return cosine / M_PI;
+}
+
+std::vector<std::shared_ptr<material>> light::getMaterials() const
+{
+    if (!m_mat)
+        return {};
+
+    return { m_mat };
+}
+
 void light::updateBoundingBox()
 {
     // to implement
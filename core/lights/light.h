@@ -1,11 +1,27 @@
 #pragma once
 
+#include "../constants.h"
 #include "../misc/color.h"
 #include "../utilities/types.h"
 #include "../primitives/hittable.h"
 #include "../misc/aabb.h"
 #include "../materials/material.h"
 
+#include <vector>
+
+/// <summary>
+/// Spatial and directional emission bounds of a light (or of a group of lights)
+/// Emission happens around axis within theta_o, then falls off to zero within theta_e more
+/// </summary>
+struct light_bounds
+{
+    aabb bounds;
+    vector3 axis{ 0, 0, 1 };
+    double theta_o = M_PI; // normals spread (pi means emission in all directions)
+    double theta_e = M_PI_2; // emission spread around each normal
+    double power = 0.0;
+};
+
 /// <summary>
 /// Abstract class for lights
 /// </summary>
@@ -19,6 +35,37 @@ public:
     color getColor() const;
     virtual point3 getPosition() const;
 
+    /// <summary>
+    /// Emitting surface area of the light
+    /// </summary>
+    virtual double getArea() const;
+
+    /// <summary>
+    /// Approximate emitted power (intensity x luminance x area), used to weight light sampling
+    /// </summary>
+    virtual double getPower() const;
+
+    /// <summary>
+    /// Emission bounds used by the light BVH
+    /// </summary>
+    virtual light_bounds getLightBounds() const;
+
+    /// <summary>
+    /// Sample a ray leaving the light : origin (normal, area pdf), direction (solid angle pdf) and radiance emitted along it
+    /// False if the light can't emit (photon mapping and light tracing skip it)
+    /// </summary>
+    virtual bool sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const;
+
+    /// <summary>
+    /// Pdfs of sample_emission for a ray leaving point p (on the light) in the given direction, returns the direction pdf
+    /// </summary>
+    virtual double emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const;
+
+    /// <summary>
+    /// Materials of the emitting surfaces (identify the light a ray has hit)
+    /// </summary>
+    virtual std::vector<std::shared_ptr<material>> getMaterials() const;
+
 
 private:
     /// <summary>
@@ -0,0 +1,241 @@
+#include "light_bvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+void light_bvh::build(const std::vector<light_bounds>& lights)
+{
+    clear();
+
+    if (lights.empty())
+        return;
+
+    std::vector<light_bounds> bounds = lights;
+    std::vector<int> ids(lights.size());
+    for (size_t i = 0; i < ids.size(); i++)
+        ids[i] = static_cast<int>(i);
+
+    m_trails.assign(lights.size(), 0);
+    m_nodes.reserve(2 * lights.size() - 1);
+
+    build_recursive(bounds, ids, 0, static_cast<int>(ids.size()), 0, 0);
+}
+
+void light_bvh::clear()
+{
+    m_nodes.clear();
+    m_trails.clear();
+}
+
+bool light_bvh::empty() const
+{
+    return m_nodes.empty();
+}
+
+int light_bvh::build_recursive(std::vector<light_bounds>& lights, std::vector<int>& ids, int begin, int end, uint64_t trail, int depth)
+{
+    int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(node());
+
+    if (end - begin == 1)
+    {
+        int light_id = ids[begin];
+        m_nodes[index].lb = lights[light_id];
+        m_nodes[index].light_id = light_id;
+        m_trails[light_id] = trail;
+        return index;
+    }
+
+    // split at the median of the centroids along the largest axis (balanced tree, depth is log2(N))
+    aabb centroids;
+    for (int i = begin; i < end; i++)
+    {
+        const aabb& b = lights[ids[i]].bounds;
+        vector3 c = (b.min() + b.max()) * rreal(0.5);
+        centroids = aabb(centroids, aabb(c, c));
+    }
+
+    vector3 extent = centroids.max() - centroids.min();
+    int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    int mid = (begin + end) / 2;
+    std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end, [&](int a, int b)
+    {
+        const aabb& ba = lights[a].bounds;
+        const aabb& bb = lights[b].bounds;
+        return (ba.min()[axis] + ba.max()[axis]) < (bb.min()[axis] + bb.max()[axis]);
+    });
+
+    int first = build_recursive(lights, ids, begin, mid, trail, depth + 1);
+    int second = build_recursive(lights, ids, mid, end, trail | (uint64_t(1) << depth), depth + 1);
+
+    m_nodes[index].second_child = second;
+    m_nodes[index].lb = merge(m_nodes[first].lb, m_nodes[second].lb);
+
+    return index;
+}
+
+int light_bvh::sample(const point3& p, double u, double& pmf) const
+{
+    pmf = 0.0;
+    if (m_nodes.empty())
+        return -1;
+
+    int index = 0;
+    double probability = 1.0;
+
+    while (m_nodes[index].light_id < 0)
+    {
+        double p_first = first_child_probability(p, index);
+
+        // reuse u for the next level
+        if (u < p_first)
+        {
+            u = u / p_first;
+            probability *= p_first;
+            index = index + 1;
+        }
+        else
+        {
+            u = std::min((u - p_first) / (1.0 - p_first), 0.99999999999999989);
+            probability *= 1.0 - p_first;
+            index = m_nodes[index].second_child;
+        }
+    }
+
+    pmf = probability;
+    return m_nodes[index].light_id;
+}
+
+double light_bvh::pmf(const point3& p, int light_id) const
+{
+    if (light_id < 0 || light_id >= static_cast<int>(m_trails.size()))
+        return 0.0;
+
+    uint64_t trail = m_trails[light_id];
+    int index = 0;
+    double probability = 1.0;
+
+    for (int depth = 0; m_nodes[index].light_id < 0; depth++)
+    {
+        double p_first = first_child_probability(p, index);
+
+        if (trail & (uint64_t(1) << depth))
+        {
+            probability *= 1.0 - p_first;
+            index = m_nodes[index].second_child;
+        }
+        else
+        {
+            probability *= p_first;
+            index = index + 1;
+        }
+    }
+
+    return probability;
+}
+
+double light_bvh::first_child_probability(const point3& p, int node_index) const
+{
+    const node& first = m_nodes[node_index + 1];
+    const node& second = m_nodes[m_nodes[node_index].second_child];
+
+    double i0 = importance(p, first.lb);
+    double i1 = importance(p, second.lb);
+
+    if (i0 + i1 > 0.0)
+        return i0 / (i0 + i1);
+
+    // no child seems to light p, fallback on power so every light keeps a non zero probability
+    double total_power = first.lb.power + second.lb.power;
+    if (total_power > 0.0)
+        return first.lb.power / total_power;
+
+    return 0.5;
+}
+
+double light_bvh::importance(const point3& p, const light_bounds& lb)
+{
+    if (lb.power <= 0.0)
+        return 0.0;
+
+    point3 pc = (lb.bounds.min() + lb.bounds.max()) * rreal(0.5);
+    double radius = 0.5 * vector_length(lb.bounds.max() - lb.bounds.min());
+
+    // distance clamped to the bounds radius (avoids infinite importance when p is inside)
+    double d2 = vector_length_squared(p - pc);
+    d2 = std::max(d2, radius * radius);
+
+    double distance = std::sqrt(vector_length_squared(p - pc));
+    if (distance <= 0.0)
+        return lb.power / d2;
+
+    // angle between the cone axis and the direction to p
+    vector3 wi = (p - pc) / rreal(distance);
+    double cos_theta_w = std::clamp(static_cast<double>(glm::dot(lb.axis, wi)), -1.0, 1.0);
+    double theta_w = std::acos(cos_theta_w);
+
+    // angular size of the bounds seen from p
+    double theta_b = distance > radius ? std::asin(radius / distance) : M_PI;
+
+    // minimum angle between any emitter normal and the direction to p
+    double theta_p = std::max(0.0, theta_w - lb.theta_o - theta_b);
+    if (theta_p >= lb.theta_e)
+        return 0.0;
+
+    return lb.power * std::cos(theta_p) / d2;
+}
+
+light_bounds light_bvh::merge(const light_bounds& a, const light_bounds& b)
+{
+    light_bounds lb;
+    lb.bounds = aabb(a.bounds, b.bounds);
+    lb.power = a.power + b.power;
+    lb.theta_e = std::max(a.theta_e, b.theta_e);
+
+    // bounds of two orientation cones (the wider one is "wide", the other is "narrow")
+    const light_bounds& wide = a.theta_o >= b.theta_o ? a : b;
+    const light_bounds& narrow = a.theta_o >= b.theta_o ? b : a;
+
+    double cos_theta_d = std::clamp(static_cast<double>(glm::dot(wide.axis, narrow.axis)), -1.0, 1.0);
+    double theta_d = std::acos(cos_theta_d);
+
+    if (std::min(theta_d + narrow.theta_o, M_PI) <= wide.theta_o)
+    {
+        // narrow cone already inside the wide one
+        lb.axis = wide.axis;
+        lb.theta_o = wide.theta_o;
+        return lb;
+    }
+
+    double theta_o = 0.5 * (wide.theta_o + theta_d + narrow.theta_o);
+    if (theta_o >= M_PI)
+    {
+        lb.axis = wide.axis;
+        lb.theta_o = M_PI;
+        return lb;
+    }
+
+    // rotate the wide axis towards the narrow one
+    vector3 rotation_axis = glm::cross(wide.axis, narrow.axis);
+    double rotation_length = vector_length(rotation_axis);
+    if (rotation_length < 1e-9)
+    {
+        lb.axis = wide.axis;
+        lb.theta_o = M_PI;
+        return lb;
+    }
+
+    rotation_axis /= rreal(rotation_length);
+    double theta_r = theta_o - wide.theta_o;
+
+    // Rodrigues formula (rotation axis is perpendicular to the rotated vector)
+    lb.axis = unit_vector(wide.axis * rreal(std::cos(theta_r)) + glm::cross(rotation_axis, wide.axis) * rreal(std::sin(theta_r)));
+    lb.theta_o = theta_o;
+
+    return lb;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "light.h"
+#include "../misc/ray.h"
+#include "../utilities/types.h"
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Bounding volume hierarchy over the scene lights (bounds, orientation cone and power per node)
+/// A light is picked by walking down the tree and choosing a child proportionally to its estimated importance at the shading point
+/// Sampling and pmf evaluation are O(log N)
+/// https://fpsunflower.github.io/ckulla/data/many-lights-hpg2018.pdf (Conty & Kulla 2018)
+/// </summary>
+class light_bvh
+{
+public:
+    light_bvh() = default;
+
+    /// <summary>
+    /// Build the tree, light ids are the indices in the bounds array
+    /// </summary>
+    void build(const std::vector<light_bounds>& lights);
+    void clear();
+
+    bool empty() const;
+
+    /// <summary>
+    /// Pick a light id according to the importance at point p and return its probability
+    /// </summary>
+    int sample(const point3& p, double u, double& pmf) const;
+
+    /// <summary>
+    /// Probability to pick the given light id at point p
+    /// </summary>
+    double pmf(const point3& p, int light_id) const;
+
+    /// <summary>
+    /// Call func(light_id, pmf) for each light whose bounds are crossed by the ray (other lights can't be hit in this direction)
+    /// </summary>
+    template<typename Func>
+    void for_each_crossed_light(const ray& r, Func func) const;
+
+private:
+    struct node
+    {
+        light_bounds lb;
+        int second_child = -1; // first child is the next node
+        int light_id = -1; // leaf only
+    };
+
+    std::vector<node> m_nodes;
+
+    // path from the root to each light leaf (bit i set means second child at depth i)
+    std::vector<uint64_t> m_trails;
+
+    int build_recursive(std::vector<light_bounds>& lights, std::vector<int>& ids, int begin, int end, uint64_t trail, int depth);
+
+    static light_bounds merge(const light_bounds& a, const light_bounds& b);
+    static double importance(const point3& p, const light_bounds& lb);
+
+    /// <summary>
+    /// Probability to go to the first child of an internal node
+    /// </summary>
+    double first_child_probability(const point3& p, int node_index) const;
+};
+
+template<typename Func>
+void light_bvh::for_each_crossed_light(const ray& r, Func func) const
+{
+    if (m_nodes.empty())
+        return;
+
+    struct entry { int index; double pmf; };
+    entry stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = { 0, 1.0 };
+
+    const point3 p = r.origin();
+
+    while (stack_size > 0)
+    {
+        entry e = stack[--stack_size];
+        const node& n = m_nodes[e.index];
+
+        if (!n.lb.bounds.hit(r, interval(SHADOW_ACNE_FIX, infinity)))
+            continue;
+
+        if (n.light_id >= 0)
+        {
+            func(n.light_id, e.pmf);
+            continue;
+        }
+
+        double p_first = first_child_probability(p, e.index);
+        if (p_first > 0.0)
+            stack[stack_size++] = { e.index + 1, e.pmf * p_first };
+        if (p_first < 1.0)
+            stack[stack_size++] = { n.second_child, e.pmf * (1.0 - p_first) };
+    }
+}
@@ -0,0 +1,133 @@
+#include "light_sampler.h"
+
+#include "light.h"
+
+void light_sampler::build(const hittable_list& lights)
+{
+    clear();
+
+    std::vector<double> weights;
+    std::vector<light_bounds> bounds;
+    weights.reserve(lights.objects.size());
+    bounds.reserve(lights.objects.size());
+
+    for (const auto& object : lights.objects)
+    {
+        light_bounds lb;
+
+        std::shared_ptr<light> derived = std::dynamic_pointer_cast<light>(object);
+        if (derived)
+        {
+            lb = derived->getLightBounds();
+        }
+        else
+        {
+            // unknown emitter : omni directional with unit power
+            lb.bounds = object->bounding_box();
+            lb.power = 1.0;
+        }
+
+        m_ids[object.get()] = static_cast<int>(m_lights.size());
+        if (derived)
+        {
+            for (const auto& mat : derived->getMaterials())
+                m_material_ids[mat.get()] = static_cast<int>(m_lights.size());
+        }
+        m_lights.push_back(object);
+        weights.push_back(lb.power);
+        bounds.push_back(lb);
+    }
+
+    // all zero weights give an uniform distribution
+    m_table.build(weights);
+    m_bvh.build(bounds);
+}
+
+void light_sampler::clear()
+{
+    m_lights.clear();
+    m_ids.clear();
+    m_material_ids.clear();
+    m_table.clear();
+    m_bvh.clear();
+}
+
+size_t light_sampler::size() const
+{
+    return m_lights.size();
+}
+
+int light_sampler::sample(randomizer& rnd, double& pmf) const
+{
+    if (m_lights.empty())
+    {
+        pmf = 0.0;
+        return -1;
+    }
+
+    int light_id = m_table.sample(rnd.get_real());
+    pmf = m_table.pmf(light_id);
+
+    return light_id;
+}
+
+double light_sampler::pmf(int light_id) const
+{
+    return m_table.pmf(light_id);
+}
+
+int light_sampler::sample(const point3& p, randomizer& rnd, double& pmf) const
+{
+    return m_bvh.sample(p, rnd.get_real(), pmf);
+}
+
+double light_sampler::pmf(const point3& p, int light_id) const
+{
+    return m_bvh.pmf(p, light_id);
+}
+
+const std::shared_ptr<hittable>& light_sampler::get_light(int light_id) const
+{
+    return m_lights[light_id];
+}
+
+int light_sampler::get_light_id(const hittable* object) const
+{
+    auto it = m_ids.find(object);
+    if (it == m_ids.end())
+        return -1;
+
+    return it->second;
+}
+
+int light_sampler::get_light_id(const material* mat) const
+{
+    auto it = m_material_ids.find(mat);
+    if (it == m_material_ids.end())
+        return -1;
+
+    return it->second;
+}
+
+double light_sampler::pdf_value(const point3& origin, const vector3& direction, randomizer& rnd) const
+{
+    double sum = 0.0;
+
+    // only the lights whose BVH bounds are crossed by the direction can contribute
+    m_bvh.for_each_crossed_light(ray(origin, direction), [&](int light_id, double light_pmf)
+    {
+        sum += light_pmf * m_lights[light_id]->pdf_value(origin, direction, rnd);
+    });
+
+    return sum;
+}
+
+vector3 light_sampler::random(const point3& origin, randomizer& rnd) const
+{
+    double light_pmf;
+    int light_id = sample(origin, rnd, light_pmf);
+    if (light_id < 0)
+        return vector3();
+
+    return m_lights[light_id]->random(origin, rnd);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../primitives/hittable.h"
+#include "../primitives/hittable_list.h"
+#include "../randomizers/randomizer.h"
+#include "../utilities/alias_table.h"
+#include "light_bvh.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Picks a light for a shading point
+/// Built once when the scene emissive objects are extracted :
+/// - an alias table on the emitted power (intensity x luminance x area), sampling and pmf by light id are O(1)
+/// - a light BVH estimating the importance of each light at the shading point, sampling and pmf are O(log N)
+/// </summary>
+class light_sampler
+{
+public:
+    light_sampler() = default;
+
+    void build(const hittable_list& lights);
+    void clear();
+
+    size_t size() const;
+
+    /// <summary>
+    /// Pick a light id (power only, independent of the shading point) and return its selection probability
+    /// </summary>
+    int sample(randomizer& rnd, double& pmf) const;
+
+    /// <summary>
+    /// Probability to pick the given light id (power only, independent of the shading point)
+    /// </summary>
+    double pmf(int light_id) const;
+
+    /// <summary>
+    /// Pick a light id according to its importance at point p and return its selection probability
+    /// </summary>
+    int sample(const point3& p, randomizer& rnd, double& pmf) const;
+
+    /// <summary>
+    /// Probability to pick the given light id at point p
+    /// </summary>
+    double pmf(const point3& p, int light_id) const;
+
+    const std::shared_ptr<hittable>& get_light(int light_id) const;
+
+    /// <summary>
+    /// Id of a light (-1 if the object is not a sampled light)
+    /// </summary>
+    int get_light_id(const hittable* object) const;
+
+    /// <summary>
+    /// Id of the light emitting through the given material (-1 if none), identifies the light a ray has hit
+    /// </summary>
+    int get_light_id(const material* mat) const;
+
+    /// <summary>
+    /// Direction pdf from origin (solid angle), combining each light pdf with its selection probability
+    /// </summary>
+    double pdf_value(const point3& origin, const vector3& direction, randomizer& rnd) const;
+
+    /// <summary>
+    /// Direction from origin towards a power sampled light
+    /// </summary>
+    vector3 random(const point3& origin, randomizer& rnd) const;
+
+private:
+    std::vector<std::shared_ptr<hittable>> m_lights;
+    std::unordered_map<const hittable*, int> m_ids;
+    std::unordered_map<const material*, int> m_material_ids;
+    alias_table m_table;
+    light_bvh m_bvh;
+};
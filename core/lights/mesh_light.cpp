@@ -0,0 +1,290 @@
+#include "mesh_light.h"
+
+#include "../misc/hit_record.h"
+#include "../misc/onb.h"
+
+#include <algorithm>
+
+mesh_light::mesh_light(const std::vector<std::shared_ptr<triangle>>& triangles, std::string _name)
+    : light(point3(), 1.0, color(0, 0, 0), true, _name)
+{
+    for (const auto& tri : triangles)
+    {
+        // most triangles of a mesh don't emit, skip them before evaluating the emission
+        if (!tri || !tri->mat_ptr || !tri->mat_ptr->is_emissive())
+            continue;
+
+        color emission = average_emission(*tri);
+        double luminance = 0.2126 * emission.r() + 0.7152 * emission.g() + 0.0722 * emission.b();
+        if (tri->getArea() * luminance <= 0.0)
+            continue;
+
+        m_triangles.push_back(tri);
+        m_emissions.push_back(emission);
+    }
+
+    build();
+}
+
+void mesh_light::transform(const matrix4& object_to_world)
+{
+    // the mesh triangles are shared with the mesh (still in object space), the light keeps its own transformed copies
+    for (auto& tri : m_triangles)
+    {
+        point3 v[3];
+        for (int i = 0; i < 3; i++)
+        {
+            vector4 p = object_to_world * vector4(tri->verts[i].x, tri->verts[i].y, tri->verts[i].z, rreal(1));
+            v[i] = point3(p.x, p.y, p.z);
+        }
+
+        // only the face geometry is used for light sampling, the vertex normals are the face normal
+        vector3 n = glm::cross(v[1] - v[0], v[2] - v[0]);
+
+        tri = std::make_shared<triangle>(0, 0, v[0], v[1], v[2], n, n, n, tri->vert_uvs[0], tri->vert_uvs[1], tri->vert_uvs[2], false, tri->mat_ptr);
+    }
+
+    build();
+}
+
+void mesh_light::build()
+{
+    std::vector<double> weights;
+    std::vector<light_bounds> bounds;
+
+    color emission_sum(0, 0, 0);
+    m_area = 0.0;
+    m_power = 0.0;
+
+    for (size_t i = 0; i < m_triangles.size(); i++)
+    {
+        const auto& tri = m_triangles[i];
+        const color& emission = m_emissions[i];
+
+        double luminance = 0.2126 * emission.r() + 0.7152 * emission.g() + 0.0722 * emission.b();
+        double power = tri->getArea() * luminance;
+
+        // emissive materials of meshes are double sided
+        light_bounds lb;
+        lb.bounds = tri->bounding_box();
+        lb.axis = tri->getNormal();
+        lb.theta_o = M_PI;
+        lb.power = power;
+
+        weights.push_back(power);
+        bounds.push_back(lb);
+
+        m_bbox = i == 0 ? lb.bounds : aabb(m_bbox, lb.bounds);
+        m_area += tri->getArea();
+        m_power += power;
+        emission_sum += emission * rreal(tri->getArea());
+    }
+
+    m_table.build(weights);
+    m_bvh.build(bounds);
+
+    if (m_area > 0.0)
+    {
+        m_color = emission_sum / rreal(m_area);
+        m_position = (m_bbox.min() + m_bbox.max()) * rreal(0.5);
+    }
+}
+
+aabb mesh_light::bounding_box() const
+{
+    return m_bbox;
+}
+
+bool mesh_light::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
+{
+    // the triangles are hit through the mesh
+    return false;
+}
+
+double mesh_light::pdf_value(const point3& o, const vector3& v, randomizer& rnd) const
+{
+    double sum = 0.0;
+
+    m_bvh.for_each_crossed_light(ray(o, v), [&](int triangle_id, double)
+    {
+        sum += m_table.pmf(triangle_id) * m_triangles[triangle_id]->pdf_value(o, v, rnd);
+    });
+
+    return sum;
+}
+
+vector3 mesh_light::random(const point3& o, randomizer& rnd) const
+{
+    if (m_triangles.empty())
+        return vector3(1, 0, 0);
+
+    int triangle_id = m_table.sample(rnd.get_real(0.0, 1.0));
+
+    return m_triangles[triangle_id]->random(o, rnd);
+}
+
+double mesh_light::getArea() const
+{
+    return m_area;
+}
+
+double mesh_light::getPower() const
+{
+    return m_power;
+}
+
+light_bounds mesh_light::getLightBounds() const
+{
+    light_bounds lb;
+    lb.bounds = m_bbox;
+    lb.power = m_power;
+    return lb;
+}
+
+bool mesh_light::sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const
+{
+    if (m_triangles.empty())
+        return false;
+
+    int triangle_id = m_table.sample(rnd.get_real(0.0, 1.0));
+    double pmf = m_table.pmf(triangle_id);
+    const triangle& tri = *m_triangles[triangle_id];
+    if (pmf <= 0.0 || tri.getArea() <= 0.0)
+        return false;
+
+    // uniform point on the triangle
+    double su = sqrt(rnd.get_real(0.0, 1.0));
+    double b1 = 1.0 - su;
+    double b2 = rnd.get_real(0.0, 1.0) * su;
+    double b0 = 1.0 - b1 - b2;
+
+    point3 p = tri.verts[0] * rreal(b0) + tri.verts[1] * rreal(b1) + tri.verts[2] * rreal(b2);
+    vector2 uv = tri.vert_uvs[0] * rreal(b0) + tri.vert_uvs[1] * rreal(b1) + tri.vert_uvs[2] * rreal(b2);
+
+    // emissive materials of meshes are double sided
+    normal = tri.getNormal();
+    if (rnd.get_real(0.0, 1.0) < 0.5)
+        normal = -normal;
+
+    hit_record rec;
+    rec.hit_point = p;
+    rec.normal = normal;
+    rec.front_face = true;
+    rec.u = uv.x;
+    rec.v = uv.y;
+    rec.mat = tri.mat_ptr;
+
+    radiance = tri.mat_ptr->emitted(ray(p + normal, -normal), rec, uv.x, uv.y, p);
+
+    onb uvw;
+    uvw.build_from_w(normal);
+    photon = ray(p, uvw.local(rnd.get_cosine_direction()));
+
+    pdf_pos = pmf / tri.getArea();
+    pdf_dir = 0.5 * glm::dot(normal, unit_vector(photon.direction())) / M_PI;
+
+    return true;
+}
+
+double mesh_light::emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const
+{
+    // same density as sample_emission : pmf of the triangle holding p over its area
+    pdf_pos = 0.0;
+    int triangle_id = find_triangle(p, normal);
+    if (triangle_id >= 0)
+        pdf_pos = m_table.pmf(triangle_id) / m_triangles[triangle_id]->getArea();
+
+    double cosine = std::abs(glm::dot(normal, unit_vector(direction)));
+    return 0.5 * cosine / M_PI;
+}
+
+int mesh_light::find_triangle(const point3& p, const vector3& normal) const
+{
+    int found = -1;
+
+    // any ray through p crosses the bounds of its triangle, start it a bit before p to stay past the bvh epsilon
+    vector3 offset = normal * rreal(4.0 * SHADOW_ACNE_FIX);
+    m_bvh.for_each_crossed_light(ray(p + offset, -normal), [&](int triangle_id, double)
+    {
+        if (found >= 0)
+            return;
+
+        const triangle& tri = *m_triangles[triangle_id];
+        vector3 e1 = tri.verts[1] - tri.verts[0];
+        vector3 e2 = tri.verts[2] - tri.verts[0];
+        vector3 w = p - tri.verts[0];
+        vector3 n = glm::cross(e1, e2);
+
+        double n_length_squared = vector_length_squared(n);
+        if (n_length_squared <= 0.0)
+            return;
+
+        // off the plane of the triangle (tolerance relative to its size)
+        double plane_distance = glm::dot(w, n) / std::sqrt(n_length_squared);
+        if (std::abs(plane_distance) > 1e-3 * std::sqrt(std::sqrt(n_length_squared)))
+            return;
+
+        double b1 = glm::dot(glm::cross(w, e2), n) / n_length_squared;
+        double b2 = glm::dot(glm::cross(e1, w), n) / n_length_squared;
+        const double tolerance = 1e-4;
+        if (b1 >= -tolerance && b2 >= -tolerance && b1 + b2 <= 1.0 + tolerance)
+            found = triangle_id;
+    });
+
+    return found;
+}
+
+std::vector<std::shared_ptr<material>> mesh_light::getMaterials() const
+{
+    // every distinct emissive material of the mesh, hits on any of them belong to this light
+    std::vector<std::shared_ptr<material>> materials;
+
+    for (const auto& tri : m_triangles)
+    {
+        if (std::find(materials.begin(), materials.end(), tri->mat_ptr) == materials.end())
+            materials.push_back(tri->mat_ptr);
+    }
+
+    return materials;
+}
+
+size_t mesh_light::size() const
+{
+    return m_triangles.size();
+}
+
+color mesh_light::average_emission(const triangle& tri)
+{
+    // centroid and two rings of barycentric points
+    static const double barycentrics[7][3] =
+    {
+        { 1.0 / 3.0, 1.0 / 3.0, 1.0 / 3.0 },
+        { 2.0 / 3.0, 1.0 / 6.0, 1.0 / 6.0 },
+        { 1.0 / 6.0, 2.0 / 3.0, 1.0 / 6.0 },
+        { 1.0 / 6.0, 1.0 / 6.0, 2.0 / 3.0 },
+        { 1.0 / 6.0, 5.0 / 12.0, 5.0 / 12.0 },
+        { 5.0 / 12.0, 1.0 / 6.0, 5.0 / 12.0 },
+        { 5.0 / 12.0, 5.0 / 12.0, 1.0 / 6.0 }
+    };
+
+    color sum(0, 0, 0);
+
+    for (const auto& b : barycentrics)
+    {
+        point3 p = tri.verts[0] * rreal(b[0]) + tri.verts[1] * rreal(b[1]) + tri.verts[2] * rreal(b[2]);
+        vector2 uv = tri.vert_uvs[0] * rreal(b[0]) + tri.vert_uvs[1] * rreal(b[1]) + tri.vert_uvs[2] * rreal(b[2]);
+
+        hit_record rec;
+        rec.hit_point = p;
+        rec.normal = tri.getNormal();
+        rec.front_face = true;
+        rec.u = uv.x;
+        rec.v = uv.y;
+        rec.mat = tri.mat_ptr;
+
+        color emission = tri.mat_ptr->emitted(ray(p + rec.normal, -rec.normal), rec, uv.x, uv.y, p);
+        sum += emission;
+    }
+
+    return sum / rreal(7);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "light.h"
+#include "light_bvh.h"
+#include "../primitives/triangle.h"
+#include "../randomizers/randomizer.h"
+#include "../utilities/alias_table.h"
+#include "../utilities/types.h"
+
+#include <vector>
+
+/// <summary>
+/// Emissive triangle mesh seen as an area light
+/// Triangles are picked with an alias table weighted by area x emission (averaged over the emissive texture), then sampled in solid angle
+/// The mesh triangles are still rendered by the mesh itself, this light only drives next event estimation (it is never hit)
+/// </summary>
+class mesh_light : public light
+{
+public:
+    /// <summary>
+    /// Keep the triangles with a non zero emission
+    /// </summary>
+    mesh_light(const std::vector<std::shared_ptr<triangle>>& triangles, std::string _name = "MeshLight");
+
+    aabb bounding_box() const override;
+
+    bool hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const override;
+
+    double pdf_value(const point3& o, const vector3& v, randomizer& rnd) const override;
+
+    /// <summary>
+    /// Random special implementation for mesh lights (override base)
+    /// </summary>
+    /// <param name="origin"></param>
+    /// <returns></returns>
+    vector3 random(const point3& o, randomizer& rnd) const override;
+
+    double getArea() const override;
+    double getPower() const override;
+    light_bounds getLightBounds() const override;
+    bool sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const override;
+    double emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const override;
+    std::vector<std::shared_ptr<material>> getMaterials() const override;
+
+    /// <summary>
+    /// Number of emissive triangles
+    /// </summary>
+    size_t size() const;
+
+    /// <summary>
+    /// Move the light with its mesh instance (same object to world transform as the translate / rotate / scale wrappers of the mesh)
+    /// </summary>
+    void transform(const matrix4& object_to_world);
+
+private:
+    std::vector<std::shared_ptr<triangle>> m_triangles;
+    std::vector<color> m_emissions;
+    alias_table m_table;
+
+    // only used to skip the triangles a direction can't cross when evaluating the pdf
+    light_bvh m_bvh;
+
+    double m_area = 0.0;
+    double m_power = 0.0;
+
+    /// <summary>
+    /// Alias table, light bvh and totals of the current triangles
+    /// </summary>
+    void build();
+
+    /// <summary>
+    /// Emission averaged over a few points of the triangle (textured emission)
+    /// </summary>
+    static color average_emission(const triangle& tri);
+
+    /// <summary>
+    /// Index of the triangle holding p (-1 if none)
+    /// </summary>
+    int find_triangle(const point3& p, const vector3& normal) const;
+};
@@ -82,11 +82,18 @@ bool omni_light::hit(const ray& r, interval ray_t, hit_record& rec, int depth, r
 double omni_light::pdf_value(const point3& o, const vector3& v, randomizer& rnd) const
 {
     // This method only works for stationary spheres.
-    hit_record rec;
-    if (!this->hit(ray(o, v), interval(SHADOW_ACNE_FIX, infinity), rec, 0, rnd))
+
+    // analytic pdf : v must be inside the cone subtended by the sphere (no intersection needed)
+    vector3 direction = m_position - o;
+    auto distance_squared = vector_length_squared(direction);
+    if (distance_squared <= radius * radius)
+        return 0;
+
+    auto cos_theta_max = sqrt(1 - radius * radius / distance_squared);
+    auto cos_theta = glm::dot(direction, v) / sqrt(distance_squared * vector_length_squared(v));
+    if (cos_theta < cos_theta_max)
         return 0;
 
-    auto cos_theta_max = sqrt(1 - radius * radius / vector_length_squared(m_position - o));
     auto solid_angle = 2 * M_PI * (1 - cos_theta_max);
 
     return  1 / solid_angle;
@@ -99,4 +106,33 @@ vector3 omni_light::random(const point3& o, randomizer& rnd) const
     onb uvw;
     uvw.build_from_w(direction);
     return uvw.local(rnd.random_to_sphere(radius, distance_squared));
-}
\ No newline at end of file
+}
+
+double omni_light::getArea() const
+{
+    return 4.0 * M_PI * radius * radius;
+}
+
+bool omni_light::sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const
+{
+    if (radius <= 0.0)
+        return false;
+
+    // uniform point on the sphere, cosine weighted direction around its normal
+    normal = rnd.get_unit_vector();
+    onb uvw;
+    uvw.build_from_w(normal);
+    photon = ray(m_position + normal * rreal(radius), uvw.local(rnd.get_cosine_direction()));
+    radiance = m_color * rreal(m_intensity);
+    pdf_dir = emission_pdf(photon.origin(), normal, photon.direction(), pdf_pos);
+
+    return true;
+}
+
+double omni_light::emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const
+{
+    pdf_pos = radius > 0.0 ? 1.0 / getArea() : 0.0;
+
+    double cosine = std::abs(glm::dot(normal, unit_vector(direction)));
+    return cosine / M_PI;
+}
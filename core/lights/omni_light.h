@@ -36,8 +36,12 @@ public:
     /// <returns></returns>
     vector3 random(const point3& o, randomizer& rnd) const override;
 
+    double getArea() const override;
+    bool sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const override;
+    double emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const override;
+
 
 private:
-    double radius = 0.0;
+    rreal radius = 0.0;
     vector3 center_vec{};
 };
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "../misc/singleton.h"
 #include "../misc/onb.h"
 
+#include <algorithm>
+
 
 spot_light::spot_light(point3 position, vector3 direction, double cutoff, double falloff, double intensity, double radius, color rgb, string name, bool invisible)
     : light(position, intensity, rgb, invisible, name)
@@ -89,11 +91,18 @@ bool spot_light::hit(const ray& r, interval ray_t, hit_record& rec, int depth, r
 double spot_light::pdf_value(const point3& o, const vector3& v, randomizer& rnd) const
 {
 	// This method only works for stationary spheres.
-	hit_record rec;
-	if (!this->hit(ray(o, v), interval(SHADOW_ACNE_FIX, infinity), rec, 0, rnd))
+
+	// analytic pdf : v must be inside the cone subtended by the sphere (no intersection needed)
+	vector3 direction = m_position - o;
+	auto distance_squared = vector_length_squared(direction);
+	if (distance_squared <= m_radius * m_radius)
+		return 0;
+
+	auto cos_theta_max = sqrt(1 - m_radius * m_radius / distance_squared);
+	auto cos_theta = glm::dot(direction, v) / sqrt(distance_squared * vector_length_squared(v));
+	if (cos_theta < cos_theta_max)
 		return 0;
 
-	auto cos_theta_max = sqrt(1 - m_radius * m_radius / vector_length_squared(m_position - o));
 	auto solid_angle = 2 * M_PI * (1 - cos_theta_max);
 
 	return  1 / solid_angle;
@@ -106,4 +115,64 @@ vector3 spot_light::random(const point3& o, randomizer& rnd) const
 	onb uvw;
 	uvw.build_from_w(direction);
 	return uvw.local(rnd.random_to_sphere(m_radius, distance_squared));
-}
\ No newline at end of file
+}
+
+double spot_light::getArea() const
+{
+	return 4.0 * M_PI * m_radius * m_radius;
+}
+
+double spot_light::getPower() const
+{
+	// only the cone fraction of the sphere emits (m_cutoff is the cosine of the cutoff angle)
+	return light::getPower() * 0.5 * (1.0 - m_cutoff);
+}
+
+light_bounds spot_light::getLightBounds() const
+{
+	light_bounds lb;
+	lb.bounds = m_bbox;
+	lb.axis = unit_vector(m_direction);
+	lb.theta_o = 0.0;
+	lb.theta_e = acos(m_cutoff);
+	lb.power = getPower();
+	return lb;
+}
+
+bool spot_light::sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const
+{
+	if (m_radius <= 0.0 || m_cutoff >= 1.0)
+		return false;
+
+	normal = unit_vector(m_direction);
+
+	onb uvw;
+	uvw.build_from_w(normal);
+
+	// uniform direction inside the cone
+	double cos_theta = 1.0 - rnd.get_real(0.0, 1.0) * (1.0 - m_cutoff);
+	double sin_theta = sqrt(std::max(0.0, 1.0 - cos_theta * cos_theta));
+	double phi = 2.0 * M_PI * rnd.get_real(0.0, 1.0);
+	vector3 direction = uvw.local(cos(phi) * sin_theta, sin(phi) * sin_theta, cos_theta);
+
+	// leaves the sphere through its disk facing the cone
+	vector3 d = rnd.get_in_unit_disk() * rreal(m_radius);
+	point3 origin = m_position + uvw.local(d.x, d.y, 0.0);
+
+	photon = ray(origin, direction);
+	radiance = m_color * rreal(m_intensity * pow(cos_theta, m_falloff));
+	pdf_dir = emission_pdf(origin, normal, direction, pdf_pos);
+
+	return true;
+}
+
+double spot_light::emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const
+{
+	pdf_pos = m_radius > 0.0 ? 1.0 / (M_PI * m_radius * m_radius) : 0.0;
+
+	double cos_theta = glm::dot(unit_vector(m_direction), unit_vector(direction));
+	if (cos_theta < m_cutoff || m_cutoff >= 1.0)
+		return 0.0;
+
+	return 1.0 / (2.0 * M_PI * (1.0 - m_cutoff));
+}
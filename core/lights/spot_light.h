@@ -39,11 +39,17 @@ public:
 	/// <returns></returns>
 	vector3 random(const point3& o, randomizer& rnd) const override;
 
+	double getArea() const override;
+	double getPower() const override;
+	light_bounds getLightBounds() const override;
+	bool sample_emission(randomizer& rnd, ray& photon, vector3& normal, color& radiance, double& pdf_pos, double& pdf_dir) const override;
+	double emission_pdf(const point3& p, const vector3& normal, const vector3& direction, double& pdf_pos) const override;
+
 
 private:
 	vector3 m_direction{};
 	double m_cutoff = 0.0;
 	double m_falloff = 0.0;
-	double m_radius = 0.0;
+	rreal m_radius = 0.0;
 	double m_blur = 0.0;
 };
\ No newline at end of file
@@ -6,6 +6,10 @@
 #include "misc/scene.h"
 #include "renderers/renderer_selector.h"
 #include "randomizers/randomizer.h"
+#include "textures/texture_cache.h"
+#include "textures/texture_registry.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -45,11 +49,18 @@ int main(int argc, char* argv[])
 
     Singleton::singleton_ = new Singleton(params);
 
+    // must be set before the scene textures are created
+    texture_cache::instance().configure(static_cast<size_t>(params.texture_cache_size) * 1024 * 1024);
+    texture_registry::instance().set_default_layout(static_cast<texel_layout>(std::clamp(params.texture_layout, 0, 2)));
+    texture_registry::instance().set_default_compression(params.compress_textures);
+
     randomizer rnd(DefaultRNGSeed);
 
 
-    // Create world
+    // Create world (the image textures are decoded in the background meanwhile)
     scene_manager builder;
+    timer parseTimer;
+    parseTimer.start();
  
     scene world = builder.load_scene(params, rnd);
     if (world.get_world().objects.size() == 0)
@@ -57,6 +68,25 @@ int main(int argc, char* argv[])
         std::cerr << "[ERROR] Can't load scene !" << std::endl;
         exit(EXIT_FAILURE);
     }
+
+    parseTimer.stop();
+
+    // textures decoding not finished yet
+    timer decodeTimer;
+    decodeTimer.start();
+    texture_registry::instance().wait_pending();
+    decodeTimer.stop();
+
+    renderer_selector render;
+
+    timer bvhTimer;
+    bvhTimer.start();
+    render.prepare(world, params, rnd);
+    bvhTimer.stop();
+
+    std::cout << "[INFO] Startup : parse " << parseTimer.elapsedMilliseconds() - builder.mesh_load_time() << " ms, mesh "
+        << builder.mesh_load_time() << " ms, textures " << decodeTimer.elapsedMilliseconds() << " ms waited ("
+        << texture_registry::instance().decode_milliseconds() << " ms decoding on all threads), BVH " << bvhTimer.elapsedMilliseconds() << " ms" << std::endl;
     
     std::cout << "[INFO] Ready !" << std::endl;
     
@@ -65,7 +95,6 @@ int main(int argc, char* argv[])
     // Start measuring time
     renderTimer.start();
 
-    renderer_selector render;
     render.render(world, params, rnd);
 
     // Stop measuring time
@@ -13,10 +13,10 @@ anisotropic_material::anisotropic_material(double Nu, double Nv, const std::shar
 bool anisotropic_material::scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const
 {
 	srec.skip_pdf = true;
-	srec.attenuation = srec.diffuseColor = m_diffuse->value(rec.u, rec.v, rec.hit_point);
+	srec.attenuation = srec.diffuseColor = m_diffuse->value(rec.u, rec.v, rec.hit_point, rec.footprint);
 
 	if (m_specular)
-		srec.specularColor = m_specular->value(rec.u, rec.v, rec.hit_point);
+		srec.specularColor = m_specular->value(rec.u, rec.v, rec.hit_point, rec.footprint);
 
 	if (m_exponent)
 	{
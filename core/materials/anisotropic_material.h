@@ -24,7 +24,7 @@ public:
     
 
 private:
-    const double epsilon = 1E-5;
+    const rreal epsilon = 1E-5;
 
     std::shared_ptr<texture> m_diffuse;
     std::shared_ptr<texture> m_specular;
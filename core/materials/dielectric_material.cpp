@@ -21,7 +21,7 @@ bool dielectric_material::scatter(const ray& r_in, const hittable_list& lights,
 {
     // Use texture or default color (white) for attenuation
     if (attenuation_texture) {
-        srec.attenuation = attenuation_texture->value(rec.u, rec.v, rec.hit_point);
+        srec.attenuation = attenuation_texture->value(rec.u, rec.v, rec.hit_point, rec.footprint);
     }
     else {
         srec.attenuation = color(1.0, 1.0, 1.0);
@@ -42,7 +42,7 @@ bool dielectric_material::scatter(const ray& r_in, const hittable_list& lights,
     if (cannot_refract || reflectance(cos_theta, refraction_ratio) > rnd.get_real(0, 1))
         direction = glm::reflect(unit_direction, rec.normal);
     else
-        direction = glm::refract(unit_direction, rec.normal, refraction_ratio);
+        direction = glm::refract(unit_direction, rec.normal, rreal(refraction_ratio));
 
     srec.skip_pdf_ray = ray(rec.hit_point, direction, r_in.time());
     return true;
@@ -46,4 +46,9 @@ color diffuse_light::emitted(const ray& r_in, const hit_record& rec, double u, d
 
     // light
     return m_emit->value(u, v, p) * m_intensity;
+}
+
+bool diffuse_light::is_emissive() const
+{
+    return true;
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ public:
     diffuse_light(color _c, double _intensity, bool _directional, bool _invisible);
 
     color emitted(const ray& r_in, const hit_record& rec, double u, double v, const point3& p) const override;
+    bool is_emissive() const override;
 
 
 private:
@@ -28,3 +28,8 @@ color diffuse_spot_light::emitted(const ray& r_in, const hit_record& rec, double
     double attenuation = glm::pow(cos_theta, m_falloff);
     return m_emit->value(u, v, p) * (m_intensity * attenuation);
 }
+
+bool diffuse_spot_light::is_emissive() const
+{
+    return true;
+}
@@ -17,6 +17,7 @@ public:
     diffuse_spot_light(std::shared_ptr<texture> emitTex, point3 pos, vector3 dir, double cutoff, double falloff, double intensity, bool invisible);
 
     color emitted(const ray& r_in, const hit_record& rec, double u, double v, const point3& p) const override;
+    bool is_emissive() const override;
 
 private:
     std::shared_ptr<texture> m_emit = nullptr;
@@ -29,7 +29,7 @@ emissive_material::emissive_material(color _c, double _intensity)
 
 bool emissive_material::scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const
 {
-	srec.attenuation = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point);
+	srec.attenuation = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point, rec.footprint);
 	srec.pdf_ptr = std::make_shared<cosine_pdf>(rec.normal);
 	srec.skip_pdf = false;
 
@@ -46,4 +46,9 @@ color emissive_material::emitted(const ray& r_in, const hit_record& rec, double
 {
     // Material emission
     return m_emissive_texture->value(u, v, p) * m_intensity;
+}
+
+bool emissive_material::is_emissive() const
+{
+    return true;
 }
\ No newline at end of file
@@ -26,6 +26,7 @@ public:
     double scattering_pdf(const ray& r_in, const hit_record& rec, const ray& scattered) const override;
 
     color emitted(const ray& r_in, const hit_record& rec, double u, double v, const point3& p) const override;
+    bool is_emissive() const override;
 
 
 private:
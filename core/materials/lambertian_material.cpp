@@ -32,9 +32,9 @@ bool lambertian_material::scatter(const ray& r_in, const hittable_list& lights,
 	if (m_transparency > 0)
 	{
 		// Compute the refracted ray direction
-		vector3 refracted_direction = glm::refract(r_in.direction(), rec.normal, m_refractiveIndex);
+		vector3 refracted_direction = glm::refract(r_in.direction(), rec.normal, rreal(m_refractiveIndex));
 		//srec.attenuation = color(1.0, 1.0, 1.0); // Fully transparent
-		srec.attenuation = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point) * color(m_transparency);
+		srec.attenuation = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point, rec.footprint) * color(m_transparency);
 		srec.skip_pdf = true;
 		srec.skip_pdf_ray = ray(rec.hit_point, refracted_direction, r_in.time());
 		return true;
@@ -44,7 +44,7 @@ bool lambertian_material::scatter(const ray& r_in, const hittable_list& lights,
 	}
 
 	
-	srec.attenuation = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point);
+	srec.attenuation = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point, rec.footprint);
     srec.pdf_ptr = std::make_shared<cosine_pdf>(rec.normal);
     srec.skip_pdf = false;
 
@@ -55,4 +55,10 @@ double lambertian_material::scattering_pdf(const ray& r_in, const hit_record& re
 {
     auto cos_theta = glm::dot(rec.normal, unit_vector(scattered.direction()));
     return cos_theta < 0 ? 0 : cos_theta / M_PI;
+}
+
+bool lambertian_material::is_diffuse() const
+{
+    // transparent lambertian refracts
+    return m_transparency <= 0;
 }
\ No newline at end of file
@@ -41,4 +41,6 @@ public:
     /// <returns></returns>
     bool scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const override;
     double scattering_pdf(const ray& r_in, const hit_record& rec, const ray& scattered) const override;
+
+    bool is_diffuse() const override;
 };
\ No newline at end of file
@@ -128,4 +128,14 @@ color material::get_diffuse_pixel_color(const hit_record& rec) const
 	}
 
 	return color{};
+}
+
+bool material::is_diffuse() const
+{
+	return false;
+}
+
+bool material::is_emissive() const
+{
+	return false;
 }
\ No newline at end of file
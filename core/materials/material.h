@@ -35,6 +35,16 @@ public:
     virtual double scattering_pdf(const ray& r_in, const hit_record& rec, const ray& scattered) const;
     virtual color emitted(const ray& r_in, const hit_record& rec, double u, double v, const point3& p) const;
 
+    /// <summary>
+    /// Smooth view independent diffuse reflection (its scattered radiance can be read from the radiance cache)
+    /// </summary>
+    virtual bool is_diffuse() const;
+
+    /// <summary>
+    /// Can emit light (cheap test before evaluating emitted())
+    /// </summary>
+    virtual bool is_emissive() const;
+
     bool has_alpha_texture(bool& double_sided) const;
     bool has_displace_texture() const;
 
@@ -23,7 +23,7 @@ metal_material::metal_material(std::shared_ptr<texture> _texture, double fuzzine
 bool metal_material::scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const
 {
     // Base color and heat adjustments
-    color base_color = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point);
+    color base_color = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point, rec.footprint);
     color heat_adjusted_color = m_heat > 0 ? apply_heat(base_color) : base_color;
 
 
@@ -51,11 +51,11 @@ bool metal_material::scatter(const ray& r_in, const hittable_list& lights, const
     {
         // Add anisotropic fuzz
         vector3 stretched_fuzz = anisotropic_fuzz(rec.normal, rnd);
-        fuzzed_reflection = glm::normalize(reflected + stretched_fuzz * (m_heat > 0 ? adjust_fuzz_for_heat() : 1.0));
+        fuzzed_reflection = glm::normalize(reflected + stretched_fuzz * rreal(m_heat > 0 ? adjust_fuzz_for_heat() : 1.0));
     }
     else
     {
-        fuzzed_reflection = reflected + m_fuzz * rnd.get_in_unit_sphere();
+        fuzzed_reflection = reflected + rreal(m_fuzz) * rnd.get_in_unit_sphere();
         fuzzed_reflection = glm::normalize(fuzzed_reflection);
     }
 
@@ -78,9 +78,9 @@ vector3 metal_material::anisotropic_fuzz(const vector3& normal, randomizer& rnd)
     vector3 bitangent = glm::cross(normal, tangent);
 
     // Generate random fuzz in tangent space
-    vector3 stretched_fuzz = m_fuzz * (
-        tangent * rnd.get_real(-1.0, 1.0) +
-        bitangent * rnd.get_real(-1.0, 1.0) * m_anisotropy);
+    vector3 stretched_fuzz = rreal(m_fuzz) * (
+        tangent * rreal(rnd.get_real(-1.0, 1.0)) +
+        bitangent * rreal(rnd.get_real(-1.0, 1.0) * m_anisotropy));
 
     return stretched_fuzz;
 }
@@ -95,7 +95,7 @@ color metal_material::apply_heat(const color& base_color) const
 {
     // Heat effect changes color towards a "heated" look (e.g., yellowish-red)
     color heat_color = color(1.0, 0.5, 0.2); // Example "heated" color
-    vector3 tmp = glm::mix(vector3(base_color.r(), base_color.g(), base_color.b()), vector3(heat_color.r(), heat_color.g(), heat_color.b()), m_heat);
+    vector3 tmp = glm::mix(vector3(base_color.r(), base_color.g(), base_color.b()), vector3(heat_color.r(), heat_color.g(), heat_color.b()), rreal(m_heat));
 
     return color(tmp.x, tmp.y, tmp.z);
 }
@@ -96,7 +96,7 @@ oren_nayar_material::oren_nayar_material(std::shared_ptr<texture> _albedo, float
 bool oren_nayar_material::scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const
 {
     vector3 scatterDirection = rec.normal + rnd.random_on_hemisphere(rec.normal);
-    color mycolor = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point);
+    color mycolor = m_diffuse_texture->value(rec.u, rec.v, rec.hit_point, rec.footprint);
 
     // just take the first light for the moment
 	std::shared_ptr<light> mylight = std::dynamic_pointer_cast<light>(lights.objects[0]);
@@ -142,6 +142,12 @@ double oren_nayar_material::scattering_pdf(const ray& r_in, const hit_record& re
 	return cos_theta < 0 ? 0 : cos_theta / M_PI;
 }
 
+bool oren_nayar_material::is_diffuse() const
+{
+	// mostly view independent at the roughness it is used for
+	return true;
+}
+
 
 
 
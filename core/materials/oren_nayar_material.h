@@ -23,6 +23,8 @@ public:
 	bool scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const override;
 	double scattering_pdf(const ray& r_in, const hit_record& rec, const ray& scattered) const override;
 
+	bool is_diffuse() const override;
+
 
 
 private:
@@ -2,6 +2,7 @@
 
 #include "../primitives/hittable.h"
 #include "../lights/light.h"
+#include "../lights/mesh_light.h"
 #include "../textures/solid_color_texture.h"
 #include "../textures/bump_texture.h"
 #include "../textures/normal_texture.h"
@@ -25,6 +26,9 @@ phong_material::phong_material(std::shared_ptr<texture> diffuseTexture, std::sha
 {
     m_ambientColor = ambientColor;
     m_shininess = shininess;
+
+    // emissive_texture is a glow already added to the attenuation in scatter, other emissive maps are real emission
+    m_emits = m_emissive_texture && !std::dynamic_pointer_cast<emissive_texture>(m_emissive_texture);
 }
 
 
@@ -116,9 +120,9 @@ phong_material::phong_material(std::shared_ptr<texture> diffuseTexture, std::sha
 //        }
 //    }
 //
-//    vector3 v = glm::normalize(-1.0 * (hit_point - r_in.origin()));
+//    vector3 v = glm::normalize(rreal(-1.0) * (hit_point - r_in.origin()));
 //    double nl = maxDot3(normalv, dirToLight);
-//    vector3 r = glm::normalize((2.0 * nl * normalv) - dirToLight);
+//    vector3 r = glm::normalize((rreal(2.0 * nl) * normalv) - dirToLight);
 //
 //    // Combine the surface color with the light's color/intensity
 //    // Diffuse and specular reflection contributions
@@ -151,12 +155,12 @@ bool phong_material::scatter(const ray& r_in, const hittable_list& lights, const
     // Get the texture color at the hit point (assuming diffuse texture)
     if (m_diffuse_texture)
     {
-        diffuse_color = m_diffuse_texture->value(rec.u, rec.v, hit_point);
+        diffuse_color = m_diffuse_texture->value(rec.u, rec.v, hit_point, rec.footprint);
     }
 
     if (m_specular_texture)
     {
-        specular_color = m_specular_texture->value(rec.u, rec.v, hit_point);
+        specular_color = m_specular_texture->value(rec.u, rec.v, hit_point, rec.footprint);
     }
 
     if (m_emissive_texture)
@@ -173,7 +177,7 @@ bool phong_material::scatter(const ray& r_in, const hittable_list& lights, const
         std::shared_ptr<bump_texture> bumpTex = std::dynamic_pointer_cast<bump_texture>(m_bump_texture);
         if (bumpTex)
         {
-            normalv = bumpTex->perturb_normal(normalv, rec.u, rec.v, hit_point);
+            normalv = bumpTex->perturb_normal(normalv, rec.u, rec.v, hit_point, rec.footprint);
         }
     }
     else if (m_normal_texture)
@@ -193,6 +197,9 @@ bool phong_material::scatter(const ray& r_in, const hittable_list& lights, const
         std::shared_ptr<light> mylight = std::dynamic_pointer_cast<light>(obj);
         if (!mylight) continue; // Skip non-light objects
 
+        // the shading model treats lights as points, an emissive mesh is not one (it only lights through sampling)
+        if (std::dynamic_pointer_cast<mesh_light>(obj)) continue;
+
         // Compute light direction and intensity
         vector3 dirToLight = glm::normalize(mylight->getPosition() - hit_point);
         color lightColor = mylight->getColor() * mylight->getIntensity();
@@ -202,8 +209,8 @@ bool phong_material::scatter(const ray& r_in, const hittable_list& lights, const
         color diffuse_contribution = diffuse_color * nl;
 
         // Phong specular term
-        vector3 v = glm::normalize(-1.0 * (hit_point - r_in.origin()));
-        vector3 r = glm::normalize((2.0 * nl * normalv) - dirToLight);
+        vector3 v = glm::normalize(rreal(-1.0) * (hit_point - r_in.origin()));
+        vector3 r = glm::normalize((rreal(2.0 * nl) * normalv) - dirToLight);
         color specular_contribution = specular_color * pow(maxDot3(v, r), m_shininess);
 
         // Add this light's contribution
@@ -228,4 +235,17 @@ double phong_material::scattering_pdf(const ray& r_in, const hit_record& rec, co
 {
     auto cos_theta = dot(rec.normal, unit_vector(scattered.direction()));
     return cos_theta < 0 ? 0 : cos_theta / M_PI;
-}
\ No newline at end of file
+}
+
+color phong_material::emitted(const ray& r_in, const hit_record& rec, double u, double v, const point3& p) const
+{
+    if (!m_emits)
+        return color(0, 0, 0);
+
+    return m_emissive_texture->value(u, v, p);
+}
+
+bool phong_material::is_emissive() const
+{
+    return m_emits;
+}
@@ -35,8 +35,15 @@ public:
     bool scatter(const ray& r_in, const hittable_list& lights, const hit_record& rec, scatter_record& srec, randomizer& rnd) const override;
     double scattering_pdf(const ray& r_in, const hit_record& rec, const ray& scattered) const override;
 
+    /// <summary>
+    /// Emission of the emissive map (Ke / map_Ke of .mtl files)
+    /// </summary>
+    color emitted(const ray& r_in, const hit_record& rec, double u, double v, const point3& p) const override;
+    bool is_emissive() const override;
+
 
 private:
     color m_ambientColor{};
     double m_shininess = 0.0;
+    bool m_emits = false;
 };
\ No newline at end of file
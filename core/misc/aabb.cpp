@@ -42,7 +42,7 @@ const interval& aabb::axis(int n) const
 aabb aabb::pad() const
 {
     // Return an AABB that has no side narrower than some delta, padding if necessary.
-    double delta = 0.0001;
+    rreal delta = 0.0001;
     interval new_x = (x.size() >= delta) ? x : x.expand(delta);
     interval new_y = (y.size() >= delta) ? y : y.expand(delta);
     interval new_z = (z.size() >= delta) ? z : z.expand(delta);
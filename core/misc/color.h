@@ -1,48 +1,96 @@
 #pragma once
 
+#include "../constants.h"
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
-class color
+/// <summary>
+/// RGB radiance with an alpha channel
+/// Everything used by the integrator is inline and works on 4 aligned lanes (rgb + alpha),
+/// so the compiler can keep a color in a single SSE (float) or AVX (double) register
+/// Binary operators only combine rgb, the alpha lane of the result is reset to 1
+/// </summary>
+class alignas(4 * sizeof(rreal)) color
 {
 public:
-    double c[4];
-
-    color();
-    color(double c0);
-    color(double c0, double c1, double c2);
-    color(double c0, double c1, double c2, double c3);
-
-    double r() const;
-    double g() const;
-    double b() const;
-    double a() const;
-
-    void r(double r);
-    void g(double g);
-    void b(double b);
-    void a(double a);
-
-    color operator-() const;
-    double operator[](int i) const;
-    double& operator[](int i);
-
-    color& operator+=(const color& v);
-    color& operator+=(double t);
-    color& operator*=(double t);
-    color& operator*=(const color& v);
-    color& operator/=(double t);
-
-
-    double length() const;
-    double length_squared() const;
-
-    static const color white();
-    static const color black();
-    static const color red();
-    static const color green();
-    static const color blue();
-    static const color yellow();
-    static const color undefined();
+    rreal c[4];
+
+    color() : c{ 0, 0, 0, 1 } {}
+    color(rreal c0) : c{ c0, c0, c0, 1 } {}
+    color(rreal c0, rreal c1, rreal c2) : c{ c0, c1, c2, 1 } {}
+    color(rreal c0, rreal c1, rreal c2, rreal c3) : c{ c0, c1, c2, c3 } {}
+
+    rreal r() const { return c[0]; }
+    rreal g() const { return c[1]; }
+    rreal b() const { return c[2]; }
+    rreal a() const { return c[3]; }
+
+    void r(rreal r) { c[0] = r; }
+    void g(rreal g) { c[1] = g; }
+    void b(rreal b) { c[2] = b; }
+    void a(rreal a) { c[3] = a; }
+
+    color operator-() const { return color(-c[0], -c[1], -c[2], c[3]); }
+    rreal operator[](int i) const { return c[i]; }
+    rreal& operator[](int i) { return c[i]; }
+
+    color& operator+=(const color& v)
+    {
+        if (v.c[3] == 0) return *this;
+
+        const rreal alpha = std::min(c[3] + v.c[3], rreal(1));
+        for (int i = 0; i < 4; i++)
+            c[i] += v.c[i];
+        c[3] = alpha;
+
+        return *this;
+    }
+
+    color& operator+=(rreal t)
+    {
+        const rreal alpha = c[3];
+        for (int i = 0; i < 4; i++)
+            c[i] += t;
+        c[3] = alpha;
+
+        return *this;
+    }
+
+    color& operator*=(rreal t)
+    {
+        const rreal alpha = c[3];
+        for (int i = 0; i < 4; i++)
+            c[i] *= t;
+        c[3] = alpha;
+
+        return *this;
+    }
+
+    color& operator*=(const color& v)
+    {
+        const rreal alpha = c[3];
+        for (int i = 0; i < 4; i++)
+            c[i] *= v.c[i];
+        c[3] = alpha;
+
+        return *this;
+    }
+
+    color& operator/=(rreal t) { return *this *= rreal(1) / t; }
+
+
+    rreal length() const { return std::sqrt(length_squared()); }
+    rreal length_squared() const { return c[0] * c[0] + c[1] * c[1] + c[2] * c[2]; }
+
+    static const color white() { return color(1, 1, 1); }
+    static const color black() { return color(0, 0, 0); }
+    static const color red() { return color(1, 0, 0); }
+    static const color green() { return color(0, 1, 0); }
+    static const color blue() { return color(0, 0, 1); }
+    static const color yellow() { return color(1, 1, 0); }
+    static const color undefined() { return color(-1, -1, -1); }
 
     /// <summary>
     /// Write pixel color to the output stream with pixel sampling (antialiasing) and gamma correction
@@ -55,13 +103,13 @@ public:
     static color RGBtoHSV(color rgb);
     static color HSVtoRGB(color hsv);
 
-    static double linear_to_gamma(double linear_component);
+    static rreal linear_to_gamma(rreal linear_component) { return std::sqrt(linear_component); }
 
-    static color blend_colors(const color& front, const color& back, double alpha);
+    static color blend_colors(const color& front, const color& back, rreal alpha);
 
     static color blend_with_background(const color& background, const color& object_color, float alpha);
 
-    bool isValidColor();
+    bool isValidColor() const { return c[0] >= 0 && c[1] >= 0 && c[2] >= 0 && c[3] >= 0; }
 };
 
 
@@ -72,34 +120,52 @@ inline std::ostream& operator<<(std::ostream& out, const color& v)
     return out << v.c[0] << ' ' << v.c[1] << ' ' << v.c[2];
 }
 
+// binary operators run on the 4 lanes then reset alpha (cheaper than a 3 lanes loop once vectorized)
+
 inline color operator+(const color& u, const color& v)
 {
-    return color(u.c[0] + v.c[0], u.c[1] + v.c[1], u.c[2] + v.c[2]);
+    color result;
+    for (int i = 0; i < 4; i++)
+        result.c[i] = u.c[i] + v.c[i];
+    result.c[3] = 1;
+    return result;
 }
 
 inline color operator-(const color& u, const color& v)
 {
-    return color(u.c[0] - v.c[0], u.c[1] - v.c[1], u.c[2] - v.c[2]);
+    color result;
+    for (int i = 0; i < 4; i++)
+        result.c[i] = u.c[i] - v.c[i];
+    result.c[3] = 1;
+    return result;
 }
 
 inline color operator*(const color& u, const color& v)
 {
-    return color(u.c[0] * v.c[0], u.c[1] * v.c[1], u.c[2] * v.c[2]);
+    color result;
+    for (int i = 0; i < 4; i++)
+        result.c[i] = u.c[i] * v.c[i];
+    result.c[3] = 1;
+    return result;
 }
 
-inline color operator*(double t, const color& v)
+inline color operator*(rreal t, const color& v)
 {
-    return color(t * v.c[0], t * v.c[1], t * v.c[2]);
+    color result;
+    for (int i = 0; i < 4; i++)
+        result.c[i] = t * v.c[i];
+    result.c[3] = 1;
+    return result;
 }
 
-inline color operator*(const color& v, double t)
+inline color operator*(const color& v, rreal t)
 {
     return t * v;
 }
 
-inline color operator/(color v, double t)
+inline color operator/(const color& v, rreal t)
 {
-    return (1 / t) * v;
+    return (rreal(1) / t) * v;
 }
 
 
@@ -110,4 +176,4 @@ template<class T>
 inline T ffmin(T a, T b) { return(a < b ? a : b); }
 
 template<class T>
-inline T ffmax(T a, T b) { return(a > b ? a : b); }
\ No newline at end of file
+inline T ffmax(T a, T b) { return(a > b ? a : b); }
@@ -6,6 +6,9 @@ void hit_record::set_face_normal(const ray& r, const vector3& outward_normal)
 	// Sets the hit record normal vector.
 	// NOTE: the parameter `outward_normal` is assumed to have unit length.
 
+	// primitives knowing their uv parametrization set it after this call
+	uv_density = 0.0;
+
 	if (glm::dot(r.direction(), outward_normal) > 0.0)
 	{
 		// ray is inside the hittable primitive
@@ -16,15 +16,18 @@ public:
 	/// The t value in the hit_record specifies the distance from the ray origin A to the intersection point along the direction B.
 	/// When a ray intersects an object, the t value is used to compute the exact position of the hit point :
 	/// </summary>
-	double t = 0.0; // scalar parameter that moves the point along the ray.
+	rreal t = 0.0; // scalar parameter that moves the point along the ray.
 
 
-	double u = 0.0; // u mapping coordinate
-	double v = 0.0; // v mapping coordinate
+	rreal u = 0.0; // u mapping coordinate
+	rreal v = 0.0; // v mapping coordinate
 	bool front_face = true; // front-face tracking (object was hit from outside (frontface) or inside (backface) ?)
 	std::string name; // name of the object that was hit
 	aabb bbox; // bounding box size of the object that was hit
 	
+	rreal uv_density = 0.0; // world length per uv unit around the hit (0 : unknown, no texture filtering)
+	rreal footprint = 0.0; // width of the ray cone at the hit in uv units (texture filtering)
+
 	vector3 tangent{}; // tangent vector calculated from the normal (obj models only)
 	vector3 bitangent{}; // bitangent vector calculated from the normal (obj models only)
 
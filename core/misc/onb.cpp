@@ -20,7 +20,7 @@ vector3 onb::w() const
     return axis[2];
 }
 
-vector3 onb::local(double a, double b, double c) const
+vector3 onb::local(rreal a, rreal b, rreal c) const
 {
     return a * u() + b * v() + c * w();
 }
@@ -38,7 +38,7 @@ public:
     vector3 v() const;
     vector3 w() const;
 
-    vector3 local(double a, double b, double c) const;
+    vector3 local(rreal a, rreal b, rreal c) const;
 
 
     vector3 local(const vector3& a) const;
@@ -51,7 +51,7 @@ public:
 		return w();
 	}
 
-	inline vector3 LocalToGlobal(double X, double Y, double Z) const
+	inline vector3 LocalToGlobal(rreal X, rreal Y, rreal Z) const
 	{
 		return X * axis[0] + Y * axis[1] + Z * axis[2];
 	}
@@ -0,0 +1,323 @@
+#include "path_guiding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+const guiding_quadtree* guiding_distribution::find(const point3& p) const
+{
+    if (m_nodes.empty())
+        return nullptr;
+
+    vector3 lo = m_bounds.min();
+    vector3 hi = m_bounds.max();
+    int index = 0;
+
+    while (m_nodes[index].child >= 0)
+    {
+        const spatial_node& n = m_nodes[index];
+        double mid = 0.5 * (lo[n.axis] + hi[n.axis]);
+
+        if (p[n.axis] < mid)
+        {
+            hi[n.axis] = static_cast<rreal>(mid);
+            index = n.child;
+        }
+        else
+        {
+            lo[n.axis] = static_cast<rreal>(mid);
+            index = n.child + 1;
+        }
+    }
+
+    int q = m_nodes[index].quadtree;
+    if (q < 0 || q >= static_cast<int>(m_quadtrees.size()) || m_quadtrees[q].empty())
+        return nullptr;
+
+    return &m_quadtrees[q];
+}
+
+size_t guiding_distribution::memory_size() const
+{
+    size_t size = m_nodes.size() * sizeof(spatial_node) + m_quadtrees.size() * sizeof(guiding_quadtree);
+    for (const auto& q : m_quadtrees)
+        size += q.node_count() * sizeof(float) * 8;
+
+    return size;
+}
+
+
+
+path_guiding::path_guiding(const aabb& scene_bounds, const config& cfg)
+    : m_config(cfg), m_rng(0x5d7ee)
+{
+    // single leaf covering the scene
+    m_tree.m_bounds = scene_bounds;
+    m_tree.m_nodes.push_back(guiding_distribution::spatial_node());
+    m_tree.m_nodes[0].quadtree = 0;
+    m_node_bounds.push_back(scene_bounds);
+    m_node_depths.push_back(0);
+    m_leaves.resize(1);
+}
+
+const path_guiding::config& path_guiding::get_config() const
+{
+    return m_config;
+}
+
+void path_guiding::record(const point3& position, const vector3& direction, const color& radiance, double sampling_pdf)
+{
+    if (m_frozen.load(std::memory_order_relaxed) || !(sampling_pdf > 0.0))
+        return;
+
+    double luminance = 0.2126 * radiance.r() + 0.7152 * radiance.g() + 0.0722 * radiance.b();
+    double weight = luminance / sampling_pdf;
+
+    // black samples don't shape the distribution, NaN and inf would poison it
+    if (!(weight > 0.0) || !std::isfinite(weight))
+        return;
+
+    // memory budget : drop records until the next refine consumes them
+    if (m_pending.load(std::memory_order_relaxed) >= max_pending())
+        return;
+
+    guiding_record r;
+    r.position = position;
+    r.weight = static_cast<float>(weight);
+    guiding_quadtree::to_square(unit_vector(direction), r.u, r.v);
+
+    shard& s = m_shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % SHARD_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.records.push_back(r);
+    }
+
+    size_t pending = m_pending.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // online refinement after the training passes (the first thread to cross the threshold does the work)
+    size_t next = m_next_refine.load(std::memory_order_relaxed);
+    if (next > 0 && pending >= next)
+    {
+        std::unique_lock<std::mutex> lock(m_refine_mutex, std::try_to_lock);
+        if (lock.owns_lock())
+            refine_locked();
+    }
+}
+
+void path_guiding::refine()
+{
+    std::lock_guard<std::mutex> lock(m_refine_mutex);
+    refine_locked();
+}
+
+void path_guiding::end_training()
+{
+    if (m_config.freeze)
+    {
+        freeze();
+        return;
+    }
+
+    // keep learning, refine each time the number of records doubles
+    std::lock_guard<std::mutex> lock(m_refine_mutex);
+    size_t recorded = 0;
+    for (const auto& leaf : m_leaves)
+        recorded += leaf.records.size();
+
+    m_next_refine.store(std::max<size_t>(2 * recorded, 1024), std::memory_order_relaxed);
+}
+
+void path_guiding::freeze()
+{
+    m_frozen.store(true);
+    m_next_refine.store(0);
+
+    // training data is useless now, only the published distribution is kept
+    std::lock_guard<std::mutex> lock(m_refine_mutex);
+    for (auto& s : m_shards)
+    {
+        std::lock_guard<std::mutex> shard_lock(s.mutex);
+        std::vector<guiding_record>().swap(s.records);
+    }
+    m_pending.store(0);
+
+    std::vector<leaf_records>().swap(m_leaves);
+}
+
+bool path_guiding::is_frozen() const
+{
+    return m_frozen.load();
+}
+
+std::shared_ptr<const guiding_distribution> path_guiding::get_distribution() const
+{
+    return m_distribution.load(std::memory_order_acquire);
+}
+
+int path_guiding::find_leaf(const point3& p) const
+{
+    int index = 0;
+
+    while (m_tree.m_nodes[index].child >= 0)
+    {
+        const auto& n = m_tree.m_nodes[index];
+        const aabb& b = m_node_bounds[index];
+        double mid = 0.5 * (b.min()[n.axis] + b.max()[n.axis]);
+
+        index = p[n.axis] < mid ? n.child : n.child + 1;
+    }
+
+    return index;
+}
+
+void path_guiding::insert(leaf_records& leaf, const guiding_record& r)
+{
+    // reservoir sampling, every record offered to the leaf has the same chance to be kept
+    leaf.seen++;
+
+    if (leaf.records.size() < static_cast<size_t>(m_config.max_records_per_leaf))
+    {
+        leaf.records.push_back(r);
+        return;
+    }
+
+    uint64_t j = std::uniform_int_distribution<uint64_t>(0, leaf.seen - 1)(m_rng);
+    if (j < leaf.records.size())
+        leaf.records[j] = r;
+}
+
+void path_guiding::split(int node_index)
+{
+    const aabb parent_bounds = m_node_bounds[node_index];
+    const int depth = m_node_depths[node_index];
+    const int axis = depth % 3; // cycle the axes like the SD-tree
+
+    double mid = 0.5 * (parent_bounds.min()[axis] + parent_bounds.max()[axis]);
+
+    vector3 lo = parent_bounds.min(), hi = parent_bounds.max();
+    vector3 lo_second = lo, hi_first = hi;
+    hi_first[axis] = static_cast<rreal>(mid);
+    lo_second[axis] = static_cast<rreal>(mid);
+
+    // first child reuses the leaf slot of its parent
+    int first_leaf = m_tree.m_nodes[node_index].quadtree;
+    int second_leaf = static_cast<int>(m_leaves.size());
+    m_leaves.push_back(leaf_records());
+
+    int child = static_cast<int>(m_tree.m_nodes.size());
+    m_tree.m_nodes.push_back(guiding_distribution::spatial_node());
+    m_tree.m_nodes.push_back(guiding_distribution::spatial_node());
+    m_tree.m_nodes[child].quadtree = first_leaf;
+    m_tree.m_nodes[child + 1].quadtree = second_leaf;
+
+    m_node_bounds.push_back(aabb(lo, hi_first));
+    m_node_bounds.push_back(aabb(lo_second, hi));
+    m_node_depths.push_back(depth + 1);
+    m_node_depths.push_back(depth + 1);
+
+    m_tree.m_nodes[node_index].axis = axis;
+    m_tree.m_nodes[node_index].child = child;
+    m_tree.m_nodes[node_index].quadtree = -1;
+
+    // share the parent records between the children
+    leaf_records parent;
+    std::swap(parent, m_leaves[first_leaf]);
+
+    for (const auto& r : parent.records)
+    {
+        leaf_records& target = r.position[axis] < mid ? m_leaves[first_leaf] : m_leaves[second_leaf];
+        target.records.push_back(r);
+    }
+
+    // seen counts follow the kept proportions
+    double kept = static_cast<double>(std::max<size_t>(parent.records.size(), 1));
+    m_leaves[first_leaf].seen = static_cast<uint64_t>(parent.seen * (m_leaves[first_leaf].records.size() / kept));
+    m_leaves[second_leaf].seen = static_cast<uint64_t>(parent.seen * (m_leaves[second_leaf].records.size() / kept));
+}
+
+size_t path_guiding::memory_size() const
+{
+    size_t size = m_tree.m_nodes.size() * (sizeof(guiding_distribution::spatial_node) + sizeof(aabb) + sizeof(int));
+    for (const auto& leaf : m_leaves)
+        size += leaf.records.capacity() * sizeof(guiding_record);
+
+    auto distribution = get_distribution();
+    if (distribution)
+        size += distribution->memory_size();
+
+    return size;
+}
+
+size_t path_guiding::max_pending() const
+{
+    // a quarter of the budget for the records waiting for the next refine
+    return std::max<size_t>(m_config.memory_budget / 4 / sizeof(guiding_record), 1024);
+}
+
+void path_guiding::refine_locked()
+{
+    if (m_frozen.load())
+        return;
+
+    // take the pending records
+    std::vector<guiding_record> pending;
+    for (auto& s : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        pending.insert(pending.end(), s.records.begin(), s.records.end());
+        s.records.clear();
+    }
+    m_pending.fetch_sub(std::min(pending.size(), m_pending.load()));
+
+    for (const auto& r : pending)
+    {
+        int node = find_leaf(r.position);
+        insert(m_leaves[m_tree.m_nodes[node].quadtree], r);
+    }
+
+    // split the full leaves while the budget allows it (children are visited by the same loop)
+    const size_t leaf_cost = m_config.max_records_per_leaf * sizeof(guiding_record);
+    size_t memory = memory_size();
+
+    for (size_t i = 0; i < m_tree.m_nodes.size(); i++)
+    {
+        const auto& n = m_tree.m_nodes[i];
+        if (n.child >= 0 || m_node_depths[i] >= m_config.max_spatial_depth)
+            continue;
+
+        const leaf_records& leaf = m_leaves[n.quadtree];
+        if (leaf.seen < static_cast<uint64_t>(m_config.max_records_per_leaf))
+            continue;
+
+        if (memory + leaf_cost > m_config.memory_budget)
+            break;
+
+        split(static_cast<int>(i));
+        memory += leaf_cost;
+    }
+
+    // rebuild every directional distribution from its reservoir
+    auto distribution = std::make_shared<guiding_distribution>();
+    distribution->m_bounds = m_tree.m_bounds;
+    distribution->m_nodes = m_tree.m_nodes;
+    distribution->m_quadtrees.resize(m_leaves.size());
+
+    const int leaf_count = static_cast<int>(m_leaves.size());
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int i = 0; i < leaf_count; i++)
+    {
+        // too few samples give a noisy distribution, let the BSDF alone sample there
+        if (m_leaves[i].records.size() >= 16)
+            distribution->m_quadtrees[i].build(m_leaves[i].records, m_config.directional_rho, m_config.max_directional_depth);
+    }
+
+    m_distribution.store(distribution, std::memory_order_release);
+
+    // next online refinement when the records doubled
+    size_t next = m_next_refine.load(std::memory_order_relaxed);
+    if (next > 0)
+        m_next_refine.store(2 * next, std::memory_order_relaxed);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "aabb.h"
+#include "color.h"
+#include "../utilities/types.h"
+#include "../utilities/guiding_quadtree.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+/// <summary>
+/// Learned guiding distribution : binary spatial tree over the scene bounds, each leaf owns a directional quadtree
+/// Immutable once built, renders share it through a shared_ptr while the trainer builds the next one
+/// </summary>
+class guiding_distribution
+{
+public:
+    /// <summary>
+    /// Directional distribution of the spatial leaf containing p (nullptr if nothing was learned there)
+    /// </summary>
+    const guiding_quadtree* find(const point3& p) const;
+
+    size_t memory_size() const;
+
+private:
+    friend class path_guiding;
+
+    struct spatial_node
+    {
+        int axis = 0;
+        int child = -1; // first child, second is child + 1 (-1 means leaf)
+        int quadtree = -1; // leaf only
+    };
+
+    aabb m_bounds;
+    std::vector<spatial_node> m_nodes;
+    std::vector<guiding_quadtree> m_quadtrees;
+};
+
+/// <summary>
+/// Path guiding trainer (SD-tree, Muller et al. 2017)
+/// Paths record the radiance they bring back, the records are kept in a bounded reservoir per spatial leaf
+/// Each refine() splits the crowded spatial leaves, rebuilds the directional quadtrees and publishes a new guiding_distribution
+/// Training happens during dedicated passes, then the distribution can be frozen (or keeps being refined while rendering)
+/// </summary>
+class path_guiding
+{
+public:
+    struct config
+    {
+        int training_passes = 4;
+        size_t memory_budget = 256ull * 1024 * 1024; // bytes (records + trees)
+        bool freeze = true; // stop learning after the training passes
+        int max_records_per_leaf = 4096; // a full leaf is split
+        int max_spatial_depth = 24;
+        int max_directional_depth = 16;
+        double directional_rho = 0.01; // quadrants above this fraction of the energy are split
+        double guiding_probability = 0.5; // share of the guided samples (the rest follows the BSDF)
+    };
+
+    path_guiding(const aabb& scene_bounds, const config& cfg);
+
+    const config& get_config() const;
+
+    /// <summary>
+    /// Record the radiance brought back along a sampled direction (thread safe, no op once frozen)
+    /// </summary>
+    void record(const point3& position, const vector3& direction, const color& radiance, double sampling_pdf);
+
+    /// <summary>
+    /// Consume the pending records, refine the trees and publish a new distribution (thread safe)
+    /// </summary>
+    void refine();
+
+    /// <summary>
+    /// End of the training passes : freeze if configured so, else keep refining while rendering (each time the records double)
+    /// </summary>
+    void end_training();
+
+    /// <summary>
+    /// Stop learning, the current distribution is kept until the end of the render
+    /// </summary>
+    void freeze();
+    bool is_frozen() const;
+
+    /// <summary>
+    /// Current distribution (nullptr before the first refine)
+    /// </summary>
+    std::shared_ptr<const guiding_distribution> get_distribution() const;
+
+private:
+    struct leaf_records
+    {
+        std::vector<guiding_record> records;
+        uint64_t seen = 0; // records offered to the reservoir
+    };
+
+    struct shard
+    {
+        std::mutex mutex;
+        std::vector<guiding_record> records;
+    };
+
+    static constexpr int SHARD_COUNT = 32;
+
+    config m_config;
+    std::atomic<bool> m_frozen{ false };
+
+    // pending records, sharded by thread to keep the locks uncontended
+    shard m_shards[SHARD_COUNT];
+    std::atomic<size_t> m_pending{ 0 };
+    std::atomic<size_t> m_next_refine{ 0 };
+
+    // training state (guarded by m_refine_mutex)
+    std::mutex m_refine_mutex;
+    guiding_distribution m_tree; // topology of the spatial tree
+    std::vector<leaf_records> m_leaves; // indexed like m_tree.m_quadtrees
+    std::vector<aabb> m_node_bounds; // indexed like m_tree.m_nodes
+    std::vector<int> m_node_depths;
+    std::mt19937 m_rng;
+
+    std::atomic<std::shared_ptr<const guiding_distribution>> m_distribution;
+
+    int find_leaf(const point3& p) const;
+    void insert(leaf_records& leaf, const guiding_record& r);
+    void split(int node_index);
+    size_t memory_size() const;
+    size_t max_pending() const;
+    void refine_locked();
+};
@@ -0,0 +1,250 @@
+#include "photon_map.h"
+
+#include "scene.h"
+#include "hit_record.h"
+#include "scatter_record.h"
+#include "../lights/light.h"
+#include "../randomizers/randomizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <omp.h>
+
+namespace
+{
+    // photons traced by each emission task
+    constexpr int PHOTON_CHUNK = 4096;
+
+    // ranges smaller than this are built by the current thread
+    constexpr int PARALLEL_BUILD_THRESHOLD = 16384;
+
+    // cone filter constant (Jensen), 1 gives the sharpest caustics
+    constexpr double CONE_FILTER_K = 1.1;
+}
+
+photon_map::photon_map(const config& cfg)
+    : m_config(cfg)
+{
+}
+
+const photon_map::config& photon_map::get_config() const
+{
+    return m_config;
+}
+
+bool photon_map::empty() const
+{
+    return m_photons.empty();
+}
+
+size_t photon_map::size() const
+{
+    return m_photons.size();
+}
+
+void photon_map::build(scene& _scene, unsigned int nb_threads)
+{
+    m_photons.clear();
+    m_axes.clear();
+
+    if (m_config.photon_count <= 0 || _scene.get_light_sampler().size() == 0)
+        return;
+
+    m_radius = m_config.gather_radius;
+    if (m_radius <= 0.0)
+    {
+        aabb bounds = _scene.get_world().bounding_box();
+        double diagonal = vector_length(bounds.max() - bounds.min());
+        m_radius = std::isfinite(diagonal) && diagonal > 0.0 ? diagonal / 500.0 : 0.05;
+    }
+
+    int chunks = (m_config.photon_count + PHOTON_CHUNK - 1) / PHOTON_CHUNK;
+    int threads = static_cast<int>(std::max(1u, nb_threads));
+
+    // emission : each chunk has its own random sequence, threads merge their photons at the end
+    #pragma omp parallel num_threads(threads)
+    {
+        std::vector<photon> stored;
+
+        #pragma omp for schedule(dynamic, 1)
+        for (int chunk = 0; chunk < chunks; chunk++)
+        {
+            int first = chunk * PHOTON_CHUNK;
+            int count = std::min(PHOTON_CHUNK, m_config.photon_count - first);
+            trace_photons(_scene, first, count, stored);
+        }
+
+        #pragma omp critical
+        {
+            m_photons.insert(m_photons.end(), stored.begin(), stored.end());
+        }
+    }
+
+    // flux is shared by all the emitted photons, not only the stored ones
+    rreal scale = rreal(1.0 / m_config.photon_count);
+    for (auto& p : m_photons)
+        p.power *= scale;
+
+    m_axes.assign(m_photons.size(), 0);
+
+    #pragma omp parallel num_threads(threads)
+    {
+        #pragma omp single
+        build_tree(0, static_cast<int>(m_photons.size()));
+    }
+
+    std::cout << "[INFO] Caustic photon map : " << m_photons.size() << " photons stored, gather radius " << m_radius << std::endl;
+}
+
+void photon_map::trace_photons(scene& _scene, int first, int count, std::vector<photon>& stored) const
+{
+    randomizer rnd("photons" + std::to_string(first));
+
+    const light_sampler& lights = _scene.get_light_sampler();
+    const hittable_list& world = _scene.get_world();
+
+    for (int i = 0; i < count; i++)
+    {
+        double pmf = 0.0;
+        int light_id = lights.sample(rnd, pmf);
+        if (light_id < 0 || pmf <= 0.0)
+            continue;
+
+        std::shared_ptr<light> emitter = std::dynamic_pointer_cast<light>(lights.get_light(light_id));
+        if (!emitter)
+            continue;
+
+        ray r;
+        vector3 normal;
+        color radiance;
+        double pdf_pos = 0.0, pdf_dir = 0.0;
+        if (!emitter->sample_emission(rnd, r, normal, radiance, pdf_pos, pdf_dir) || pdf_pos <= 0.0 || pdf_dir <= 0.0)
+            continue;
+
+        double cosine = std::abs(glm::dot(normal, unit_vector(r.direction())));
+        color flux = radiance * rreal(cosine / (pmf * pdf_pos * pdf_dir));
+        bool specular = false;
+
+        for (int bounce = 0; bounce < m_config.max_bounces; bounce++)
+        {
+            hit_record rec;
+            if (!world.hit(r, interval(robust_epsilon(r.origin()), infinity), rec, 0, rnd))
+                break;
+
+            scatter_record srec;
+            if (!rec.mat->scatter(r, _scene.get_emissive_objects(), rec, srec, rnd))
+                break;
+
+            if (!srec.skip_pdf)
+            {
+                // caustic : light -> specular chain -> diffuse surface, other paths are found by the path tracer
+                if (specular && rec.mat->is_diffuse())
+                    stored.push_back(photon{ rec.hit_point, unit_vector(r.direction()), flux });
+
+                break;
+            }
+
+            // russian roulette on the chain throughput
+            double survival = std::min(1.0, static_cast<double>(std::max({ srec.attenuation.r(), srec.attenuation.g(), srec.attenuation.b() })));
+            if (survival <= 0.0 || rnd.get_real(0.0, 1.0) >= survival)
+                break;
+
+            flux = flux * srec.attenuation / rreal(survival);
+            specular = true;
+            r = srec.skip_pdf_ray;
+        }
+    }
+}
+
+void photon_map::build_tree(int begin, int end)
+{
+    if (end - begin <= 1)
+        return;
+
+    // split the largest extent of the range at its median
+    aabb bounds;
+    for (int i = begin; i < end; i++)
+        bounds = aabb(bounds, aabb(m_photons[i].position, m_photons[i].position));
+
+    vector3 extent = bounds.max() - bounds.min();
+    int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    int mid = (begin + end) / 2;
+    std::nth_element(m_photons.begin() + begin, m_photons.begin() + mid, m_photons.begin() + end, [axis](const photon& a, const photon& b)
+    {
+        return a.position[axis] < b.position[axis];
+    });
+
+    m_axes[mid] = static_cast<uint8_t>(axis);
+
+    if (end - begin > PARALLEL_BUILD_THRESHOLD)
+    {
+        #pragma omp task
+        build_tree(begin, mid);
+
+        #pragma omp task
+        build_tree(mid + 1, end);
+
+        #pragma omp taskwait
+    }
+    else
+    {
+        build_tree(begin, mid);
+        build_tree(mid + 1, end);
+    }
+}
+
+color photon_map::estimate(const point3& p, const vector3& normal) const
+{
+    if (m_photons.empty())
+        return color(0, 0, 0);
+
+    const double r2 = m_radius * m_radius;
+    color sum(0, 0, 0);
+
+    struct range { int begin; int end; };
+    range stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = { 0, static_cast<int>(m_photons.size()) };
+
+    while (stack_size > 0)
+    {
+        range rg = stack[--stack_size];
+        if (rg.end <= rg.begin)
+            continue;
+
+        int mid = (rg.begin + rg.end) / 2;
+        const photon& ph = m_photons[mid];
+
+        double d2 = vector_length_squared(ph.position - p);
+        if (d2 < r2 && glm::dot(ph.direction, normal) < 0)
+        {
+            // cone filter weight
+            double w = 1.0 - std::sqrt(d2) / (CONE_FILTER_K * m_radius);
+            sum += ph.power * rreal(w);
+        }
+
+        if (rg.end - rg.begin == 1)
+            continue;
+
+        int axis = m_axes[mid];
+        double delta = p[axis] - ph.position[axis];
+
+        // the side containing p, then the other side only if the sphere crosses the plane
+        range near_side = delta < 0.0 ? range{ rg.begin, mid } : range{ mid + 1, rg.end };
+        range far_side = delta < 0.0 ? range{ mid + 1, rg.end } : range{ rg.begin, mid };
+
+        if (delta * delta < r2)
+            stack[stack_size++] = far_side;
+        stack[stack_size++] = near_side;
+    }
+
+    // irradiance over the disk (normalized cone filter), lambertian brdf without its albedo
+    double normalization = 1.0 - 2.0 / (3.0 * CONE_FILTER_K);
+    return sum * rreal(1.0 / (M_PI * r2 * normalization * M_PI));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "color.h"
+#include "../utilities/types.h"
+
+#include <cstdint>
+#include <vector>
+
+class scene;
+
+struct photon
+{
+    point3 position{};
+    vector3 direction{}; // incident direction (towards the surface)
+    color power{};
+};
+
+/// <summary>
+/// Caustic photon map
+/// Photons are shot from the scene lights and stored where a specular chain (dielectric, metal) ends on a diffuse surface
+/// The path tracer can't connect those light -> specular -> diffuse paths to the lights, the photon density estimate replaces them
+/// Photons are kept in a balanced kd-tree (median split, implicit layout), emission and tree build are multithreaded
+/// </summary>
+class photon_map
+{
+public:
+    struct config
+    {
+        int photon_count = 200000; // emitted photons
+        int max_bounces = 8; // length of the specular chains
+        double gather_radius = 0.0; // world units (0 : scene diagonal / 500)
+    };
+
+    photon_map(const config& cfg);
+
+    const config& get_config() const;
+
+    /// <summary>
+    /// Shoot the photons from the scene lights and build the kd-tree (the scene world and lights must be ready)
+    /// </summary>
+    void build(scene& _scene, unsigned int nb_threads);
+
+    bool empty() const;
+    size_t size() const;
+
+    /// <summary>
+    /// Caustic radiance reflected per unit albedo at a diffuse hit (lambertian density estimate with a cone filter)
+    /// </summary>
+    color estimate(const point3& p, const vector3& normal) const;
+
+private:
+    config m_config;
+    double m_radius = 0.0;
+
+    // kd-tree : the median of each range is its node, lower half on the left and upper half on the right
+    std::vector<photon> m_photons;
+    std::vector<uint8_t> m_axes;
+
+    void trace_photons(scene& _scene, int first, int count, std::vector<photon>& stored) const;
+    void build_tree(int begin, int end);
+};
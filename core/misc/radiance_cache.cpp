@@ -0,0 +1,214 @@
+#include "radiance_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    double luminance(double r, double g, double b)
+    {
+        return 0.2126 * r + 0.7152 * g + 0.0722 * b;
+    }
+
+    uint64_t mix(uint64_t h)
+    {
+        // splitmix64 finalizer
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        return h;
+    }
+}
+
+radiance_cache::radiance_cache(const aabb& scene_bounds, const config& cfg)
+    : m_config(cfg)
+{
+    if (m_config.cell_size <= 0.0)
+    {
+        double diagonal = vector_length(scene_bounds.max() - scene_bounds.min());
+        m_config.cell_size = std::isfinite(diagonal) && diagonal > 0.0 ? diagonal / 256.0 : 1.0;
+    }
+
+    m_inv_cell_size = 1.0 / m_config.cell_size;
+
+    // power of 2 capacity, at least one probe group
+    size_t capacity = MAX_PROBES;
+    while (capacity < m_config.capacity)
+        capacity <<= 1;
+
+    m_config.capacity = capacity;
+    m_mask = capacity - 1;
+    m_entries.resize(capacity);
+}
+
+const radiance_cache::config& radiance_cache::get_config() const
+{
+    return m_config;
+}
+
+int radiance_cache::normal_bin(const vector3& normal)
+{
+    // octahedral mapping of the normal, 8x8 bins (about 30 degrees wide)
+    double l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1 <= 0.0)
+        return 0;
+
+    double x = normal.x / l1;
+    double y = normal.y / l1;
+    if (normal.z < 0.0)
+    {
+        double fx = (1.0 - std::abs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+        double fy = (1.0 - std::abs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+        x = fx;
+        y = fy;
+    }
+
+    int bx = std::clamp(static_cast<int>((x * 0.5 + 0.5) * 8.0), 0, 7);
+    int by = std::clamp(static_cast<int>((y * 0.5 + 0.5) * 8.0), 0, 7);
+
+    return by * 8 + bx;
+}
+
+uint64_t radiance_cache::make_key(const point3& position, const vector3& normal) const
+{
+    int64_t cx = static_cast<int64_t>(std::floor(position.x * m_inv_cell_size));
+    int64_t cy = static_cast<int64_t>(std::floor(position.y * m_inv_cell_size));
+    int64_t cz = static_cast<int64_t>(std::floor(position.z * m_inv_cell_size));
+
+    uint64_t h = mix(static_cast<uint64_t>(cx) * 0x9e3779b97f4a7c15ull);
+    h = mix(h ^ (static_cast<uint64_t>(cy) * 0xc2b2ae3d27d4eb4full));
+    h = mix(h ^ (static_cast<uint64_t>(cz) * 0x165667b19e3779f9ull));
+    h = mix(h ^ static_cast<uint64_t>(normal_bin(normal)));
+
+    // 0 marks an empty slot
+    return h ? h : 1;
+}
+
+std::mutex& radiance_cache::lock_for(size_t slot) const
+{
+    return m_locks[(slot / MAX_PROBES) % LOCK_COUNT];
+}
+
+void radiance_cache::record(const point3& position, const vector3& normal, const color& attenuation, const color& scattered)
+{
+    if (m_frozen.load(std::memory_order_relaxed))
+        return;
+
+    // radiance per unit albedo, a black albedo channel carries no information
+    if (attenuation.r() <= 0.0 || attenuation.g() <= 0.0 || attenuation.b() <= 0.0)
+        return;
+
+    double value[3] = {
+        scattered.r() / attenuation.r(),
+        scattered.g() / attenuation.g(),
+        scattered.b() / attenuation.b()
+    };
+
+    // NaN and inf would poison the entry
+    if (!std::isfinite(value[0]) || !std::isfinite(value[1]) || !std::isfinite(value[2]))
+        return;
+
+    double l = luminance(value[0], value[1], value[2]);
+
+    uint64_t key = make_key(position, normal);
+    uint32_t generation = m_generation.load(std::memory_order_relaxed);
+
+    // probes stay inside an aligned group of slots guarded by the same lock
+    size_t group = key & m_mask & ~static_cast<size_t>(MAX_PROBES - 1);
+    std::lock_guard<std::mutex> lock(lock_for(group));
+
+    entry* target = nullptr;
+    for (int i = 0; i < MAX_PROBES; i++)
+    {
+        entry& e = m_entries[group + i];
+        if (e.key == key)
+        {
+            target = &e;
+            break;
+        }
+
+        // empty or stale slots can be reused
+        if (!target && (e.key == 0 || e.generation != generation))
+            target = &e;
+    }
+
+    // group full of live entries, drop the estimate
+    if (!target)
+        return;
+
+    if (target->key != key || target->generation != generation)
+    {
+        *target = entry();
+        target->key = key;
+        target->generation = generation;
+    }
+
+    if (target->count >= static_cast<uint32_t>(m_config.max_samples))
+        return;
+
+    target->count++;
+    target->sum[0] += value[0];
+    target->sum[1] += value[1];
+    target->sum[2] += value[2];
+    target->sum_luminance2 += l * l;
+}
+
+bool radiance_cache::lookup(const point3& position, const vector3& normal, randomizer& rnd, color& irradiance) const
+{
+    // entries still filling depend on the order the threads recorded them
+    if (!m_frozen.load(std::memory_order_relaxed))
+        return false;
+
+    // jitter inside the cell, neighbor cells blend stochastically instead of showing blocks
+    point3 jittered = position + (rnd.get_vector3() - vector3(0.5)) * static_cast<rreal>(m_config.cell_size);
+
+    uint64_t key = make_key(jittered, normal);
+    uint32_t generation = m_generation.load(std::memory_order_relaxed);
+
+    size_t group = key & m_mask & ~static_cast<size_t>(MAX_PROBES - 1);
+    std::lock_guard<std::mutex> lock(lock_for(group));
+
+    for (int i = 0; i < MAX_PROBES; i++)
+    {
+        const entry& e = m_entries[group + i];
+        if (e.key != key)
+            continue;
+
+        if (e.generation != generation || e.count < static_cast<uint32_t>(m_config.min_samples))
+            return false;
+
+        double n = static_cast<double>(e.count);
+        double mean[3] = { e.sum[0] / n, e.sum[1] / n, e.sum[2] / n };
+        double mean_luminance = luminance(mean[0], mean[1], mean[2]);
+
+        // error bound : standard error of the mean luminance relative to the mean
+        double variance = std::max(0.0, e.sum_luminance2 / n - mean_luminance * mean_luminance);
+        double standard_error = std::sqrt(variance / n);
+        if (standard_error > m_config.max_relative_error * mean_luminance)
+            return false;
+
+        irradiance = color(static_cast<rreal>(mean[0]), static_cast<rreal>(mean[1]), static_cast<rreal>(mean[2]));
+        return true;
+    }
+
+    return false;
+}
+
+void radiance_cache::invalidate()
+{
+    // entries of an older generation are ignored by lookup and recycled by record
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+    m_frozen.store(false, std::memory_order_relaxed);
+}
+
+void radiance_cache::freeze()
+{
+    m_frozen.store(true, std::memory_order_relaxed);
+}
+
+bool radiance_cache::is_frozen() const
+{
+    return m_frozen.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "aabb.h"
+#include "color.h"
+#include "../utilities/types.h"
+#include "../randomizers/randomizer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// Radiance cache for the smooth diffuse interreflections
+/// Spatial hash grid keyed by the cell of the hit point and the octahedral bin of its normal
+/// Each entry accumulates the diffuse bounce estimates (radiance scattered per unit albedo) of the first bounce hits
+/// Deeper diffuse hits read it instead of tracing further, once the entry estimate is within the error bound
+/// The cache is filled by pre passes (record only) then frozen for the final render (lookup only), so the final image doesn't depend on the thread order
+/// </summary>
+class radiance_cache
+{
+public:
+    struct config
+    {
+        double cell_size = 0.0; // world units (0 : scene diagonal / 256)
+        int query_depth = 2; // bounces (0 is the camera hit) from which diffuse hits read the cache
+        int min_samples = 16; // estimates needed before an entry can be trusted
+        int max_samples = 4096; // a converged entry stops accumulating
+        double max_relative_error = 0.1; // standard error of the mean / mean (luminance) bound to use an entry
+        size_t capacity = 1 << 18; // entries of the hash table (rounded to a power of 2)
+        int fill_passes = 4; // one sample per pixel pre passes that fill the cache before the final render
+    };
+
+    radiance_cache(const aabb& scene_bounds, const config& cfg);
+
+    const config& get_config() const;
+
+    /// <summary>
+    /// Add the radiance scattered at a diffuse hit (thread safe, ignored once frozen)
+    /// The estimate is divided by the attenuation so textured albedos can share an entry
+    /// </summary>
+    void record(const point3& position, const vector3& normal, const color& attenuation, const color& scattered);
+
+    /// <summary>
+    /// Cached radiance scattered per unit albedo at a diffuse hit (thread safe, only once frozen)
+    /// The lookup position is jittered inside its cell to hide the grid, false if the entry is missing, stale or above the error bound
+    /// </summary>
+    bool lookup(const point3& position, const vector3& normal, randomizer& rnd, color& irradiance) const;
+
+    /// <summary>
+    /// Invalidation : every entry recorded before this call is discarded (lights, materials, geometry or sampling changed)
+    /// The cache goes back to the filling phase
+    /// </summary>
+    void invalidate();
+
+    /// <summary>
+    /// End of the filling phase : entries stop changing and can be read
+    /// </summary>
+    void freeze();
+
+    bool is_frozen() const;
+
+private:
+    struct entry
+    {
+        uint64_t key = 0; // 0 : empty slot
+        uint32_t generation = 0;
+        uint32_t count = 0;
+        double sum[3] = { 0.0, 0.0, 0.0 };
+        double sum_luminance2 = 0.0;
+    };
+
+    static constexpr int LOCK_COUNT = 64;
+    static constexpr int MAX_PROBES = 8;
+
+    config m_config;
+    double m_inv_cell_size = 1.0;
+    size_t m_mask = 0;
+
+    std::vector<entry> m_entries;
+    mutable std::mutex m_locks[LOCK_COUNT];
+    std::atomic<uint32_t> m_generation{ 1 };
+    std::atomic<bool> m_frozen{ false };
+
+    uint64_t make_key(const point3& position, const vector3& normal) const;
+    static int normal_bin(const vector3& normal);
+
+    std::mutex& lock_for(size_t slot) const;
+};
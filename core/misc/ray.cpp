@@ -8,11 +8,11 @@ ray::ray(const point3& origin, const vector3& direction) : m_orig(origin), m_dir
 {
 }
 
-ray::ray(const point3& origin, const vector3& direction, double time) : m_orig(origin), m_dir(direction), m_tm(time)
+ray::ray(const point3& origin, const vector3& direction, rreal time) : m_orig(origin), m_dir(direction), m_tm(time)
 {
 }
 
-ray::ray(const point3& origin, const vector3& direction, int _x, int _y, double time) : m_orig(origin), m_dir(direction), x(_x), y(_y), m_tm(time)
+ray::ray(const point3& origin, const vector3& direction, int _x, int _y, rreal time) : m_orig(origin), m_dir(direction), x(_x), y(_y), m_tm(time)
 {
 }
 
@@ -26,17 +26,17 @@ vector3 ray::direction() const
     return m_dir;
 }
 
-double ray::time() const
+rreal ray::time() const
 {
     return m_tm;
 }
 
-point3 ray::at(double t) const
+point3 ray::at(rreal t) const
 {
     return m_orig + t * m_dir;
 }
 
 [[nodiscard]] vector3 ray::inverseDirection() const
 {
-    return 1.0 / m_dir;
+    return rreal(1) / m_dir;
 }
\ No newline at end of file
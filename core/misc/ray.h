@@ -7,17 +7,21 @@ class ray
 public:
     ray();
     ray(const point3& origin, const vector3& direction);
-    ray(const point3& origin, const vector3& direction, double time);
-    ray(const point3& origin, const vector3& direction, int _x, int _y, double time);
+    ray(const point3& origin, const vector3& direction, rreal time);
+    ray(const point3& origin, const vector3& direction, int _x, int _y, rreal time);
 
 
     point3 origin() const;
     vector3 direction() const;
-    double time() const;
+    rreal time() const;
 	int x = 0;
 	int y = 0;
 
-    point3 at(double t) const;
+	// ray cone (texture filtering) : width at the origin and spread angle, both in world units / radians
+	rreal cone_width = 0;
+	rreal cone_spread = 0;
+
+    point3 at(rreal t) const;
 
     [[nodiscard]] vector3 inverseDirection() const;
 
@@ -25,5 +29,5 @@ public:
 private:
     point3 m_orig; // origin of where the ray starts
     vector3 m_dir; // direction of ray
-    double m_tm = 0; // timestamp of the ray (when it was fired, usefull for motion blur calculation)
+    rreal m_tm = 0; // timestamp of the ray (when it was fired, usefull for motion blur calculation)
 };
\ No newline at end of file
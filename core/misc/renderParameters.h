@@ -22,6 +22,17 @@ public:
 	bool use_gpu = false;
 	int nb_cpu_cores = 1;
 	int aa_sampler_type = 0;
+	int integrator = 0; // 0 : path tracing, 1 : bidirectional path tracing
+	unsigned int guiding_passes = 0; // path guiding training passes (0 : no path guiding)
+	unsigned int guiding_memory = 256; // path guiding memory budget (MB)
+	bool guiding_freeze = true; // stop path guiding training after the training passes
+	unsigned int radiance_cache_depth = 0; // bounce from which diffuse hits read the radiance cache (0 : no radiance cache)
+	double radiance_cache_error = 0.1; // radiance cache relative error bound
+	unsigned int photon_count = 0; // caustic photons emitted before rendering (0 : no photon map)
+	double photon_radius = 0.0; // caustic photons gather radius (0 : automatic)
+	unsigned int texture_cache_size = 0; // tiled texture cache budget (MB) (0 : textures are decoded whole at load)
+	int texture_layout = 0; // texels memory order : 0 rows, 1 morton tiles, 2 4x4 blocks
+	bool compress_textures = false; // block compressed 8 bits textures (bc1 colors, bc5 normal maps)
 
 	static renderParameters getArgs(int argc, char* argv[])
 	{
@@ -111,6 +122,50 @@ public:
 					// TODO : 3: jittered, 4: n-rooks, 5: multi-jittered
 					params.aa_sampler_type = stoul(value, 0, 10);
 				}
+				else if (param == "integrator" && !value.empty())
+				{
+					params.integrator = stoul(value, 0, 10);
+				}
+				else if (param == "guiding" && !value.empty())
+				{
+					params.guiding_passes = stoul(value, 0, 10);
+				}
+				else if (param == "guidingmemory" && !value.empty())
+				{
+					params.guiding_memory = stoul(value, 0, 10);
+				}
+				else if (param == "guidingfreeze" && !value.empty())
+				{
+					params.guiding_freeze = stoul(value, 0, 10);
+				}
+				else if (param == "radiancecache" && !value.empty())
+				{
+					params.radiance_cache_depth = stoul(value, 0, 10);
+				}
+				else if (param == "radiancecacheerror" && !value.empty())
+				{
+					params.radiance_cache_error = stod(value);
+				}
+				else if (param == "photons" && !value.empty())
+				{
+					params.photon_count = stoul(value, 0, 10);
+				}
+				else if (param == "photonradius" && !value.empty())
+				{
+					params.photon_radius = stod(value);
+				}
+				else if (param == "texturecache" && !value.empty())
+				{
+					params.texture_cache_size = stoul(value, 0, 10);
+				}
+				else if (param == "texturelayout" && !value.empty())
+				{
+					params.texture_layout = stoul(value, 0, 10);
+				}
+				else if (param == "texturecompression" && !value.empty())
+				{
+					params.compress_textures = stoul(value, 0, 10);
+				}
 				else if (param == "save" && !value.empty())
 				{
 					params.saveFilePath = value;
@@ -36,6 +36,36 @@ void scene::build_optimized_world(randomizer& rnd)
 	m_world = hittable_list(std::make_shared<bvh_node>(m_world, rnd));
 }
 
+void scene::set_path_guiding(std::shared_ptr<path_guiding> _guiding)
+{
+	m_path_guiding = _guiding;
+}
+
+path_guiding* scene::get_path_guiding()
+{
+	return m_path_guiding.get();
+}
+
+void scene::set_radiance_cache(std::shared_ptr<radiance_cache> _cache)
+{
+	m_radiance_cache = _cache;
+}
+
+radiance_cache* scene::get_radiance_cache()
+{
+	return m_radiance_cache.get();
+}
+
+void scene::set_photon_map(std::shared_ptr<photon_map> _photons)
+{
+	m_photon_map = _photons;
+}
+
+photon_map* scene::get_photon_map()
+{
+	return m_photon_map.get();
+}
+
 const hittable_list& scene::get_world()
 {
 	return m_world;
@@ -53,6 +83,9 @@ void scene::extract_emissive_objects()
 			m_emissive_objects.add(derived);
 		}
 	}
+
+	// lights are picked proportionally to their power
+	m_light_sampler.build(m_emissive_objects);
 }
 
 const hittable_list& scene::get_emissive_objects()
@@ -60,6 +93,11 @@ const hittable_list& scene::get_emissive_objects()
 	return m_emissive_objects;
 }
 
+const light_sampler& scene::get_light_sampler()
+{
+	return m_light_sampler;
+}
+
 std::shared_ptr<camera> scene::get_camera()
 {
 	return m_camera;
@@ -2,6 +2,10 @@
 
 #include "../primitives/hittable.h"
 #include "../primitives/hittable_list.h"
+#include "../lights/light_sampler.h"
+#include "path_guiding.h"
+#include "radiance_cache.h"
+#include "photon_map.h"
 
 #include <memory>
 #include <vector>
@@ -19,6 +23,7 @@ public:
 
 	const hittable_list& get_world();
 	const hittable_list& get_emissive_objects();
+	const light_sampler& get_light_sampler();
 	std::shared_ptr<camera> get_camera();
 
 	//const std::vector<SpotLight> get_lights();
@@ -26,6 +31,24 @@ public:
 	void extract_emissive_objects();
 	void build_optimized_world(randomizer& rnd);
 
+	/// <summary>
+	/// Path guiding is optional (nullptr when disabled)
+	/// </summary>
+	void set_path_guiding(std::shared_ptr<path_guiding> _guiding);
+	path_guiding* get_path_guiding();
+
+	/// <summary>
+	/// Radiance cache is optional (nullptr when disabled)
+	/// </summary>
+	void set_radiance_cache(std::shared_ptr<radiance_cache> _cache);
+	radiance_cache* get_radiance_cache();
+
+	/// <summary>
+	/// Caustic photon map is optional (nullptr when disabled)
+	/// </summary>
+	void set_photon_map(std::shared_ptr<photon_map> _photons);
+	photon_map* get_photon_map();
+
 
 
     typedef struct {
@@ -61,4 +84,8 @@ private:
 	hittable_list m_world;
 	std::shared_ptr<camera> m_camera;
 	hittable_list m_emissive_objects;
+	light_sampler m_light_sampler;
+	std::shared_ptr<path_guiding> m_path_guiding;
+	std::shared_ptr<radiance_cache> m_radiance_cache;
+	std::shared_ptr<photon_map> m_photon_map;
 };
\ No newline at end of file
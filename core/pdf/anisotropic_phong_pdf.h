@@ -31,7 +31,7 @@ private:
 
 	inline vector3 GetSpecularReflected(const vector3& h, double kh) const
 	{
-		return m_incident + 2. * kh * h;
+		return m_incident + rreal(2. * kh) * h;
 	}
 
 	inline double GetSpecularPDH(const vector3& h, double kh, double cos2, double sin2) const
@@ -0,0 +1,11 @@
+#include "guiding_pdf.h"
+
+double guiding_pdf::value(const vector3& direction, randomizer& rnd) const
+{
+    return quadtree->pdf(unit_vector(direction));
+}
+
+vector3 guiding_pdf::generate(scatter_record& rec, randomizer& rnd)
+{
+    return quadtree->sample(rnd);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "pdf.h"
+#include "../utilities/types.h"
+#include "../utilities/guiding_quadtree.h"
+#include "../randomizers/randomizer.h"
+#include "../misc/path_guiding.h"
+#include "../misc/scatter_record.h"
+
+/// <summary>
+/// Directions distributed like the incident radiance learned by path guiding at the shading point
+/// </summary>
+class guiding_pdf : public pdf
+{
+public:
+    guiding_pdf(std::shared_ptr<const guiding_distribution> _distribution, const guiding_quadtree* _quadtree)
+        : distribution(_distribution), quadtree(_quadtree)
+    {}
+
+    double value(const vector3& direction, randomizer& rnd) const override;
+    vector3 generate(scatter_record& rec, randomizer& rnd) override;
+
+
+private:
+    std::shared_ptr<const guiding_distribution> distribution; // keeps the quadtree alive
+    const guiding_quadtree* quadtree = nullptr;
+};
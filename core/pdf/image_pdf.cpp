@@ -1,96 +1,238 @@
 #include "image_pdf.h"
 
-#include "../misc/singleton.h"
+#include "../utilities/uvmapping.h"
+#include "../utilities/half.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+static const uint32_t ENVMAP_CACHE_MAGIC = 0x50564E45; // "ENVP"
+static const uint32_t ENVMAP_CACHE_VERSION = 1;
 
 image_pdf::image_pdf(std::shared_ptr<image_texture>& img)
-	: m_image(img), m_width(img->getWidth()), m_height(img->getHeight()), m_channels(3), m_pData(img->get_data_float())
+	: m_image(img), m_width(img->getWidth()), m_height(img->getHeight())
+{
+	if (m_width <= 0 || m_height <= 0)
+		return;
+
+	uint64_t key = hash();
+	std::string path = cache_path(key);
+
+	if (load_cache(path))
+		return;
+
+	// luminance of each texel (HDR float data when available, 8 bits data otherwise)
+	std::vector<double> luminance(static_cast<size_t>(m_width) * m_height);
+
+	const uint16_t* hdr = m_image->get_hdr_data();
+	const unsigned char* ldr = m_image->get_data();
+	const int channels = m_image->getChannels();
+
+	for (size_t i = 0; i < luminance.size(); i++)
+	{
+		size_t k = i * channels;
+		if (hdr)
+			luminance[i] = 0.2126 * half_to_float(hdr[k + 0]) + 0.7152 * half_to_float(hdr[k + 1]) + 0.0722 * half_to_float(hdr[k + 2]);
+		else
+			luminance[i] = (0.2126 * ldr[k + 0] + 0.7152 * ldr[k + 1] + 0.0722 * ldr[k + 2]) / 255.0;
+	}
+
+	build(luminance);
+	save_cache(path);
+}
+
+void image_pdf::build(const std::vector<double>& luminance)
 {
-	unsigned int k = 0;
-	float angleFrac = M_PI / m_height;
-	float theta = static_cast<float>(angleFrac) * 0.5f;
-	float sinTheta = 0.f;
-	float* pSinTheta = (float*)malloc(sizeof(float) * m_height);
-	for (unsigned int i = 0; i < m_height; i++, theta += angleFrac)
+	m_conditionals.assign(m_height, alias_table());
+
+	std::vector<double> row_weights(m_height);
+	std::vector<double> weights(m_width);
+
+	for (int j = 0; j < m_height; j++)
 	{
-		pSinTheta[i] = sin(theta);
+		// solid angle of a texel row shrinks with sin(theta) towards the poles
+		double sin_theta = std::sin(M_PI * (j + 0.5) / m_height);
+
+		for (int i = 0; i < m_width; i++)
+			weights[i] = std::max(luminance[static_cast<size_t>(j) * m_width + i], 0.0) * sin_theta;
+
+		m_conditionals[j].build(weights);
+		row_weights[j] = m_conditionals[j].total_weight();
 	}
-	// convert the data into a marginal CDF along the columns
-	m_pBuffer = (float*)malloc(m_width * (m_height + 1) * sizeof(float));
 
-	if (m_pBuffer)
+	// a black image falls back on uniform sampling of the sphere
+	bool black = true;
+	for (double w : row_weights)
+		if (w > 0.0) { black = false; break; }
+
+	if (black)
 	{
-		m_pUDist = &m_pBuffer[m_width * m_height];
-		if (m_pUDist)
+		for (int j = 0; j < m_height; j++)
 		{
-			for (unsigned int i = 0, m = 0; i < m_width; i++, m += m_height)
-			{
-				float* pVDist = &m_pBuffer[m];
-				if (pVDist)
-				{
-					k = i * m_channels;
-					pVDist[0] = 0.2126f * m_pData[k + 0] + 0.7152f * m_pData[k + 1] + 0.0722f * m_pData[k + 2];
-					pVDist[0] *= pSinTheta[0];
-					for (unsigned int j = 1, k = (m_width + i) * m_channels; j < m_height; j++, k += m_width * m_channels)
-					{
-						float lum = 0.2126f * m_pData[k + 0] + 0.7152f * m_pData[k + 1] + 0.0722f * m_pData[k + 2];
-						lum *= pSinTheta[j];
-						pVDist[j] = pVDist[j - 1] + lum;
-					}
-
-					if (i == 0)
-					{
-						m_pUDist[i] = pVDist[m_height - 1];
-					}
-					else
-					{
-						m_pUDist[i] = m_pUDist[i - 1] + pVDist[m_height - 1];
-					}
-				}
-			}
+			row_weights[j] = std::sin(M_PI * (j + 0.5) / m_height);
+			m_conditionals[j].build(std::vector<double>(m_width, 1.0));
 		}
 	}
+
+	m_marginal.build(row_weights);
 }
 
 double image_pdf::value(const vector3& direction, randomizer& rnd) const
 {
-	double _u, _v; get_spherical_uv(unit_vector(direction), _u, _v);
-	_u = 1. - _u;
-	int u = _u * double(m_height - 1), v = _v * double(m_width - 1);
-	if (u < 0) u = 0;
-	if (u >= m_height) u = m_height - 1;
-
-	if (v < 0) v = 0;
-	if (v >= m_width) v = m_width - 1;
-
-	float angleFrac = M_PI / float(m_height);
-	float invPdfNorm = (2.f * float(M_PI * M_PI)) / float(m_width * m_height);
-	float* pVDist = &m_pBuffer[m_height * u];
-	// compute the actual PDF
-	float pdfU = (u == 0) ? (m_pUDist[0]) : (m_pUDist[u] - m_pUDist[u - 1]);
-	pdfU /= m_pUDist[m_width - 1];
-	float pdfV = (v == 0) ? (pVDist[0]) : (pVDist[v] - pVDist[v - 1]);
-	pdfV /= pVDist[m_height - 1];
-	float theta = angleFrac * 0.5 + angleFrac * u;
-	float Pdf = (pdfU * pdfV) * sin(theta) / invPdfNorm;
-
-	return Pdf;
+	if (m_marginal.empty())
+		return 0.0;
+
+	vector3 unit_dir = unit_vector(direction);
+
+	// sin(theta) of the exact direction (theta is measured from -Y)
+	double sin_theta = std::sqrt(std::max(0.0, 1.0 - static_cast<double>(unit_dir.y) * unit_dir.y));
+	if (sin_theta <= 0.0)
+		return 0.0;
+
+	rreal u, v;
+	get_spherical_uv(unit_dir, u, v);
+
+	// same texel addressing as image_texture::value
+	int i = std::clamp(static_cast<int>(u * m_width), 0, m_width - 1);
+	int j = std::clamp(static_cast<int>((1.0 - v) * m_height), 0, m_height - 1);
+
+	// texel probability -> density in uv space -> density in solid angle
+	double pmf = m_marginal.pmf(j) * m_conditionals[j].pmf(i);
+
+	return pmf * m_width * m_height / (2.0 * M_PI * M_PI * sin_theta);
 }
 
 vector3 image_pdf::generate(scatter_record& rec, randomizer& rnd)
 {
-	double r1 = rnd.get_real(0.0, 1.0);
-	double r2 = rnd.get_real(0.0, 1.0);
-
-	float maxUVal = m_pUDist[m_width - 1];
-	float* pUPos = std::lower_bound(m_pUDist, m_pUDist + m_width, r1 * maxUVal);
-	int u = pUPos - m_pUDist;
-	float* pVDist = &m_pBuffer[m_height * u];
-	float* pVPos = std::lower_bound(pVDist, pVDist + m_height, r2 * pVDist[m_height - 1]);
-	double v = pVPos - pVDist;
-
-	double _u = double(u) / m_height;
-	double _v = double(v) / m_width;
-	_u = 1.0 - _u;
-
-	return from_spherical_uv(_u, _v);
-}
\ No newline at end of file
+	if (m_marginal.empty())
+		return vector3(0, 1, 0);
+
+	double remapped_v, remapped_u;
+	int j = m_marginal.sample(rnd.get_real(0.0, 1.0), remapped_v);
+	int i = m_conditionals[j].sample(rnd.get_real(0.0, 1.0), remapped_u);
+
+	// uniform position inside the texel (remapped numbers are uniform in [0, 1))
+	double u = (i + remapped_u) / m_width;
+	double v = 1.0 - (j + remapped_v) / m_height;
+
+	return from_spherical_uv(u, v);
+}
+
+uint64_t image_pdf::hash() const
+{
+	// FNV-1a on the image size and pixels
+	uint64_t h = 14695981039346656037ull;
+	auto add = [&h](const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			h ^= bytes[i];
+			h *= 1099511628211ull;
+		}
+	};
+
+	const size_t count = static_cast<size_t>(m_width) * m_height * m_image->getChannels();
+
+	add(&m_width, sizeof(m_width));
+	add(&m_height, sizeof(m_height));
+
+	if (m_image->get_hdr_data())
+		add(m_image->get_hdr_data(), count * sizeof(uint16_t));
+	else
+		add(m_image->get_data(), count);
+
+	return h;
+}
+
+std::string image_pdf::cache_path(uint64_t key) const
+{
+	std::error_code ec;
+	std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+	if (ec)
+		return std::string();
+
+	char name[64];
+	snprintf(name, sizeof(name), "envmap_%016llx.cache", static_cast<unsigned long long>(key));
+
+	return (dir / "cortex" / name).generic_string();
+}
+
+bool image_pdf::load_cache(const std::string& path)
+{
+	if (path.empty())
+		return false;
+
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		return false;
+
+	uint32_t magic = 0, version = 0;
+	int width = 0, height = 0;
+	in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	in.read(reinterpret_cast<char*>(&version), sizeof(version));
+	in.read(reinterpret_cast<char*>(&width), sizeof(width));
+	in.read(reinterpret_cast<char*>(&height), sizeof(height));
+
+	if (!in || magic != ENVMAP_CACHE_MAGIC || version != ENVMAP_CACHE_VERSION || width != m_width || height != m_height)
+		return false;
+
+	m_conditionals.assign(m_height, alias_table());
+
+	bool ok = m_marginal.read(in) && m_marginal.size() == static_cast<size_t>(m_height);
+	for (int j = 0; ok && j < m_height; j++)
+		ok = m_conditionals[j].read(in) && m_conditionals[j].size() == static_cast<size_t>(m_width);
+
+	if (!ok)
+	{
+		std::cerr << "[WARNING] Invalid environment map cache " << path << std::endl;
+		m_marginal.clear();
+		m_conditionals.clear();
+		return false;
+	}
+
+	std::cout << "[INFO] Environment map sampling tables loaded from cache " << path << std::endl;
+
+	return true;
+}
+
+void image_pdf::save_cache(const std::string& path) const
+{
+	if (path.empty())
+		return;
+
+	std::error_code ec;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+	// write to a temporary file first so that concurrent renders never read a partial cache
+	std::string tmp_path = path + ".tmp";
+	{
+		std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			return;
+
+		out.write(reinterpret_cast<const char*>(&ENVMAP_CACHE_MAGIC), sizeof(ENVMAP_CACHE_MAGIC));
+		out.write(reinterpret_cast<const char*>(&ENVMAP_CACHE_VERSION), sizeof(ENVMAP_CACHE_VERSION));
+		out.write(reinterpret_cast<const char*>(&m_width), sizeof(m_width));
+		out.write(reinterpret_cast<const char*>(&m_height), sizeof(m_height));
+
+		bool ok = m_marginal.write(out);
+		for (int j = 0; ok && j < m_height; j++)
+			ok = m_conditionals[j].write(out);
+
+		if (!ok)
+		{
+			out.close();
+			std::filesystem::remove(tmp_path, ec);
+			return;
+		}
+	}
+
+	std::filesystem::rename(tmp_path, path, ec);
+	if (ec)
+		std::filesystem::remove(tmp_path, ec);
+}
@@ -2,13 +2,23 @@
 
 #include "pdf.h"
 #include "../utilities/types.h"
+#include "../utilities/alias_table.h"
 #include "../randomizers/randomizer.h"
 #include "../textures/image_texture.h"
 #include "../misc/onb.h"
 #include "../primitives/hittable.h"
 #include "../misc/scatter_record.h"
 
-// https://github.com/Drummersbrother/raytracing-in-one-weekend/blob/90b1d3d7ce7f6f9244bcb925c77baed4e9d51705/main.cpp#L26
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Environment map importance sampling (equirectangular skybox)
+/// Texels are weighted by luminance x sin(theta) and sampled with a marginal alias table on the rows and a conditional alias table per row
+/// Sampling and pdf evaluation are O(1), tables are built once and cached on disk (keyed by the image hash)
+/// HDR images are sampled on their real radiance (the half float texels of the texture, no copy)
+/// </summary>
 class image_pdf : public pdf
 {
 public:
@@ -19,8 +29,16 @@ public:
 
 public:
 	std::shared_ptr<image_texture> m_image = nullptr;
-	int m_width = 0, m_height = 0, m_channels = 0;
-	float* m_pUDist;
-	float* m_pBuffer;
-	float* m_pData;
-};
\ No newline at end of file
+	int m_width = 0, m_height = 0;
+
+private:
+	alias_table m_marginal; // rows
+	std::vector<alias_table> m_conditionals; // columns of each row
+
+	void build(const std::vector<double>& luminance);
+
+	uint64_t hash() const;
+	std::string cache_path(uint64_t key) const;
+	bool load_cache(const std::string& path);
+	void save_cache(const std::string& path) const;
+};
@@ -0,0 +1,11 @@
+#include "light_sampler_pdf.h"
+
+double light_sampler_pdf::value(const vector3& direction, randomizer& rnd) const
+{
+    return sampler.pdf_value(origin, direction, rnd);
+}
+
+vector3 light_sampler_pdf::generate(scatter_record& rec, randomizer& rnd)
+{
+    return sampler.random(origin, rnd);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "pdf.h"
+#include "../utilities/types.h"
+#include "../randomizers/randomizer.h"
+#include "../lights/light_sampler.h"
+#include "../misc/scatter_record.h"
+
+/// <summary>
+/// Importance sampling of the scene lights weighted by their emitted power
+/// </summary>
+class light_sampler_pdf : public pdf
+{
+public:
+    light_sampler_pdf(const light_sampler& _sampler, const point3& _origin)
+        : sampler(_sampler), origin(_origin)
+    {}
+
+    double value(const vector3& direction, randomizer& rnd) const override;
+    vector3 generate(scatter_record& rec, randomizer& rnd) override;
+
+
+private:
+    const light_sampler& sampler;
+    point3 origin;
+};
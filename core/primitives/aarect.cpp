@@ -23,11 +23,11 @@ xy_rect::xy_rect(float _x0, float _x1, float _y0, float _y1, float _k, std::shar
 
 bool xy_rect::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
 {
-    double t = (k - r.origin().z) / r.direction().z;
+    rreal t = (k - r.origin().z) / r.direction().z;
     if (t < ray_t.min || t > ray_t.max)
         return false;
-    double x = r.origin().x + t * r.direction().x;
-    double y = r.origin().y + t * r.direction().y;
+    rreal x = r.origin().x + t * r.direction().x;
+    rreal y = r.origin().y + t * r.direction().y;
     if (x < x0 || x > x1 || y < y0 || y > y1)
         return false;
 
@@ -81,11 +81,11 @@ xz_rect::xz_rect(float _x0, float _x1, float _z0, float _z1, float _k, std::shar
 
 bool xz_rect::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
 {
-    double t = (k - r.origin().y) / r.direction().y;
+    rreal t = (k - r.origin().y) / r.direction().y;
     if (t < ray_t.min || t > ray_t.max)
         return false;
-    double x = r.origin().x + t * r.direction().x;
-    double z = r.origin().z + t * r.direction().z;
+    rreal x = r.origin().x + t * r.direction().x;
+    rreal z = r.origin().z + t * r.direction().z;
     if (x < x0 || x > x1 || z < z0 || z > z1)
         return false;
 
@@ -139,11 +139,11 @@ yz_rect::yz_rect(float _y0, float _y1, float _z0, float _z1, float _k, std::shar
 
 bool yz_rect::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
 {
-    double t = (k - r.origin().x) / r.direction().x;
+    rreal t = (k - r.origin().x) / r.direction().x;
     if (t < ray_t.min || t > ray_t.max)
         return false;
-    double y = r.origin().y + t * r.direction().y;
-    double z = r.origin().z + t * r.direction().z;
+    rreal y = r.origin().y + t * r.direction().y;
+    rreal z = r.origin().z + t * r.direction().z;
     if (y < y0 || y > y1 || z < z0 || z > z1)
         return false;
 
@@ -7,12 +7,12 @@ cone::cone(std::string _name)
 {
 };
 
-cone::cone(vector3 _center, double _radius, double _height, std::shared_ptr<material> _material, std::string _name)
+cone::cone(vector3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, std::string _name)
     : cone(_center, _radius, _height, _material, uvmapping(), _name)
 {
 };
 
-cone::cone(vector3 _center, double _radius, double _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name)
+cone::cone(vector3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name)
     : center(_center), radius(_radius), height(_height), mat(_material)
 {
     m_mapping = _mapping;
@@ -27,17 +27,17 @@ cone::cone(vector3 _center, double _radius, double _height, std::shared_ptr<mate
 
 bool cone::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
 {
-    double A = r.origin().x - center.x;
-    double B = r.origin().z - center.z;
-    double D = height - r.origin().y + center.y;
+    rreal A = r.origin().x - center.x;
+    rreal B = r.origin().z - center.z;
+    rreal D = height - r.origin().y + center.y;
 
-    double tan = (radius / height) * (radius / height);
+    rreal tan = (radius / height) * (radius / height);
 
-    double a = (r.direction().x * r.direction().x) + (r.direction().z * r.direction().z) - (tan * (r.direction().y * r.direction().y));
-    double b = (2 * A * r.direction().x) + (2 * B * r.direction().z) + (2 * tan * D * r.direction().y);
-    double c = (A * A) + (B * B) - (tan * (D * D));
+    rreal a = (r.direction().x * r.direction().x) + (r.direction().z * r.direction().z) - (tan * (r.direction().y * r.direction().y));
+    rreal b = (2 * A * r.direction().x) + (2 * B * r.direction().z) + (2 * tan * D * r.direction().y);
+    rreal c = (A * A) + (B * B) - (tan * (D * D));
 
-    double delta = b * b - 4 * (a * c);
+    rreal delta = b * b - 4 * (a * c);
     if (fabs(delta) < 0.001) return false;
 
     if (delta < 0)
@@ -45,7 +45,7 @@ bool cone::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomi
         return false;
     }
 
-    double root = (-b - sqrt(delta)) / (2 * a);
+    rreal root = (-b - sqrt(delta)) / (2 * a);
 
     if (root < ray_t.min || ray_t.max < root)
     {
@@ -57,7 +57,7 @@ bool cone::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomi
     }
 
 
-    double y = r.origin().y + root * r.direction()[1];
+    rreal y = r.origin().y + root * r.direction()[1];
 
     if ((y < center.y) || (y > center.y + height))
     {
@@ -87,7 +87,7 @@ bool cone::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomi
 	}
 	else {
 		// Point lies on the curved surface of the cone
-		double rs = sqrt((rec.hit_point.x - center.x) * (rec.hit_point.x - center.x) + (rec.hit_point.z - center.z) * (rec.hit_point.z - center.z));
+		rreal rs = sqrt((rec.hit_point.x - center.x) * (rec.hit_point.x - center.x) + (rec.hit_point.z - center.z) * (rec.hit_point.z - center.z));
 		outward_normal = vector3(rec.hit_point.x - center.x, rs * (radius / height), rec.hit_point.z - center.z);
 	}
 
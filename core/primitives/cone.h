@@ -17,8 +17,8 @@ class cone : public hittable
 {
 public:
     cone(std::string _name = "Cone");
-    cone(vector3 _center, double _radius, double _height, std::shared_ptr<material> _material, std::string _name = "Cone");
-    cone(vector3 _center, double _radius, double _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name = "Cone");
+    cone(vector3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, std::string _name = "Cone");
+    cone(vector3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name = "Cone");
 	virtual ~cone() {}
 
     bool hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const;
@@ -26,8 +26,8 @@ public:
 
 private:
     vector3 center;
-    double radius;
-    double height;
+    rreal radius;
+    rreal height;
     std::shared_ptr<material> mat;
 
     /// <summary>
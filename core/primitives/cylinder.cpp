@@ -10,17 +10,17 @@ cylinder::cylinder(std::string _name)
 {
 }
 
-cylinder::cylinder(point3 _center, double _radius, double _height, std::string _name)
+cylinder::cylinder(point3 _center, rreal _radius, rreal _height, std::string _name)
     : cylinder(_center, _radius, _height, nullptr, uvmapping(), _name)
 {
 }
 
-cylinder::cylinder(point3 _center, double _radius, double _height, std::shared_ptr<material> _material, std::string _name)
+cylinder::cylinder(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, std::string _name)
     : cylinder(_center, _radius, _height, _material, uvmapping(), _name)
 {
 }
 
-cylinder::cylinder(point3 _center, double _radius, double _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name)
+cylinder::cylinder(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name)
     : center(_center), radius(_radius), height(_height), mat(_material)
 {
     m_name = _name;
@@ -36,17 +36,17 @@ cylinder::cylinder(point3 _center, double _radius, double _height, std::shared_p
 bool cylinder::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
 {
     vector3 oc = r.origin() - center;
-    double a = r.direction().x * r.direction().x + r.direction().z * r.direction().z;
-    double b = 2.0 * (oc.x * r.direction().x + oc.z * r.direction().z);
-    double c = oc.x * oc.x + oc.z * oc.z - radius * radius;
-    double d = b * b - 4 * a * c;
+    rreal a = r.direction().x * r.direction().x + r.direction().z * r.direction().z;
+    rreal b = 2.0 * (oc.x * r.direction().x + oc.z * r.direction().z);
+    rreal c = oc.x * oc.x + oc.z * oc.z - radius * radius;
+    rreal d = b * b - 4 * a * c;
 
     if (d < 0)
     {
         return false;
     }
 
-    double root = (-b - sqrt(d)) / (2.0 * a);
+    rreal root = (-b - sqrt(d)) / (2.0 * a);
 
     if (root < ray_t.min || ray_t.max < root)
     {
@@ -57,7 +57,7 @@ bool cylinder::hit(const ray& r, interval ray_t, hit_record& rec, int depth, ran
         }
     }
 
-    double y = r.origin().y + root * r.direction().y;
+    rreal y = r.origin().y + root * r.direction().y;
 
     if ((y < center.y) || (y > center.y + height))
     {
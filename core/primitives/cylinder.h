@@ -16,9 +16,9 @@ class cylinder : public hittable
 {
 public:
     cylinder(std::string _name = "Cylinder");
-    cylinder(point3 _center, double _radius, double _height, std::string _name = "Cylinder");
-    cylinder(point3 _center, double _radius, double _height, std::shared_ptr<material> _material, std::string _name = "Cylinder");
-    cylinder(point3 _center, double _radius, double _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name = "Cylinder");
+    cylinder(point3 _center, rreal _radius, rreal _height, std::string _name = "Cylinder");
+    cylinder(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, std::string _name = "Cylinder");
+    cylinder(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _material, const uvmapping& _mapping, std::string _name = "Cylinder");
 
     bool hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const;
  
@@ -27,8 +27,8 @@ public:
 
 private:
     point3 center;
-    double radius;
-    double height;
+    rreal radius;
+    rreal height;
     std::shared_ptr<material> mat;
 
     /// <summary>
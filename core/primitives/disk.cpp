@@ -7,12 +7,12 @@ disk::disk(std::string _name)
 {
 }
 
-disk::disk(point3 _center, double _radius, double _height, std::shared_ptr<material> _mat, std::string _name)
+disk::disk(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _mat, std::string _name)
     : disk(_center, _radius, _height, _mat, uvmapping(), _name)
 {
 }
 
-disk::disk(point3 _center, double _radius, double _height, std::shared_ptr<material> _mat, const uvmapping& _mapping, std::string _name)
+disk::disk(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _mat, const uvmapping& _mapping, std::string _name)
     : center(_center), radius(_radius), height(_height), mat(_mat)
 {
     m_name = _name;
@@ -25,14 +25,14 @@ disk::disk(point3 _center, double _radius, double _height, std::shared_ptr<mater
 bool disk::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
 {
     // Compute the intersection with the plane containing the disk
-    double t = (center.y - r.origin().y) / r.direction().y;
+    rreal t = (center.y - r.origin().y) / r.direction().y;
     if (t < ray_t.min || t > ray_t.max)
         return false;
 
     point3 hit_point = r.at(t);
 
     // Check if the hit point is within the disk's radius
-    double dist_squared = (hit_point.x - center.x) * (hit_point.x - center.x) + (hit_point.z - center.z) * (hit_point.z - center.z);
+    rreal dist_squared = (hit_point.x - center.x) * (hit_point.x - center.x) + (hit_point.z - center.z) * (hit_point.z - center.z);
     if (dist_squared > radius * radius)
         return false;
 
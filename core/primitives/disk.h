@@ -13,16 +13,16 @@ class disk : public hittable
 {
 public:
     disk(std::string _name = "Disk");
-    disk(point3 _center, double _radius, double _height, std::shared_ptr<material> _mat, std::string _name = "Disk");
-    disk(point3 _center, double _radius, double _height, std::shared_ptr<material> _mat, const uvmapping& _mapping, std::string _name = "Disk");
+    disk(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _mat, std::string _name = "Disk");
+    disk(point3 _center, rreal _radius, rreal _height, std::shared_ptr<material> _mat, const uvmapping& _mapping, std::string _name = "Disk");
 
     virtual bool hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const override;
     virtual aabb bounding_box() const override;
 
 public:
     point3 center;
-    double radius;
-    double height;
+    rreal radius;
+    rreal height;
     std::shared_ptr<material> mat;
 
     /// <summary>
@@ -1,7 +1,9 @@
 #include "quad.h"
 
 #include "../misc/singleton.h"
+#include "../utilities/spherical_sampling.h"
 
+#include <algorithm>
 #include <cmath>
 
 quad::quad(const point3& _position, const vector3& _u, const vector3& _v, std::shared_ptr<material> _mat, std::string _name)
@@ -53,7 +55,7 @@ bool quad::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomi
     auto denom = glm::dot(m_normal, r.direction());
 
     // No hit if the ray is parallel to the plane.
-    if (fabs(denom) < 1e-8)
+    if (fabs(denom) < PARALLEL_EPSILON)
         return false;
 
     // Return false if the hit point parameter t is outside the ray interval.
@@ -76,6 +78,9 @@ bool quad::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomi
     rec.mat = m_mat;
     rec.set_face_normal(r, m_normal);
 
+    // uv spans [0,1] along both sides
+    rec.uv_density = std::sqrt(m_area);
+
     // name of the primitive hit by the ray
     rec.name = m_name;
     rec.bbox = m_bbox;
@@ -83,7 +88,7 @@ bool quad::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomi
     return true;
 }
 
-bool quad::is_interior(double a, double b, hit_record& rec) const
+bool quad::is_interior(rreal a, rreal b, hit_record& rec) const
 {
     // Given the hit point in plane coordinates, return false if it is outside the
     // primitive, otherwise set the hit record UV coordinates and return true.
@@ -98,27 +103,72 @@ bool quad::is_interior(double a, double b, hit_record& rec) const
 
 double quad::pdf_value(const point3& origin, const vector3& v, randomizer& rnd) const
 {
-    hit_record rec;
+    // analytic pdf, the same sampling strategy as random() is selected from origin
+    point3 p0 = m_position, p1 = m_position + m_u, p2 = m_position + m_u + m_v, p3 = m_position + m_v;
+
+    double solid_angle_1 = spherical_triangle_solid_angle(origin, p0, p1, p2);
+    double solid_angle_2 = spherical_triangle_solid_angle(origin, p0, p2, p3);
+    double solid_angle = solid_angle_1 + solid_angle_2;
+
+    if (solid_angle >= MIN_SPHERICAL_SAMPLING_SOLID_ANGLE)
+    {
+        if (!spherical_triangle_contains(origin, p0, p1, p2, v) && !spherical_triangle_contains(origin, p0, p2, p3, v))
+            return 0;
+
+        return 1.0 / solid_angle;
+    }
 
-    if (!this->hit(ray(origin, v), interval(SHADOW_ACNE_FIX, infinity), rec, 0, rnd))
+    // small or far quad : area sampling, plane coordinates of the crossing point without filling a hit record
+    auto denom = glm::dot(m_normal, v);
+    if (fabs(denom) < PARALLEL_EPSILON)
         return 0;
 
-    auto distance_squared = rec.t * rec.t * vector_length_squared(v);
-    auto cosine = fabs(dot(v, rec.normal) / vector_length(v));
+    auto t = (m_d - glm::dot(m_normal, origin)) / denom;
+    if (t <= SHADOW_ACNE_FIX)
+        return 0;
+
+    vector3 planar_hitpt_vector = origin + t * v - m_position;
+    auto alpha = glm::dot(m_w, glm::cross(planar_hitpt_vector, m_v));
+    auto beta = glm::dot(m_w, glm::cross(m_u, planar_hitpt_vector));
+    if ((alpha < 0) || (1 < alpha) || (beta < 0) || (1 < beta))
+        return 0;
+
+    auto distance_squared = t * t * vector_length_squared(v);
+    auto cosine = fabs(denom / vector_length(v));
 
     return distance_squared / (cosine * m_area);
 }
 
 /// <summary>
 /// Random special implementation for quad (override base)
+/// Uniform in the solid angle subtended by the quad (split in two spherical triangles picked proportionally to their solid angle)
 /// </summary>
 /// <param name="origin"></param>
 /// <returns></returns>
 vector3 quad::random(const point3& origin, randomizer& rnd) const
 {
+    double r1 = rnd.get_real(0.0, 1.0);
+    double r2 = rnd.get_real(0.0, 1.0);
+
+    point3 p0 = m_position, p1 = m_position + m_u, p2 = m_position + m_u + m_v, p3 = m_position + m_v;
+
+    double solid_angle_1 = spherical_triangle_solid_angle(origin, p0, p1, p2);
+    double solid_angle_2 = spherical_triangle_solid_angle(origin, p0, p2, p3);
+    double solid_angle = solid_angle_1 + solid_angle_2;
+
+    if (solid_angle >= MIN_SPHERICAL_SAMPLING_SOLID_ANGLE)
+    {
+        // r1 picks the triangle then is remapped to [0, 1) to sample inside it
+        double p_first = solid_angle_1 / solid_angle;
+        if (r1 < p_first)
+            return sample_spherical_triangle(origin, p0, p1, p2, r1 / p_first, r2);
+
+        return sample_spherical_triangle(origin, p0, p2, p3, std::min((r1 - p_first) / (1.0 - p_first), 0.99999999999999989), r2);
+    }
+
     auto p = m_position 
-        + (rnd.get_real(0.0, 1.0) * m_u) 
-        + (rnd.get_real(0.0, 1.0) * m_v);
+        + (rreal(r1) * m_u) 
+        + (rreal(r2) * m_v);
 
     return p - origin;
 }
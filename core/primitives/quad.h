@@ -30,7 +30,7 @@ public:
     bool hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const override;
 
 
-    bool is_interior(double a, double b, hit_record& rec) const;
+    bool is_interior(rreal a, rreal b, hit_record& rec) const;
 
 
     double pdf_value(const point3& origin, const vector3& v, randomizer& rnd) const override;
@@ -58,7 +58,7 @@ private:
     vector3 m_v; //  a vector representing the second side
     std::shared_ptr<material> m_mat = nullptr;
     vector3 m_normal{};
-    double m_d = 0.0;
+    rreal m_d = 0.0;
     vector3 m_w{}; // The vector w is constant for a given quadrilateral, so we'll cache that value
-    double m_area = 0.0;
+    rreal m_area = 0.0;
 };
\ No newline at end of file
@@ -9,9 +9,9 @@ rt::rotate::rotate(std::shared_ptr<hittable> _object, const vector3& _rotation)
 {
     m_name = _object->getName();
 
-    auto radians_x = degrees_to_radians(_rotation.x);
-    auto radians_y = degrees_to_radians(_rotation.y);
-    auto radians_z = degrees_to_radians(_rotation.z);
+    rreal radians_x = degrees_to_radians(_rotation.x);
+    rreal radians_y = degrees_to_radians(_rotation.y);
+    rreal radians_z = degrees_to_radians(_rotation.z);
 
 
     matrix4 rotationMatrix(1.0f);
@@ -57,9 +57,9 @@ bool rt::rotate::hit(const ray& r, interval ray_t, hit_record& rec, int depth, r
     vector4 origin_vec(origin[0], origin[1], origin[2], 1.0f);
     vector4 direction_vec(direction[0], direction[1], direction[2], 0.0f);
 
-    auto radians_x = degrees_to_radians(-m_rotation.x);
-    auto radians_y = degrees_to_radians(-m_rotation.y);
-    auto radians_z = degrees_to_radians(-m_rotation.z);
+    rreal radians_x = degrees_to_radians(-m_rotation.x);
+    rreal radians_y = degrees_to_radians(-m_rotation.y);
+    rreal radians_z = degrees_to_radians(-m_rotation.z);
 
     matrix4 inverseRotationMatrix(1.0f);
     inverseRotationMatrix = glm::rotate(inverseRotationMatrix, radians_x, vector3(1.0f, 0.0f, 0.0f));
@@ -82,9 +82,9 @@ bool rt::rotate::hit(const ray& r, interval ray_t, hit_record& rec, int depth, r
     vector4 normal_vec(rec.normal[0], rec.normal[1], rec.normal[2], 0.0f);
 
     matrix4 rotationMatrix(1.0f);
-    rotationMatrix = glm::rotate(rotationMatrix, degrees_to_radians(m_rotation.x), vector3(1.0f, 0.0f, 0.0f));
-    rotationMatrix = glm::rotate(rotationMatrix, degrees_to_radians(m_rotation.y), vector3(0.0f, 1.0f, 0.0f));
-    rotationMatrix = glm::rotate(rotationMatrix, degrees_to_radians(m_rotation.z), vector3(0.0f, 0.0f, 1.0f));
+    rotationMatrix = glm::rotate(rotationMatrix, rreal(degrees_to_radians(m_rotation.x)), vector3(1.0f, 0.0f, 0.0f));
+    rotationMatrix = glm::rotate(rotationMatrix, rreal(degrees_to_radians(m_rotation.y)), vector3(0.0f, 1.0f, 0.0f));
+    rotationMatrix = glm::rotate(rotationMatrix, rreal(degrees_to_radians(m_rotation.z)), vector3(0.0f, 0.0f, 1.0f));
 
     vector4 world_hit_point = rotationMatrix * hit_point_vec;
     vector4 world_normal = rotationMatrix * normal_vec;
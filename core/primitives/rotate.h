@@ -23,8 +23,8 @@ namespace rt
 
 	private:
 		std::shared_ptr<hittable> m_object;
-		double sin_theta = 0;
-		double cos_theta = 0;
+		rreal sin_theta = 0;
+		rreal cos_theta = 0;
 		aabb bbox;
 
 		vector3 m_rotation{};
@@ -1,5 +1,7 @@
 #include "scale.h"
 
+#include <cmath>
+
 rt::scale::scale(std::shared_ptr<hittable> p, const vector3& _scale)
 	: m_object(p), m_scale(_scale)
 {
@@ -35,6 +37,9 @@ bool rt::scale::hit(const ray& r, interval ray_t, hit_record& rec, int depth, ra
 		vector3 normal = rec.normal / m_scale;
 		rec.normal = unit_vector(normal);
 
+		// texture footprint scale follows the average scaling
+		rec.uv_density *= std::cbrt(std::abs(m_scale.x * m_scale.y * m_scale.z));
+
 		return true;
 	}
 
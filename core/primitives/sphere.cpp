@@ -11,13 +11,13 @@ using std::shared_ptr;
 using std::string;
 
 
-sphere::sphere(point3 _center, double _radius, shared_ptr<material> _material, string _name)
+sphere::sphere(point3 _center, rreal _radius, shared_ptr<material> _material, string _name)
     : sphere(_center, _radius, _material, uvmapping(), _name)
 {
     is_moving = false;
 }
 
-sphere::sphere(point3 _center1, point3 _center2, double _radius, shared_ptr<material> _material, string _name)
+sphere::sphere(point3 _center1, point3 _center2, rreal _radius, shared_ptr<material> _material, string _name)
     : center1(_center1), radius(_radius), mat(_material), is_moving(true)
 {
     m_name = _name;
@@ -31,7 +31,7 @@ sphere::sphere(point3 _center1, point3 _center2, double _radius, shared_ptr<mate
     center_vec = _center2 - _center1;
 }
 
-sphere::sphere(point3 _center, double _radius, shared_ptr<material> _material, const uvmapping& _mapping, string _name)
+sphere::sphere(point3 _center, rreal _radius, shared_ptr<material> _material, const uvmapping& _mapping, string _name)
     : center1(_center), radius(_radius), mat(_material), is_moving(false)
 {
     m_name = _name;
@@ -92,8 +92,8 @@ bool sphere::hit(const ray& r, interval ray_t, hit_record& rec, int depth, rando
     rec.set_face_normal(r, outward_normal);
 
     // compute phi and theta for tangent and bitangent calculation
-    double phi = atan2(outward_normal.z, outward_normal.x);
-    double theta = acos(outward_normal.y);
+    rreal phi = atan2(outward_normal.z, outward_normal.x);
+    rreal theta = acos(outward_normal.y);
 
     // compute sphere primitive tangent and bitangent for normals
     vector3 tan, bitan;
@@ -107,6 +107,10 @@ bool sphere::hit(const ray& r, interval ray_t, hit_record& rec, int depth, rando
     // compute UV coordinates
     get_sphere_uv(outward_normal, rec.u, rec.v, m_mapping);
 
+    // the mapping stretches and repeats the uv square over the whole sphere
+    double uv_area = std::abs(m_mapping.scale_u() * m_mapping.scale_v() * m_mapping.repeat_u() * m_mapping.repeat_v());
+    rec.uv_density = (uv_area > 0.0) ? radius * std::sqrt(4.0 * M_PI / uv_area) : 0.0;
+
     return true;
 }
 
@@ -114,11 +118,17 @@ double sphere::pdf_value(const point3& o, const vector3& v, randomizer& rnd) con
 {
     // This method only works for stationary spheres.
 
-    hit_record rec;
-    if (!this->hit(ray(o, v), interval(SHADOW_ACNE_FIX, infinity), rec, 0, rnd))
+    // analytic pdf : v must be inside the cone subtended by the sphere (no intersection needed)
+    vector3 direction = center1 - o;
+    auto distance_squared = vector_length_squared(direction);
+    if (distance_squared <= radius * radius)
+        return 0;
+
+    auto cos_theta_max = sqrt(1 - radius * radius / distance_squared);
+    auto cos_theta = glm::dot(direction, v) / sqrt(distance_squared * vector_length_squared(v));
+    if (cos_theta < cos_theta_max)
         return 0;
 
-    auto cos_theta_max = sqrt(1 - radius * radius / vector_length_squared(center1 - o));
     auto solid_angle = 2 * M_PI * (1 - cos_theta_max);
 
     return  1 / solid_angle;
@@ -140,7 +150,7 @@ vector3 sphere::random(const point3& o, randomizer& rnd) const
 
 
 
-point3 sphere::sphere_center(double time) const
+point3 sphere::sphere_center(rreal time) const
 {
     // Linearly interpolate from center1 to center2 according to time, where t=0 yields
     // center1, and t=1 yields center2.
@@ -156,7 +166,7 @@ point3 sphere::sphere_center(double time) const
 /// <param name="theta"></param>
 /// <param name="tan"></param>
 /// <param name="bitan"></param>
-void sphere::getTangentAndBitangentAroundPoint(const vector3& p, double radius, double phi, double theta, vector3& tan, vector3& bitan)
+void sphere::getTangentAndBitangentAroundPoint(const vector3& p, rreal radius, rreal phi, rreal theta, vector3& tan, vector3& bitan)
 {
     // Tangent in the direction of increasing phi
     //tan.x = -p.z;
@@ -20,11 +20,11 @@ class sphere : public hittable
 {
 public:
     // Stationary Sphere
-    sphere(point3 _center, double _radius, shared_ptr<material> _material, string _name = "Sphere");
-    sphere(point3 _center, double _radius, shared_ptr<material> _material, const uvmapping& _mapping, string _name = "Sphere");
+    sphere(point3 _center, rreal _radius, shared_ptr<material> _material, string _name = "Sphere");
+    sphere(point3 _center, rreal _radius, shared_ptr<material> _material, const uvmapping& _mapping, string _name = "Sphere");
 
     // Moving Sphere
-    sphere(point3 _center1, point3 _center2, double _radius, shared_ptr<material> _material, string _name = "Sphere");
+    sphere(point3 _center1, point3 _center2, rreal _radius, shared_ptr<material> _material, string _name = "Sphere");
 
 
     aabb bounding_box() const override;
@@ -54,13 +54,13 @@ public:
 
 private:
     point3 center1{};
-    double radius = 0;
+    rreal radius = 0;
     shared_ptr<material> mat;
     bool is_moving = false;
     vector3 center_vec{};
 
-    point3 sphere_center(double time) const;
-    static void getTangentAndBitangentAroundPoint(const vector3& p, double radius, double phi, double theta, vector3& tan, vector3& bitan);
+    point3 sphere_center(rreal time) const;
+    static void getTangentAndBitangentAroundPoint(const vector3& p, rreal radius, rreal phi, rreal theta, vector3& tan, vector3& bitan);
 
 
     /// <summary>
@@ -1,11 +1,9 @@
 #include "torus.h"
 
 #include "../utilities/uvmapping.h"
+#include "../utilities/quartic_solver.h"
 
 #include <glm/glm.hpp>
-#include <unsupported/eigen/polynomials>
-
-#include <algorithm>
 
 
 torus::torus(std::string _name) : torus(vector3(0, 0, 0), 0.5, 0.25, nullptr, uvmapping(), _name)
@@ -29,6 +27,7 @@ torus::torus(point3 _center, float _majorRadius, float _minorRadius, std::shared
 
 	_R2 = majorRadius * majorRadius;
 	_R2r2 = _R2 - (minorRadius * minorRadius);
+	_Rr = majorRadius + minorRadius;
 }
 
 bool torus::hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const
@@ -71,7 +70,7 @@ bool torus::hit(const ray& r, interval ray_t, hit_record& rec, int depth, random
 	//rec.t = reals[0];
 	//vector3 p = e + rec.t * d;
 	//vector3 pp = vector3(p.x, p.y, 0.);
-	//vector3 c = glm::normalize(pp) * majorRadius; // center of tube
+	//vector3 c = glm::normalize(pp) * rreal(majorRadius); // center of tube
 	//vector3 n = glm::normalize(p - c);
 
 	//rec.hit_point = r.at(rec.t);
@@ -95,46 +94,91 @@ bool torus::hit(const ray& r, interval ray_t, hit_record& rec, int depth, random
 
 	//return true;
 
-	const vector3 d = r.direction();
-	const vector3 e = r.origin() - center;
+	// The quartic is badly conditioned, so the whole intersection runs in double precision
+	// (even when the core is built with single precision reals)
+	const glm::dvec3 ray_dir = glm::dvec3(r.direction());
+
+	// Work with a normalized direction so the quartic leading coefficient is 1
+	const double dir_length = glm::length(ray_dir);
+	if (dir_length == 0.0)
+	{
+		return false;
+	}
+
+	const glm::dvec3 d = ray_dir / dir_length;
+	glm::dvec3 e = glm::dvec3(r.origin()) - glm::dvec3(center);
+
+	// Early out : the torus is entirely contained in a sphere of radius (majorRadius + minorRadius)
+	const double b_sphere = glm::dot(e, d);
+	const double c_sphere = glm::dot(e, e) - _Rr * _Rr;
+	const double disc_sphere = b_sphere * b_sphere - c_sphere;
+	if (disc_sphere < 0.0)
+	{
+		return false;
+	}
+
+	const double sqrt_disc_sphere = std::sqrt(disc_sphere);
+	const double t_near = -b_sphere - sqrt_disc_sphere;
+	const double t_far = -b_sphere + sqrt_disc_sphere;
+
+	// ray interval expressed along the normalized direction
+	const double t_min = static_cast<double>(ray_t.min) * dir_length;
+	const double t_max = static_cast<double>(ray_t.max) * dir_length;
+
+	if (t_far < t_min || t_near > t_max)
+	{
+		return false;
+	}
+
+	// Early out : slabs test against the (tight in z) torus bounding box
+	if (!m_bbox.hit(r, ray_t))
+	{
+		return false;
+	}
+
+	// Move the ray origin next to the bounding sphere to improve the quartic conditioning
+	const double t_shift = t_near > 0.0 ? t_near : 0.0;
+	e += t_shift * d;
 
 	double dx2 = d.x * d.x, dy2 = d.y * d.y;
 	double ex2 = e.x * e.x, ey2 = e.y * e.y;
 	double dxex = d.x * e.x, dyey = d.y * e.y;
 
-	double A = glm::dot(d, d);
 	double B = 2 * glm::dot(d, e);
 	double C = glm::dot(e, e) + (_R2r2);
 	double D = 4 * _R2 * (dx2 + dy2);
 	double E = 8 * _R2 * (dxex + dyey);
 	double F = 4 * _R2 * (ex2 + ey2);
 
-	Eigen::VectorXd op(5);
-	op << C * C - F, 2 * B * C - E, 2 * A * C + B * B - D, 2 * A * B, A* A;
+	// (t^2 + B*t + C)^2 - (D*t^2 + E*t + F) = 0, solved without any heap allocation
+	double roots[4];
+	int nb_roots = quartic_solver::solve_quartic(1.0, 2 * B, 2 * C + B * B - D, 2 * B * C - E, C * C - F, roots);
 
-	Eigen::PolynomialSolver<double, 4> psolve(op);
-	std::vector<double> reals;
-	psolve.realRoots(reals);
+	// roots are sorted, keep the nearest one inside the ray interval
+	double t_hit = 0.0;
+	bool found = false;
 
-	for (int i = static_cast<int>(reals.size()) - 1; i >= 0; i--)
+	for (int i = 0; i < nb_roots; i++)
 	{
-		if (reals[i] < ray_t.min || reals[i] > ray_t.max)
+		double t = roots[i] + t_shift;
+		if (t >= t_min && t <= t_max)
 		{
-			reals.erase(reals.begin() + i);
+			t_hit = t;
+			found = true;
+			break;
 		}
 	}
 
-	if (reals.empty())
+	if (!found)
 	{
 		return false;
 	}
 
-	std::sort(reals.begin(), reals.end());
-	rec.t = reals[0];
-	vector3 p = e + rec.t * d;
+	rec.t = static_cast<rreal>(t_hit / dir_length);
+	vector3 p = vector3((glm::dvec3(r.origin()) - glm::dvec3(center)) + t_hit * d);
 
 	vector3 pp = vector3(p.x, p.y, 0.);
-	vector3 c = glm::normalize(pp) * majorRadius; // center of tube
+	vector3 c = glm::normalize(pp) * rreal(majorRadius); // center of tube
 	vector3 n = glm::normalize(p - c);
 
 	rec.hit_point = r.at(rec.t);
@@ -144,7 +188,7 @@ bool torus::hit(const ray& r, interval ray_t, hit_record& rec, int depth, random
 	rec.set_face_normal(r, outward_normal);
 
 	// UV coordinates
-	double u, v;
+	rreal u, v;
 	get_torus_uv(p, c, u, v, majorRadius, minorRadius, m_mapping);
 
 	// Set UV coordinates
@@ -39,6 +39,7 @@ private:
 	double minorRadius = 0;
 	std::shared_ptr<material> mat;
 	double _R2 = 0, _R2r2 = 0;
+	double _Rr = 0; // bounding sphere radius
 
 	/// <summary>
 	/// Update the internal AABB of the mesh.
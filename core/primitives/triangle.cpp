@@ -1,12 +1,10 @@
 #include "triangle.h"
 
 #include "../misc/singleton.h"
-#include "../utilities/triangle_cache.h"
+#include "../utilities/spherical_sampling.h"
 
 #include <glm/glm.hpp>
 
-#define EPS 0.000001
-
 triangle::triangle(std::string _name)
 {
 }
@@ -54,23 +52,22 @@ triangle::triangle(size_t shape_index, size_t triangle_index, const vector3 v0,
     v0_v1 = verts[1] - verts[0];
     v0_v2 = verts[2] - verts[0];
 
-    //double a = (v0 - v1).length();
-    //double b = (v1 - v2).length();
-    //double c = (v2 - v0).length();
-    //double s = (a + b + c) / 2.0;
-    //area = sqrt(fabs(s * (s - a) * (s - b) * (s - c)));
-    //middle_normal = unit_vector(glm::cross(v0 - v1, v0 - v2));
-
+    // geometric area and normal are computed once at mesh build (no global cache lookup needed)
+    vector3 edges_cross = glm::cross(v0_v1, v0_v2);
+    area = rreal(0.5) * vector_length(edges_cross);
+    middle_normal = unit_vector(edges_cross);
 
-    auto [cached_area, cached_middle_normal] = TriangleCache::get_area_and_normal(shape_index, triangle_index, v0, v1, v2);
-    area = cached_area;
-    middle_normal = cached_middle_normal;
+    // texture footprint scale (ratio of the world and uv areas)
+    vector2 duv1 = vert_uvs[1] - vert_uvs[0];
+    vector2 duv2 = vert_uvs[2] - vert_uvs[0];
+    rreal uv_area = rreal(0.5) * std::abs(duv1.x * duv2.y - duv1.y * duv2.x);
+    uv_density = (uv_area > 0) ? std::sqrt(area / uv_area) : rreal(0);
 
 
     // bounding box
     vector3 max_extent = max(max(verts[0], verts[1]), verts[2]);
     vector3 min_extent = min(min(verts[0], verts[1]), verts[2]);
-    double eps = 0.001;
+    rreal eps = 0.001;
     auto epsv = vector3(eps, eps, eps);
     m_bbox = aabb(min_extent - epsv, max_extent + epsv);
 }
@@ -84,8 +81,8 @@ bool triangle::hit(const ray& r, interval ray_t, hit_record& rec, int depth, ran
     auto det = glm::dot(v0_v1, parallel_vec);
     // If det < 0, this is a back-facing intersection, change hit_record front_face
     // ray and triangle are parallel if det is close to 0
-    if (fabs(det) < EPS) return false;
-    auto inv_det = 1.0 / det;
+    if (fabs(det) < TRIANGLE_EPSILON) return false;
+    auto inv_det = rreal(1) / det;
 
     auto tvec = r.origin() - verts[0];
     auto u = glm::dot(tvec, parallel_vec) * inv_det;
@@ -95,7 +92,7 @@ bool triangle::hit(const ray& r, interval ray_t, hit_record& rec, int depth, ran
     auto v = glm::dot(r.direction(), qvec) * inv_det;
     if (v < 0 || u + v > 1) return false;
 
-    double t = glm::dot(v0_v2, qvec) * inv_det;
+    rreal t = glm::dot(v0_v2, qvec) * inv_det;
     if (t < ray_t.min || t > ray_t.max) return false;
 
     rec.t = t;
@@ -110,7 +107,7 @@ bool triangle::hit(const ray& r, interval ray_t, hit_record& rec, int depth, ran
     
     if (smooth_normals)
     {
-        double a = u, b = v, c = 1 - u - v;
+        rreal a = u, b = v, c = 1 - u - v;
         // What does u and v map to?
         normal = a * vert_normals[1] + b * vert_normals[2] + c * vert_normals[0];
     }
@@ -122,6 +119,7 @@ bool triangle::hit(const ray& r, interval ray_t, hit_record& rec, int depth, ran
     // set normal and front-face tracking
     vector3 outward_normal = normal;
     rec.set_face_normal(r, outward_normal);
+    rec.uv_density = uv_density;
 
     // no need to calculate tangents and bitangents, just get them from obj file
     rec.tangent = vert_tangents[0];
@@ -156,31 +154,22 @@ aabb triangle::bounding_box() const
 
 double triangle::pdf_value(const point3& o, const vector3& v, randomizer& rnd) const
 {
-    hit_record rec;
-    if (!this->hit(ray(o, v), interval(EPS, infinity), rec, 0, rnd))
+    // analytic pdf, the same sampling strategy as random() is selected from o
+    if (!spherical_triangle_contains(o, verts[0], verts[1], verts[2], v))
         return 0;
 
-    vector3 R1 = verts[0] - o;
-    vector3 R2 = verts[1] - o;
-    vector3 R3 = verts[2] - o;
-
-    double r1_sq = glm::dot(R1, R1);
-    double r2_sq = glm::dot(R2, R2);
-    double r3_sq = glm::dot(R3, R3);
-
-    double N = glm::dot(R1, glm::cross(R2, R3));
+    double solid_angle = spherical_triangle_solid_angle(o, verts[0], verts[1], verts[2]);
+    if (solid_angle >= MIN_SPHERICAL_SAMPLING_SOLID_ANGLE)
+        return 1.0 / solid_angle;
 
-    // Precompute dot products once
-    double dotR1R2 = glm::dot(R1, R2);
-    double dotR1R3 = glm::dot(R1, R3);
-    double dotR2R3 = glm::dot(R2, R3);
-
-    // Compute D with optimized terms
-    double D = std::sqrt(r1_sq * r2_sq * r3_sq) + dotR1R2 * std::sqrt(r3_sq) + dotR1R3 * std::sqrt(r2_sq) + dotR2R3 * std::sqrt(r1_sq);
+    // small or far triangle : area sampling, distance to the plane along v instead of a full intersection
+    double cosine = std::abs(glm::dot(middle_normal, v)) / vector_length(v);
+    if (cosine <= 0.0 || area <= 0.0)
+        return 0;
 
-    double omega = util::atan2(N, D);
+    double distance = std::abs(glm::dot(middle_normal, verts[0] - o)) / cosine;
 
-    return 1.0 / omega;
+    return distance * distance / (cosine * area);
 }
 
 //vector3 triangle::random(const point3& o, randomizer& rnd) const
@@ -195,23 +184,36 @@ double triangle::pdf_value(const point3& o, const vector3& v, randomizer& rnd) c
 
 vector3 triangle::random(const point3& o, randomizer& rnd) const
 {
-    // From https://math.stackexchange.com/questions/18686/uniform-random-point-in-triangle-in-3d
-    // Generate two random values between 0 and 1
     double r1 = rnd.get_real(0.0, 1.0);
     double r2 = rnd.get_real(0.0, 1.0);
 
+    // uniform in the solid angle subtended by the triangle
+    if (spherical_triangle_solid_angle(o, verts[0], verts[1], verts[2]) >= MIN_SPHERICAL_SAMPLING_SOLID_ANGLE)
+        return sample_spherical_triangle(o, verts[0], verts[1], verts[2], r1, r2);
+
+    // From https://math.stackexchange.com/questions/18686/uniform-random-point-in-triangle-in-3d
     // Calculate sqrt of r1 only once
-    double sqrt_r1 = glm::sqrt(r1);
+    rreal sqrt_r1 = glm::sqrt(r1);
 
     // Calculate the weights for each vertex
-    double ca = 1.0 - sqrt_r1;
-    double cb = sqrt_r1 * (1.0 - r2);
-    double cc = sqrt_r1 * r2;
+    rreal ca = 1.0 - sqrt_r1;
+    rreal cb = sqrt_r1 * (1.0 - r2);
+    rreal cc = sqrt_r1 * r2;
 
     // Calculate and return the weighted sum, adjusted by point `o`
     return verts[0] * ca + verts[1] * cb + verts[2] * cc - o;
 }
 
+double triangle::getArea() const
+{
+    return area;
+}
+
+vector3 triangle::getNormal() const
+{
+    return middle_normal;
+}
+
 /// <summary>
 /// Update the internal AABB of the mesh.
 /// Warning: run this when the mesh is updated.
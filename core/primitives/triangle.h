@@ -44,6 +44,13 @@ class triangle: public hittable
         /// <returns></returns>
         vector3 random(const point3& o, randomizer& rnd) const override;
 
+        double getArea() const;
+
+        /// <summary>
+        /// Geometric (flat) normal
+        /// </summary>
+        vector3 getNormal() const;
+
     public:
         vector3 verts[3]{};
         vector3 vert_normals[3]{};
@@ -55,8 +62,9 @@ class triangle: public hittable
         bool smooth_normals = false;
         std::shared_ptr<material> mat_ptr = nullptr;
     private:
-        double area;
+        rreal area;
         vector3 middle_normal;
+        rreal uv_density = 0; // world length per uv unit
 
         vector3 v0_v1{};
         vector3 v0_v2{};
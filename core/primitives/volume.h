@@ -18,8 +18,8 @@
 class volume : public hittable
 {
 public:
-    volume(std::shared_ptr<hittable> boundary, double density, std::shared_ptr<texture> tex, std::string _name = "Volume");
-    volume(std::shared_ptr<hittable> boundary, double density, color c, std::string _name = "Volume");
+    volume(std::shared_ptr<hittable> boundary, rreal density, std::shared_ptr<texture> tex, std::string _name = "Volume");
+    volume(std::shared_ptr<hittable> boundary, rreal density, color c, std::string _name = "Volume");
 
     bool hit(const ray& r, interval ray_t, hit_record& rec, int depth, randomizer& rnd) const override;
     aabb bounding_box() const override;
@@ -27,7 +27,7 @@ public:
 
 private:
     std::shared_ptr<hittable> m_boundary = nullptr;
-    double m_neg_inv_density = 0.0;
+    rreal m_neg_inv_density = 0.0;
     std::shared_ptr<material> m_phase_function = nullptr;
 
     /// <summary>
@@ -0,0 +1,526 @@
+#include "bdpt_integrator.h"
+
+#include "../lights/light.h"
+#include "../utilities/interval.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    bool is_black(const color& c)
+    {
+        return !(c.r() > 0.0 || c.g() > 0.0 || c.b() > 0.0);
+    }
+
+    double remap0(double f)
+    {
+        return f != 0.0 ? f : 1.0;
+    }
+}
+
+bdpt_integrator::bdpt_integrator(camera& _camera, scene& _scene, int max_depth)
+    : m_camera(_camera), m_scene(_scene), m_max_depth(max_depth)
+{
+}
+
+color bdpt_integrator::li(const ray& camera_ray, randomizer& rnd, splat_buffer& splats) const
+{
+    std::vector<vertex> camera_path;
+    std::vector<vertex> light_path;
+    camera_path.reserve(m_max_depth + 2);
+    light_path.reserve(m_max_depth + 1);
+
+    // escaping rays only see the background through the camera subpath, no other strategy competes
+    color result(0, 0, 0);
+
+    int n_camera = camera_subpath(camera_ray, rnd, camera_path, result);
+    int n_light = light_subpath(rnd, light_path);
+
+    // the s = 1 strategy samples its own light vertex, even when the light subpath failed
+    if (light_path.empty())
+        light_path.resize(1);
+
+    for (int t = 1; t <= n_camera; t++)
+    {
+        for (int s = 0; s <= std::max(n_light, 1); s++)
+        {
+            int depth = s + t - 2;
+            if ((s == 1 && t == 1) || depth < 0 || depth > m_max_depth)
+                continue;
+
+            int raster_i = 0, raster_j = 0;
+            color contribution = connect(light_path, camera_path, s, t, rnd, raster_i, raster_j);
+            if (is_black(contribution))
+                continue;
+
+            if (t == 1)
+                splats.add(raster_i, raster_j, contribution);
+            else
+                result += contribution;
+        }
+    }
+
+    return result;
+}
+
+int bdpt_integrator::camera_subpath(const ray& camera_ray, randomizer& rnd, std::vector<vertex>& path, color& escaped) const
+{
+    vertex v;
+    v.type = vertex_type::camera;
+    v.p = camera_ray.origin();
+    v.beta = color(1, 1, 1);
+
+    // cameras that can't be connected to (no importance) only keep the camera subpath strategies
+    int i = 0, j = 0;
+    double we = 0.0, pdf_dir = 0.0;
+    if (!m_camera.importance(camera_ray.origin() + camera_ray.direction(), i, j, we, pdf_dir))
+    {
+        v.delta = true;
+        pdf_dir = 1.0;
+    }
+
+    path.push_back(v);
+
+    return random_walk(camera_ray, color(1, 1, 1), pdf_dir, rnd, m_max_depth + 1, true, path, escaped) + 1;
+}
+
+int bdpt_integrator::light_subpath(randomizer& rnd, std::vector<vertex>& path) const
+{
+    const light_sampler& lights = m_scene.get_light_sampler();
+
+    double pmf = 0.0;
+    int light_id = lights.sample(rnd, pmf);
+    if (light_id < 0 || pmf <= 0.0)
+        return 0;
+
+    std::shared_ptr<light> emitter = std::dynamic_pointer_cast<light>(lights.get_light(light_id));
+    if (!emitter)
+        return 0;
+
+    ray r;
+    vector3 normal;
+    color le;
+    double pdf_pos = 0.0, pdf_dir = 0.0;
+    if (!emitter->sample_emission(rnd, r, normal, le, pdf_pos, pdf_dir) || pdf_pos <= 0.0 || pdf_dir <= 0.0)
+        return 0;
+
+    vertex v;
+    v.type = vertex_type::light;
+    v.p = r.origin();
+    v.n = normal;
+    v.le = le;
+    v.beta = le;
+    v.light_id = light_id;
+
+    // the weights use the evaluated emission densities, the same ones as when a camera subpath hits the light
+    double mis_pdf_pos = 0.0;
+    double mis_pdf_dir = emitter->emission_pdf(v.p, normal, r.direction(), mis_pdf_pos);
+    v.pdf_fwd = pmf * mis_pdf_pos;
+
+    path.push_back(v);
+
+    double cosine = std::abs(glm::dot(normal, unit_vector(r.direction())));
+    color beta = le * rreal(cosine / (pmf * pdf_pos * pdf_dir));
+
+    color unused(0, 0, 0);
+    return random_walk(r, beta, mis_pdf_dir, rnd, m_max_depth, false, path, unused) + 1;
+}
+
+int bdpt_integrator::random_walk(ray r, color beta, double pdf_dir, randomizer& rnd, int max_vertices, bool from_camera, std::vector<vertex>& path, color& escaped) const
+{
+    if (max_vertices <= 0)
+        return 0;
+
+    const hittable_list& world = m_scene.get_world();
+    const light_sampler& lights = m_scene.get_light_sampler();
+
+    int bounces = 0;
+    double pdf_fwd = pdf_dir;
+
+    while (true)
+    {
+        // camera rays skip the invisible lights like the path tracer does
+        int depth = from_camera ? m_max_depth - bounces : 0;
+
+        hit_record rec;
+        if (!world.hit(r, interval(robust_epsilon(r.origin()), infinity), rec, depth, rnd))
+        {
+            if (from_camera)
+                escaped += beta * m_camera.get_background(r);
+            break;
+        }
+
+        color emitted = rec.mat->emitted(r, rec, rec.u, rec.v, rec.hit_point);
+
+        // hack for invisible primitives (such as lights), the ray goes through
+        if (emitted.a() == 0.0)
+        {
+            if (!world.hit(r, interval(rec.t + 0.001, infinity), rec, depth, rnd))
+            {
+                if (from_camera)
+                    escaped += beta * m_camera.get_background(r);
+                break;
+            }
+
+            emitted = rec.mat->emitted(r, rec, rec.u, rec.v, rec.hit_point);
+            if (emitted.a() == 0.0)
+                emitted = color(0, 0, 0);
+        }
+
+        vertex v;
+        v.type = vertex_type::surface;
+        v.p = rec.hit_point;
+        v.n = rec.normal;
+        v.beta = beta;
+        v.r_in = r;
+        v.rec = rec;
+        v.pdf_fwd = convert_density(pdf_fwd, path.back(), v);
+
+        if (from_camera && !is_black(emitted))
+        {
+            v.le = emitted;
+            v.light_id = lights.get_light_id(rec.mat.get());
+        }
+
+        v.scatters = rec.mat->scatter(r, m_scene.get_emissive_objects(), rec, v.srec, rnd);
+        path.push_back(v);
+
+        vertex& current = path.back();
+        vertex& previous = path[path.size() - 2];
+
+        if (++bounces >= max_vertices || !current.scatters)
+            break;
+
+        double pdf_rev = 0.0;
+
+        if (current.srec.skip_pdf)
+        {
+            // specular : can't be connected, its densities don't take part in the weights
+            current.delta = true;
+            beta = beta * current.srec.attenuation;
+            pdf_fwd = 0.0;
+            r = current.srec.skip_pdf_ray;
+        }
+        else
+        {
+            if (!current.srec.pdf_ptr)
+                break;
+
+            vector3 direction = current.srec.pdf_ptr->generate(current.srec, rnd);
+            pdf_fwd = current.srec.pdf_ptr->value(direction, rnd);
+            if (!(pdf_fwd > 0.0))
+                break;
+
+            color fc = f_cos(current, direction);
+            if (is_black(fc))
+                break;
+
+            beta = beta * fc / rreal(pdf_fwd);
+
+            // reverse density from the same lobe (exact for the cosine lobes of the diffuse materials)
+            pdf_rev = current.srec.pdf_ptr->value(-r.direction(), rnd);
+            r = ray(current.p, direction, r.time());
+        }
+
+        previous.pdf_rev = convert_density(pdf_rev, current, previous);
+    }
+
+    return bounces;
+}
+
+color bdpt_integrator::connect(std::vector<vertex>& light_path, std::vector<vertex>& camera_path, int s, int t, randomizer& rnd, int& raster_i, int& raster_j) const
+{
+    const light_sampler& lights = m_scene.get_light_sampler();
+
+    vertex& pt = camera_path[t - 1];
+    vertex sampled;
+    color l(0, 0, 0);
+
+    if (s == 0)
+    {
+        // the camera subpath found a light by itself
+        if (pt.type != vertex_type::surface || is_black(pt.le))
+            return color(0, 0, 0);
+
+        l = pt.le * pt.beta;
+    }
+    else if (t == 1)
+    {
+        // light tracing : connect a light subpath vertex to the camera
+        vertex& qs = light_path[s - 1];
+        const vertex& lens = camera_path[0];
+        if (lens.delta || !connectible(qs))
+            return color(0, 0, 0);
+
+        double we = 0.0, pdf_dir = 0.0;
+        if (!m_camera.importance(qs.p, raster_i, raster_j, we, pdf_dir))
+            return color(0, 0, 0);
+
+        vector3 to_camera = lens.p - qs.p;
+        double distance_squared = vector_length_squared(to_camera);
+        if (distance_squared <= 0.0)
+            return color(0, 0, 0);
+
+        color fc = f_cos(qs, to_camera);
+        if (is_black(fc) || !visible(qs.p, lens.p, rnd))
+            return color(0, 0, 0);
+
+        // pinhole : We x cos / d2 is pdf_dir / d2 (We = 1 / (A cos^4), pdf_dir = 1 / (A cos^3))
+        sampled = lens;
+        l = qs.beta * fc * rreal(pdf_dir / distance_squared);
+    }
+    else if (s == 1)
+    {
+        // next event estimation, the light vertex is sampled from the camera vertex
+        if (!connectible(pt))
+            return color(0, 0, 0);
+
+        double light_pmf = 0.0;
+        int light_id = lights.sample(pt.p, rnd, light_pmf);
+        if (light_id < 0 || light_pmf <= 0.0)
+            return color(0, 0, 0);
+
+        vector3 direction = lights.get_light(light_id)->random(pt.p, rnd);
+        double light_pdf = lights.pdf_value(pt.p, direction, rnd);
+        if (light_pdf <= 0.0)
+            return color(0, 0, 0);
+
+        color fc = f_cos(pt, direction);
+        if (is_black(fc))
+            return color(0, 0, 0);
+
+        // shadow ray, the first object hit must be a light
+        ray shadow_ray(pt.p, direction, pt.r_in.time());
+        hit_record shadow_rec;
+        if (!m_scene.get_world().hit(shadow_ray, interval(robust_epsilon(pt.p), infinity), shadow_rec, 0, rnd))
+            return color(0, 0, 0);
+
+        color emitted = shadow_rec.mat->emitted(shadow_ray, shadow_rec, shadow_rec.u, shadow_rec.v, shadow_rec.hit_point);
+        int hit_light_id = lights.get_light_id(shadow_rec.mat.get());
+        if (emitted.a() == 0.0 || hit_light_id < 0)
+            return color(0, 0, 0);
+
+        sampled.type = vertex_type::light;
+        sampled.p = shadow_rec.hit_point;
+        sampled.n = shadow_rec.normal;
+        sampled.le = emitted;
+        sampled.light_id = hit_light_id;
+        sampled.pdf_fwd = convert_density(light_pdf, pt, sampled);
+
+        l = pt.beta * fc * emitted / rreal(light_pdf);
+    }
+    else
+    {
+        // connect two surface vertices
+        vertex& qs = light_path[s - 1];
+        if (!connectible(qs) || !connectible(pt))
+            return color(0, 0, 0);
+
+        vector3 d = pt.p - qs.p;
+        double distance_squared = vector_length_squared(d);
+        if (distance_squared <= 0.0)
+            return color(0, 0, 0);
+
+        color fq = f_cos(qs, d);
+        color fp = f_cos(pt, -d);
+        if (is_black(fq) || is_black(fp) || !visible(qs.p, pt.p, rnd))
+            return color(0, 0, 0);
+
+        l = qs.beta * fq * fp * pt.beta / rreal(distance_squared);
+    }
+
+    if (is_black(l))
+        return color(0, 0, 0);
+
+    return l * rreal(mis_weight(light_path, camera_path, sampled, s, t, rnd));
+}
+
+double bdpt_integrator::mis_weight(std::vector<vertex>& light_path, std::vector<vertex>& camera_path, vertex& sampled, int s, int t, randomizer& rnd) const
+{
+    if (s + t == 2)
+        return 1.0;
+
+    // the sampled endpoint replaces the subpath one while the densities are evaluated
+    vertex saved_endpoint;
+    if (s == 1)
+    {
+        saved_endpoint = light_path[0];
+        light_path[0] = sampled;
+    }
+    else if (t == 1)
+    {
+        saved_endpoint = camera_path[0];
+        camera_path[0] = sampled;
+    }
+
+    vertex* qs = s > 0 ? &light_path[s - 1] : nullptr;
+    vertex* pt = &camera_path[t - 1];
+    vertex* qs_minus = s > 1 ? &light_path[s - 2] : nullptr;
+    vertex* pt_minus = t > 1 ? &camera_path[t - 2] : nullptr;
+
+    // densities of the connection from the other side (restored below)
+    bool saved_pt_delta = pt->delta;
+    double saved_pt_pdf_rev = pt->pdf_rev;
+    double saved_pt_minus_pdf_rev = pt_minus ? pt_minus->pdf_rev : 0.0;
+    bool saved_qs_delta = qs ? qs->delta : false;
+    double saved_qs_pdf_rev = qs ? qs->pdf_rev : 0.0;
+    double saved_qs_minus_pdf_rev = qs_minus ? qs_minus->pdf_rev : 0.0;
+
+    pt->delta = false;
+    if (qs)
+        qs->delta = false;
+
+    pt->pdf_rev = s > 0 ? pdf(*qs, qs_minus, *pt, rnd) : pdf_light_origin(*pt, *pt_minus, rnd);
+    if (pt_minus)
+        pt_minus->pdf_rev = s > 0 ? pdf(*pt, qs, *pt_minus, rnd) : pdf_light(*pt, *pt_minus);
+    if (qs)
+        qs->pdf_rev = pdf(*pt, pt_minus, *qs, rnd);
+    if (qs_minus)
+        qs_minus->pdf_rev = pdf(*qs, pt, *qs_minus, rnd);
+
+    // balance heuristic : ratios of the other strategies densities to this one
+    double sum_ri = 0.0;
+    double ri = 1.0;
+    for (int i = t - 1; i > 0; --i)
+    {
+        ri *= remap0(camera_path[i].pdf_rev) / remap0(camera_path[i].pdf_fwd);
+        if (!camera_path[i].delta && !camera_path[i - 1].delta)
+            sum_ri += ri;
+    }
+
+    ri = 1.0;
+    for (int i = s - 1; i >= 0; --i)
+    {
+        ri *= remap0(light_path[i].pdf_rev) / remap0(light_path[i].pdf_fwd);
+        bool delta_light_vertex = i > 0 ? light_path[i - 1].delta : false;
+        if (!light_path[i].delta && !delta_light_vertex)
+            sum_ri += ri;
+    }
+
+    pt->delta = saved_pt_delta;
+    pt->pdf_rev = saved_pt_pdf_rev;
+    if (pt_minus)
+        pt_minus->pdf_rev = saved_pt_minus_pdf_rev;
+    if (qs)
+    {
+        qs->delta = saved_qs_delta;
+        qs->pdf_rev = saved_qs_pdf_rev;
+    }
+    if (qs_minus)
+        qs_minus->pdf_rev = saved_qs_minus_pdf_rev;
+
+    if (s == 1)
+        light_path[0] = saved_endpoint;
+    else if (t == 1)
+        camera_path[0] = saved_endpoint;
+
+    return 1.0 / (1.0 + sum_ri);
+}
+
+color bdpt_integrator::f_cos(const vertex& v, const vector3& direction) const
+{
+    if (v.type != vertex_type::surface || !v.scatters || v.srec.skip_pdf)
+        return color(0, 0, 0);
+
+    double scattering_pdf = v.rec.mat->scattering_pdf(v.r_in, v.rec, ray(v.p, direction, v.r_in.time()));
+    if (!(scattering_pdf > 0.0))
+        return color(0, 0, 0);
+
+    return v.srec.attenuation * rreal(scattering_pdf);
+}
+
+double bdpt_integrator::pdf(const vertex& v, const vertex* prev, const vertex& next, randomizer& rnd) const
+{
+    if (v.type == vertex_type::light)
+        return pdf_light(v, next);
+
+    vector3 direction = next.p - v.p;
+    if (vector_length_squared(direction) <= 0.0)
+        return 0.0;
+
+    double pdf_dir = 0.0;
+
+    if (v.type == vertex_type::camera)
+    {
+        int i = 0, j = 0;
+        double we = 0.0;
+        if (!m_camera.importance(next.p, i, j, we, pdf_dir))
+            return 0.0;
+    }
+    else
+    {
+        if (!v.scatters || v.srec.skip_pdf || !v.srec.pdf_ptr)
+            return 0.0;
+
+        pdf_dir = v.srec.pdf_ptr->value(direction, rnd);
+    }
+
+    return convert_density(pdf_dir, v, next);
+}
+
+double bdpt_integrator::pdf_light(const vertex& v, const vertex& next) const
+{
+    if (v.light_id < 0)
+        return 0.0;
+
+    std::shared_ptr<light> emitter = std::dynamic_pointer_cast<light>(m_scene.get_light_sampler().get_light(v.light_id));
+    if (!emitter)
+        return 0.0;
+
+    double pdf_pos = 0.0;
+    double pdf_dir = emitter->emission_pdf(v.p, v.n, next.p - v.p, pdf_pos);
+
+    return convert_density(pdf_dir, v, next);
+}
+
+double bdpt_integrator::pdf_light_origin(const vertex& v, const vertex& next, randomizer& rnd) const
+{
+    if (v.light_id < 0)
+        return 0.0;
+
+    vector3 d = v.p - next.p;
+    double distance = vector_length(d);
+    if (distance <= 0.0)
+        return 0.0;
+
+    // same sampling as the s == 1 connection : light picked at next by the light bvh, then sampled in solid angle
+    const light_sampler& lights = m_scene.get_light_sampler();
+    double pdf_solid_angle = lights.pdf_value(next.p, d / rreal(distance), rnd);
+
+    return convert_density(pdf_solid_angle, next, v);
+}
+
+bool bdpt_integrator::visible(const point3& a, const point3& b, randomizer& rnd) const
+{
+    vector3 d = b - a;
+    double distance = vector_length(d);
+    if (distance <= 0.0)
+        return true;
+
+    hit_record rec;
+    ray r(a, d / rreal(distance));
+
+    return !m_scene.get_world().hit(r, interval(robust_epsilon(a), distance - robust_epsilon(b)), rec, 0, rnd);
+}
+
+bool bdpt_integrator::connectible(const vertex& v) const
+{
+    return v.type == vertex_type::surface && v.scatters && !v.srec.skip_pdf && v.srec.pdf_ptr;
+}
+
+double bdpt_integrator::convert_density(double pdf_solid_angle, const vertex& from, const vertex& to)
+{
+    vector3 w = to.p - from.p;
+    double distance_squared = vector_length_squared(w);
+    if (distance_squared <= 0.0)
+        return 0.0;
+
+    double inv_distance_squared = 1.0 / distance_squared;
+
+    // the camera is a point, surfaces and lights get the cosine of the arrival
+    if (to.type != vertex_type::camera)
+        pdf_solid_angle *= std::abs(glm::dot(to.n, w)) * std::sqrt(inv_distance_squared);
+
+    return pdf_solid_angle * inv_distance_squared;
+}
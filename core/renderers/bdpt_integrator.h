@@ -0,0 +1,83 @@
+#pragma once
+
+#include "splat_buffer.h"
+#include "../cameras/camera.h"
+#include "../misc/scene.h"
+#include "../misc/hit_record.h"
+#include "../misc/scatter_record.h"
+#include "../randomizers/randomizer.h"
+
+#include <vector>
+
+/// <summary>
+/// Bidirectional path tracing (Veach 1997, structure of pbrt-v3)
+/// A camera subpath and a light subpath are traced for each camera sample, then every pair of their vertices is connected
+/// Each connection strategy (s light vertices, t camera vertices) is weighted with the balance heuristic against all the others
+/// Light tracing connections (t = 1) land on any pixel, they go to the splat buffer
+/// </summary>
+class bdpt_integrator
+{
+public:
+    bdpt_integrator(camera& _camera, scene& _scene, int max_depth);
+
+    /// <summary>
+    /// Radiance of a camera sample, light tracing contributions are added to splats
+    /// </summary>
+    color li(const ray& camera_ray, randomizer& rnd, splat_buffer& splats) const;
+
+private:
+    enum class vertex_type { camera, light, surface };
+
+    struct vertex
+    {
+        vertex_type type = vertex_type::surface;
+        point3 p{};
+        vector3 n{}; // geometric normal (facing the incoming ray for surfaces)
+        color beta{}; // path throughput up to this vertex
+        bool delta = false; // specular scattering, can't be connected
+        double pdf_fwd = 0.0; // area density of this vertex sampled from its subpath
+        double pdf_rev = 0.0; // area density of this vertex sampled from the other side
+
+        // surface only
+        ray r_in;
+        hit_record rec;
+        scatter_record srec;
+        bool scatters = false;
+
+        // emitters (light vertices and surfaces hit on a light)
+        color le{}; // radiance emitted towards the previous vertex
+        int light_id = -1;
+    };
+
+    camera& m_camera;
+    scene& m_scene;
+    int m_max_depth = 10;
+
+    int camera_subpath(const ray& camera_ray, randomizer& rnd, std::vector<vertex>& path, color& escaped) const;
+    int light_subpath(randomizer& rnd, std::vector<vertex>& path) const;
+    int random_walk(ray r, color beta, double pdf_dir, randomizer& rnd, int max_vertices, bool from_camera, std::vector<vertex>& path, color& escaped) const;
+
+    color connect(std::vector<vertex>& light_path, std::vector<vertex>& camera_path, int s, int t, randomizer& rnd, int& raster_i, int& raster_j) const;
+    double mis_weight(std::vector<vertex>& light_path, std::vector<vertex>& camera_path, vertex& sampled, int s, int t, randomizer& rnd) const;
+
+    /// <summary>
+    /// Bsdf x |cos| at a surface vertex towards a direction
+    /// </summary>
+    color f_cos(const vertex& v, const vector3& direction) const;
+
+    /// <summary>
+    /// Area density of next sampled from v (prev is the vertex before v on the same subpath, unused by the current materials)
+    /// </summary>
+    double pdf(const vertex& v, const vertex* prev, const vertex& next, randomizer& rnd) const;
+    double pdf_light(const vertex& v, const vertex& next) const;
+
+    /// <summary>
+    /// Area density of the light vertex v when it is sampled from next by a s == 1 connection (next event estimation)
+    /// </summary>
+    double pdf_light_origin(const vertex& v, const vertex& next, randomizer& rnd) const;
+
+    bool visible(const point3& a, const point3& b, randomizer& rnd) const;
+    bool connectible(const vertex& v) const;
+
+    static double convert_density(double pdf_solid_angle, const vertex& from, const vertex& to);
+};
@@ -3,6 +3,7 @@
 #include "../outputs/no_output.h"
 #include "../outputs/standard_output.h"
 #include "../outputs/namedpipes_output.h"
+#include "bdpt_integrator.h"
 
 #include <thread>
 
@@ -34,6 +35,18 @@ void cpu_multithread_renderer::render(scene& _scene, camera& _camera, const rend
 
 	std::vector<std::vector<color>> image(image_height, std::vector<color>(image_width, color()));
 
+	// bidirectional path tracing, its light tracing contributions are splatted anywhere on the image
+	std::unique_ptr<bdpt_integrator> bdpt;
+	std::unique_ptr<splat_buffer> splats;
+
+	if (_params.integrator == 1)
+	{
+		std::cout << "[INFO] Using bidirectional path tracing" << std::endl;
+
+		bdpt = std::make_unique<bdpt_integrator>(_camera, _scene, max_depth);
+		splats = std::make_unique<splat_buffer>(image_width, image_height);
+	}
+
 	int global_done_scanlines = 0;
 
 	std::unique_ptr<output> out;
@@ -82,7 +95,7 @@ void cpu_multithread_renderer::render(scene& _scene, camera& _camera, const rend
 						ray r = _camera.get_ray(i, j, s_i, s_j, aa_sampler, rnd);
 
 						// pixel color is progressively being refined
-						pixel_color += _camera.ray_color(r, max_depth, _scene, rnd);
+						pixel_color += bdpt ? bdpt->li(r, rnd, *splats) : _camera.ray_color(r, max_depth, _scene, rnd);
 					}
 				}
 
@@ -119,6 +132,15 @@ void cpu_multithread_renderer::render(scene& _scene, camera& _camera, const rend
 		std::clog << "\r[INFO] Done.                 " << std::endl;
 
 
+	// light tracing splats use the same sample count normalization as the camera samples
+	if (splats)
+	{
+		splats->merge_into(image);
+
+		for (int j = 0; j < image_height; ++j)
+			preview_line(*out, j, image[j], spp, _params.useGammaCorrection);
+	}
+
 	out->clean_output();
 
 
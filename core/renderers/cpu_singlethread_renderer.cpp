@@ -3,6 +3,7 @@
 #include "../outputs/no_output.h"
 #include "../outputs/standard_output.h"
 #include "../outputs/namedpipes_output.h"
+#include "bdpt_integrator.h"
 
 #include "../misc/singleton.h"
 
@@ -22,6 +23,18 @@ void cpu_singlethread_renderer::render(scene& _scene, camera& _camera, const ren
 
 	std::vector<std::vector<color>> image(image_height, std::vector<color>(image_width, color()));
 
+	// bidirectional path tracing, its light tracing contributions are splatted anywhere on the image
+	std::unique_ptr<bdpt_integrator> bdpt;
+	std::unique_ptr<splat_buffer> splats;
+
+	if (_params.integrator == 1)
+	{
+		std::cout << "[INFO] Using bidirectional path tracing" << std::endl;
+
+		bdpt = std::make_unique<bdpt_integrator>(_camera, _scene, max_depth);
+		splats = std::make_unique<splat_buffer>(image_width, image_height);
+	}
+
 	std::unique_ptr<output> out;
 
 
@@ -54,7 +67,7 @@ void cpu_singlethread_renderer::render(scene& _scene, camera& _camera, const ren
 					ray r = _camera.get_ray(i, j, s_i, s_j, aa_sampler, rnd);
 
 					// pixel color is progressively being refined
-					pixel_color += _camera.ray_color(r, max_depth, _scene, rnd);
+					pixel_color += bdpt ? bdpt->li(r, rnd, *splats) : _camera.ray_color(r, max_depth, _scene, rnd);
 
 					image[j][i] = pixel_color;
 				}
@@ -74,6 +87,15 @@ void cpu_singlethread_renderer::render(scene& _scene, camera& _camera, const ren
 		std::clog << "\r[INFO] Done.                 \n";
 
 
+	// light tracing splats use the same sample count normalization as the camera samples
+	if (splats)
+	{
+		splats->merge_into(image);
+
+		for (int j = 0; j < image_height; ++j)
+			preview_line(*out, j, image[j], spp, _params.useGammaCorrection);
+	}
+
 	out->clean_output();
 
 
@@ -3,6 +3,8 @@
 
 #include "../outputs/standard_output.h"
 
+#include <algorithm>
+
 renderer::renderer(unsigned int nb_cores) : m_nb_core(nb_cores)
 {
 }
@@ -11,6 +13,80 @@ void renderer::render(scene& _scene, camera& _camera, const renderParameters& _p
 {
 }
 
+void renderer::train_path_guiding(scene& _scene, camera& _camera, const renderParameters& _params, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const
+{
+	path_guiding* guiding = _scene.get_path_guiding();
+	if (!guiding)
+		return;
+
+	const int image_height = _camera.getImageHeight();
+	const int image_width = _camera.getImageWidth();
+	const int sqrt_spp = std::max(_camera.getSqrtSpp(), 1);
+	const int max_depth = _camera.getMaxDepth();
+	const int passes = guiding->get_config().training_passes;
+
+	std::cout << "[INFO] Path guiding training (" << passes << " passes)" << std::endl;
+
+	for (int pass = 0; pass < passes; pass++)
+	{
+		// a different sub pixel stratum at each pass
+		const int s_i = pass % sqrt_spp;
+		const int s_j = (pass / sqrt_spp) % sqrt_spp;
+
+		#pragma omp parallel for schedule(dynamic, 4) num_threads(m_nb_core)
+		for (int j = 0; j < image_height; ++j)
+		{
+			for (int i = 0; i < image_width; ++i)
+			{
+				ray r = _camera.get_ray(i, j, s_i, s_j, aa_sampler, rnd);
+				_camera.ray_color(r, max_depth, _scene, rnd);
+			}
+		}
+
+		guiding->refine();
+	}
+
+	guiding->end_training();
+}
+
+void renderer::fill_radiance_cache(scene& _scene, camera& _camera, const renderParameters& _params, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const
+{
+	radiance_cache* cache = _scene.get_radiance_cache();
+	if (!cache)
+		return;
+
+	// estimates recorded before (path guiding training with a partial guide) are discarded
+	cache->invalidate();
+
+	const int image_height = _camera.getImageHeight();
+	const int image_width = _camera.getImageWidth();
+	const int sqrt_spp = std::max(_camera.getSqrtSpp(), 1);
+	const int max_depth = _camera.getMaxDepth();
+	const int passes = cache->get_config().fill_passes;
+
+	std::cout << "[INFO] Radiance cache filling (" << passes << " passes)" << std::endl;
+
+	for (int pass = 0; pass < passes; pass++)
+	{
+		// a different sub pixel stratum at each pass
+		const int s_i = pass % sqrt_spp;
+		const int s_j = (pass / sqrt_spp) % sqrt_spp;
+
+		#pragma omp parallel for schedule(dynamic, 4) num_threads(m_nb_core)
+		for (int j = 0; j < image_height; ++j)
+		{
+			for (int i = 0; i < image_width; ++i)
+			{
+				ray r = _camera.get_ray(i, j, s_i, s_j, aa_sampler, rnd);
+				_camera.ray_color(r, max_depth, _scene, rnd);
+			}
+		}
+	}
+
+	// the final render only reads the cache
+	cache->freeze();
+}
+
 void renderer::preview_line(const output& out, int j, std::vector<color> colors, int spp, bool gamma_correction)
 {
 	for (unsigned int n = 0; n < colors.size(); n++)
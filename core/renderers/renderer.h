@@ -13,6 +13,16 @@ public:
 
 	virtual void render(scene& _scene, camera& _camera, const renderParameters& _params, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const;
 
+	/// <summary>
+	/// Path guiding training passes (one sample per pixel each), the guiding distribution is refined after each pass
+	/// </summary>
+	void train_path_guiding(scene& _scene, camera& _camera, const renderParameters& _params, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const;
+
+	/// <summary>
+	/// Radiance cache pre passes (one sample per pixel each), the cache is frozen before the final render
+	/// </summary>
+	void fill_radiance_cache(scene& _scene, camera& _camera, const renderParameters& _params, std::shared_ptr<sampler> aa_sampler, randomizer& rnd) const;
+
 private:
 	
 
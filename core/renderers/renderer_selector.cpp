@@ -11,8 +11,12 @@
 #include "../renderers/cpu_multithread_renderer.h"
 #include "../renderers/gpu_cuda_renderer.h"
 
+#include "../textures/texture_cache.h"
 
-void renderer_selector::render(scene& _scene, const renderParameters& _params, randomizer& rnd)
+#include <algorithm>
+
+
+void renderer_selector::prepare(scene& _scene, const renderParameters& _params, randomizer& rnd)
 {
     std::cout << "[INFO] Init scene" << std::endl;
 
@@ -26,6 +30,11 @@ void renderer_selector::render(scene& _scene, const renderParameters& _params, r
     std::cout << "[INFO] Optimizing scene" << std::endl;
 
 	_scene.build_optimized_world(rnd);
+}
+
+void renderer_selector::render(scene& _scene, const renderParameters& _params, randomizer& rnd)
+{
+    std::shared_ptr<camera> cam = _scene.get_camera();
 
 
     // init default anti aliasing sampler
@@ -60,5 +69,49 @@ void renderer_selector::render(scene& _scene, const renderParameters& _params, r
 	}
 
     if (r)
+    {
+        // caustic photon map : shot once before rendering
+        if (_params.photon_count > 0)
+        {
+            photon_map::config cfg;
+            cfg.photon_count = _params.photon_count;
+            cfg.gather_radius = _params.photon_radius;
+
+            std::cout << "[INFO] Tracing caustic photons" << std::endl;
+
+            auto photons = std::make_shared<photon_map>(cfg);
+            photons->build(_scene, static_cast<unsigned int>(std::max(1, _params.nb_cpu_cores)));
+            _scene.set_photon_map(photons);
+        }
+
+        // radiance cache : deep diffuse bounces reuse the first bounce estimates
+        if (_params.radiance_cache_depth > 0)
+        {
+            radiance_cache::config cfg;
+            cfg.query_depth = _params.radiance_cache_depth;
+            cfg.max_relative_error = _params.radiance_cache_error;
+
+            _scene.set_radiance_cache(std::make_shared<radiance_cache>(_scene.get_world().bounding_box(), cfg));
+        }
+
+        // path guiding : learn where the light comes from before rendering
+        if (_params.guiding_passes > 0 && _params.integrator == 0)
+        {
+            path_guiding::config cfg;
+            cfg.training_passes = _params.guiding_passes;
+            cfg.memory_budget = static_cast<size_t>(_params.guiding_memory) * 1024 * 1024;
+            cfg.freeze = _params.guiding_freeze;
+
+            _scene.set_path_guiding(std::make_shared<path_guiding>(_scene.get_world().bounding_box(), cfg));
+            r->train_path_guiding(_scene, *cam, _params, aa, rnd);
+        }
+
+        // radiance cache : filled after the guiding training, with the final sampling, then frozen
+        r->fill_radiance_cache(_scene, *cam, _params, aa, rnd);
+
         r->render(_scene, *cam, _params, aa, rnd);
+
+        if (texture_cache::instance().enabled())
+            texture_cache::instance().print_stats();
+    }
 }
\ No newline at end of file
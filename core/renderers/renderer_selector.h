@@ -7,5 +7,10 @@ class renderer_selector
 {
 public:
 
+	/// <summary>
+	/// Camera setup and acceleration structure (BVH) of the scene, before render()
+	/// </summary>
+	void prepare(scene& _scene, const renderParameters& _params, randomizer& rnd);
+
 	void render(scene& _scene, const renderParameters& _params, randomizer& rnd);
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "splat_buffer.h"
+
+#include <cmath>
+
+splat_buffer::splat_buffer(int width, int height)
+    : m_width(width), m_height(height), m_data(static_cast<size_t>(width) * height * 3)
+{
+}
+
+void splat_buffer::add(int x, int y, const color& c)
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return;
+
+    // a single NaN would stain the pixel for good
+    if (!std::isfinite(c.r()) || !std::isfinite(c.g()) || !std::isfinite(c.b()))
+        return;
+
+    size_t index = (static_cast<size_t>(y) * m_width + x) * 3;
+    m_data[index + 0].fetch_add(static_cast<float>(c.r()), std::memory_order_relaxed);
+    m_data[index + 1].fetch_add(static_cast<float>(c.g()), std::memory_order_relaxed);
+    m_data[index + 2].fetch_add(static_cast<float>(c.b()), std::memory_order_relaxed);
+}
+
+color splat_buffer::get(int x, int y) const
+{
+    size_t index = (static_cast<size_t>(y) * m_width + x) * 3;
+    return color(
+        m_data[index + 0].load(std::memory_order_relaxed),
+        m_data[index + 1].load(std::memory_order_relaxed),
+        m_data[index + 2].load(std::memory_order_relaxed));
+}
+
+void splat_buffer::merge_into(std::vector<std::vector<color>>& image) const
+{
+    for (int y = 0; y < m_height && y < static_cast<int>(image.size()); y++)
+    {
+        for (int x = 0; x < m_width && x < static_cast<int>(image[y].size()); x++)
+        {
+            image[y][x] += get(x, y);
+        }
+    }
+}
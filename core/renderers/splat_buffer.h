@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../misc/color.h"
+
+#include <atomic>
+#include <vector>
+
+/// <summary>
+/// Framebuffer receiving the light tracing contributions, any thread can splat to any pixel
+/// Channels are atomic floats (a per thread copy of the image would cost too much memory on big renders)
+/// </summary>
+class splat_buffer
+{
+public:
+    splat_buffer(int width, int height);
+
+    /// <summary>
+    /// Add a contribution to pixel (x, y) (thread safe)
+    /// </summary>
+    void add(int x, int y, const color& c);
+
+    color get(int x, int y) const;
+
+    /// <summary>
+    /// Add the splats to the accumulated image (same sample count normalization)
+    /// </summary>
+    void merge_into(std::vector<std::vector<color>>& image) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<std::atomic<float>> m_data; // rgb
+};
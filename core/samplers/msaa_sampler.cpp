@@ -68,7 +68,7 @@ vector3 msaa_sampler::generate_samples(int s_i, int s_j, randomizer& rnd) const
         }
     }
     
-    return color_sum / static_cast<double>(m_spp);
+    return color_sum / static_cast<rreal>(m_spp);
 }
 
 vector3 msaa_sampler::pixel_sample_msaa(int s_i, int s_j, int sample_index, const double sample_offsets[][2]) const
@@ -78,8 +78,8 @@ vector3 msaa_sampler::pixel_sample_msaa(int s_i, int s_j, int sample_index, cons
         sample_index = 0; // Default to first sample if index is out of bounds
 
     // Calculate the sample position based on the predefined sample offsets
-    auto px = -0.5 + (s_i + sample_offsets[sample_index][0]) * m_recip_sqrt_spp;
-    auto py = -0.5 + (s_j + sample_offsets[sample_index][1]) * m_recip_sqrt_spp;
+    rreal px = -0.5 + (s_i + sample_offsets[sample_index][0]) * m_recip_sqrt_spp;
+    rreal py = -0.5 + (s_j + sample_offsets[sample_index][1]) * m_recip_sqrt_spp;
 
     return (px * m_pixel_delta_u) + (py * m_pixel_delta_v);
 }
\ No newline at end of file
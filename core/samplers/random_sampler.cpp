@@ -22,7 +22,7 @@ random_sampler::random_sampler(const vector3& pixel_delta_u, const vector3& pixe
 vector3 random_sampler::generate_samples(int s_i, int s_j, randomizer& rnd) const
 {
     // Generate random positions within the pixel
-    auto px = -0.5 + m_recip_sqrt_spp * (s_i + rnd.get_real(0.0, 1.0));
-    auto py = -0.5 + m_recip_sqrt_spp * (s_j + rnd.get_real(0.0, 1.0));
+    rreal px = -0.5 + m_recip_sqrt_spp * (s_i + rnd.get_real(0.0, 1.0));
+    rreal py = -0.5 + m_recip_sqrt_spp * (s_j + rnd.get_real(0.0, 1.0));
     return (px * m_pixel_delta_u) + (py * m_pixel_delta_v);
 }
\ No newline at end of file
@@ -33,11 +33,16 @@
 
 #include "../misc/bvh_node.h"
 #include "../misc/singleton.h"
+#include "../misc/timer.h"
 
 #include "../primitives/rotate.h"
 #include "../primitives/translate.h"
 #include "../primitives/scale.h"
 
+#include "../utilities/math_utils.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
 
 
 #include <utility>
@@ -76,7 +81,14 @@ perspective_camera scene_builder::getCamera() const
 
 hittable_list scene_builder::getSceneObjects() const
 {
-  return this->m_objects;
+  // mesh lights are not part of m_objects (the last object is the mesh for unnamed transforms)
+  hittable_list objects = this->m_objects;
+  for (const auto& emissive_mesh : this->m_sceneMeshLights.objects)
+  {
+      objects.add(emissive_mesh);
+  }
+
+  return objects;
 }
 
 scene::imageConfig scene_builder::getImageConfig() const
@@ -155,6 +167,11 @@ scene::cameraConfig scene_builder::getCameraConfig() const
     return this->m_cameraConfig;
 }
 
+double scene_builder::getMeshLoadTime() const
+{
+    return this->m_meshLoadTime;
+}
+
 scene_builder& scene_builder::setCameraConfig(const  scene::cameraConfig &config)
 {
   this->m_cameraConfig = config;
@@ -254,14 +271,14 @@ scene_builder& scene_builder::addImageTexture(const std::string& textureName, co
 
 scene_builder& scene_builder::addNormalTexture(const std::string& textureName, const std::string& filepath, double strength)
 {
-    auto normal_tex = std::make_shared<image_texture>(filepath);
+    auto normal_tex = std::make_shared<image_texture>(filepath, image_decode_options{ .normal_map = true });
     this->m_textures[textureName] = std::make_shared<normal_texture>(normal_tex, strength);
     return *this;
 }
 
 scene_builder& scene_builder::addDisplacementTexture(const std::string& textureName, const std::string& filepath, double strength)
 {
-    auto displace_tex = std::make_shared<image_texture>(filepath);
+    auto displace_tex = std::make_shared<image_texture>(filepath, image_decode_options{ .compression = texture_compression::none });
     this->m_textures[textureName] = std::make_shared<displacement_texture>(displace_tex, strength);
     return *this;
 }
@@ -299,6 +316,24 @@ scene_builder& scene_builder::addEmissiveTexture(const std::string& textureName,
     return *this;
 }
 
+scene_builder& scene_builder::bakeTexture(const std::string& textureName, const texture_bake_options& options)
+{
+    // the procedural texture is replaced by its rasterized texels for the materials created after
+    auto source = fetchTexture(textureName);
+    if (!source)
+        return *this;
+
+    std::string reason;
+    if (!baked_texture::can_bake(*source, options, reason))
+    {
+        std::cerr << "[WARN] Texture " << textureName << " is not baked (" << reason << "), the procedural texture is kept" << std::endl;
+        return *this;
+    }
+
+    this->m_textures[textureName] = std::make_shared<baked_texture>(source, options);
+    return *this;
+}
+
 scene_builder& scene_builder::addGlassMaterial(const std::string &materialName, double refraction)
 {
     this->m_materials[materialName] = std::make_shared<dielectric_material>(refraction);
@@ -772,7 +807,15 @@ scene_builder& scene_builder::addVolume(std::string name, std::string boundaryOb
 
 scene_builder& scene_builder::addObjMesh(std::string name, point3 pos, const std::string& filepath, const std::string& materialName, bool use_mtl, bool use_smoothing, const std::string& group, randomizer& rnd)
 {
-    auto mesh = scene_factory::createObjMesh(name, pos, filepath, fetchMaterial(materialName), use_mtl, use_smoothing, rnd);
+    std::vector<std::shared_ptr<light>> lights;
+
+    timer meshTimer;
+    meshTimer.start();
+
+    auto mesh = scene_factory::createObjMesh(name, pos, filepath, fetchMaterial(materialName), use_mtl, use_smoothing, lights, rnd);
+
+    meshTimer.stop();
+    m_meshLoadTime += meshTimer.elapsedMilliseconds();
 
     if (!mesh)
         return *this;
@@ -801,6 +844,19 @@ scene_builder& scene_builder::addObjMesh(std::string name, point3 pos, const std
         this->m_objects.add(mesh);
     }
 
+    // emissive triangles of the mesh, they follow the mesh transforms and join the scene with the mesh group
+    for (const auto& emissive_mesh : lights)
+    {
+        auto light_mesh = std::dynamic_pointer_cast<mesh_light>(emissive_mesh);
+        if (!light_mesh)
+            continue;
+
+        m_meshLights[mesh.get()].push_back(light_mesh);
+
+        if (group.empty())
+            m_sceneMeshLights.add(light_mesh);
+    }
+
 	return *this;
 }
 
@@ -808,9 +864,15 @@ scene_builder& scene_builder::addFbxMesh(std::string name, point3 pos, const std
 {
     std::vector<std::shared_ptr<camera>> cameras;
     std::vector<std::shared_ptr<light>> lights;
-    
+
+    timer meshTimer;
+    meshTimer.start();
+
     auto mesh = scene_factory::createFbxMesh(name, pos, filepath, use_cameras, use_lights, cameras, lights, m_cameraConfig.aspectRatio, rnd, m_materials, m_textures);
 
+    meshTimer.stop();
+    m_meshLoadTime += meshTimer.elapsedMilliseconds();
+
     if (!mesh)
         return *this;
 
@@ -886,6 +948,23 @@ scene_builder& scene_builder::addGroup(std::string name, bool& isUsed, randomize
             auto bvh_group = std::make_shared<bvh_node>(*group_objects, rnd, name);
             this->m_objects.add(bvh_group);
 
+            // mesh lights of the group now follow the group node
+            for (const auto& object : group_objects->objects)
+            {
+                auto it_lights = this->m_meshLights.find(object.get());
+                if (it_lights == this->m_meshLights.end())
+                    continue;
+
+                auto& followers = this->m_meshLights[bvh_group.get()];
+                for (const auto& emissive_mesh : it_lights->second)
+                {
+                    m_sceneMeshLights.add(emissive_mesh);
+                    followers.push_back(emissive_mesh);
+                }
+
+                this->m_meshLights.erase(it_lights);
+            }
+
             isUsed = true;
         }
     }
@@ -895,12 +974,16 @@ scene_builder& scene_builder::addGroup(std::string name, bool& isUsed, randomize
 
 scene_builder& scene_builder::translate(const vector3& vector, std::string name)
 {
+    const matrix4 transform = glm::translate(matrix4(1.0), vector);
+
     if (!name.empty())
     {
         auto& found = this->m_objects.get(name);
         if (found)
         {
-            found = std::make_shared<rt::translate>(found, vector);
+            auto wrapped = std::make_shared<rt::translate>(found, vector);
+            followMeshLights(found.get(), wrapped.get(), transform);
+            found = wrapped;
         }
         else
         {
@@ -910,7 +993,9 @@ scene_builder& scene_builder::translate(const vector3& vector, std::string name)
                 auto& found2 = group.second->get(name);
                 if (found2)
                 {
-                    found2 = std::make_shared<rt::translate>(found2, vector);
+                    auto wrapped = std::make_shared<rt::translate>(found2, vector);
+                    followMeshLights(found2.get(), wrapped.get(), transform);
+                    found2 = wrapped;
                     break;
                 }
             }
@@ -922,7 +1007,9 @@ scene_builder& scene_builder::translate(const vector3& vector, std::string name)
         std::string n = back->getName();
         if (n == name)
         {
-            this->m_objects.back() = std::make_shared<rt::translate>(back, vector);
+            auto wrapped = std::make_shared<rt::translate>(back, vector);
+            followMeshLights(back.get(), wrapped.get(), transform);
+            this->m_objects.back() = wrapped;
         }
     }
 
@@ -931,12 +1018,20 @@ scene_builder& scene_builder::translate(const vector3& vector, std::string name)
 
 scene_builder& scene_builder::rotate(const vector3& vector, std::string name)
 {
+    // same rotation order as rt::rotate
+    matrix4 transform(1.0);
+    transform = glm::rotate(transform, rreal(degrees_to_radians(vector.x)), vector3(1.0, 0.0, 0.0));
+    transform = glm::rotate(transform, rreal(degrees_to_radians(vector.y)), vector3(0.0, 1.0, 0.0));
+    transform = glm::rotate(transform, rreal(degrees_to_radians(vector.z)), vector3(0.0, 0.0, 1.0));
+
     if (!name.empty())
     {
         auto& found = this->m_objects.get(name);
         if (found)
         {
-            found = std::make_shared<rt::rotate>(found, vector);
+            auto wrapped = std::make_shared<rt::rotate>(found, vector);
+            followMeshLights(found.get(), wrapped.get(), transform);
+            found = wrapped;
         }
         else
         {
@@ -946,7 +1041,9 @@ scene_builder& scene_builder::rotate(const vector3& vector, std::string name)
                 auto& found2 = group.second->get(name);
                 if (found2)
                 {
-                    found2 = std::make_shared<rt::rotate>(found2, vector);
+                    auto wrapped = std::make_shared<rt::rotate>(found2, vector);
+                    followMeshLights(found2.get(), wrapped.get(), transform);
+                    found2 = wrapped;
                     break;
                 }
             }
@@ -958,7 +1055,9 @@ scene_builder& scene_builder::rotate(const vector3& vector, std::string name)
         std::string n = back->getName();
         if (n == name)
         {
-            this->m_objects.back() = std::make_shared<rt::rotate>(back, vector);
+            auto wrapped = std::make_shared<rt::rotate>(back, vector);
+            followMeshLights(back.get(), wrapped.get(), transform);
+            this->m_objects.back() = wrapped;
         }
     }
 
@@ -970,12 +1069,16 @@ scene_builder& scene_builder::scale(const vector3& vector, std::string name)
     /*this->m_objects.back() = std::make_shared<rt::scale>(this->m_objects.back(), vector);
     return *this;*/
 
+    const matrix4 transform = glm::scale(matrix4(1.0), vector);
+
     if (!name.empty())
     {
         auto& found = this->m_objects.get(name);
         if (found)
         {
-            found = std::make_shared<rt::scale>(found, vector);
+            auto wrapped = std::make_shared<rt::scale>(found, vector);
+            followMeshLights(found.get(), wrapped.get(), transform);
+            found = wrapped;
         }
         else
         {
@@ -985,7 +1088,9 @@ scene_builder& scene_builder::scale(const vector3& vector, std::string name)
                 auto& found2 = group.second->get(name);
                 if (found2)
                 {
-                    found2 = std::make_shared<rt::scale>(found2, vector);
+                    auto wrapped = std::make_shared<rt::scale>(found2, vector);
+                    followMeshLights(found2.get(), wrapped.get(), transform);
+                    found2 = wrapped;
                     break;
                 }
             }
@@ -997,13 +1102,33 @@ scene_builder& scene_builder::scale(const vector3& vector, std::string name)
         std::string n = back->getName();
         if (n == name)
         {
-            this->m_objects.back() = std::make_shared<rt::scale>(back, vector);
+            auto wrapped = std::make_shared<rt::scale>(back, vector);
+            followMeshLights(back.get(), wrapped.get(), transform);
+            this->m_objects.back() = wrapped;
         }
     }
 
     return *this;
 }
 
+void scene_builder::followMeshLights(const hittable* from, const hittable* to, const matrix4& transform)
+{
+    auto it = this->m_meshLights.find(from);
+    if (it == this->m_meshLights.end())
+        return;
+
+    std::vector<std::shared_ptr<mesh_light>> lights = std::move(it->second);
+    this->m_meshLights.erase(it);
+
+    for (const auto& emissive_mesh : lights)
+    {
+        emissive_mesh->transform(transform);
+    }
+
+    auto& followers = this->m_meshLights[to];
+    followers.insert(followers.end(), lights.begin(), lights.end());
+}
+
 std::shared_ptr<material> scene_builder::fetchMaterial(const std::string& name)
 {
     if (!name.empty())
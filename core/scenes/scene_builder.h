@@ -7,7 +7,9 @@
 #include "../utilities/uvmapping.h"
 #include "../misc/color.h"
 #include "../textures/texture.h"
+#include "../textures/baked_texture.h"
 #include "../cameras/perspective_camera.h"
+#include "../lights/mesh_light.h"
 #include <string>
 #include <map>
 
@@ -22,6 +24,7 @@ class scene_builder
         [[nodiscard]] hittable_list getSceneObjects() const;
         [[nodiscard]] scene::imageConfig getImageConfig() const;
         [[nodiscard]] scene::cameraConfig getCameraConfig() const;
+        [[nodiscard]] double getMeshLoadTime() const; // milliseconds spent reading the mesh files
 
         // Image
         scene_builder& setImageConfig(const  scene::imageConfig& config);
@@ -61,6 +64,7 @@ class scene_builder
         scene_builder& addDisplacementTexture(const std::string& textureName, const std::string& filepath, double strength);
         scene_builder& addAlphaTexture(const std::string& textureName, const std::string& filepath, bool double_sided);
         scene_builder& addEmissiveTexture(const std::string& textureName, const std::string& filepath, double strength);
+        scene_builder& bakeTexture(const std::string& textureName, const texture_bake_options& options);
 
         // Materials
         scene_builder& addGlassMaterial(const std::string& materialName, double refraction);
@@ -120,7 +124,18 @@ class scene_builder
 		std::map<std::string, std::shared_ptr<material>> m_materials{};
         std::map<std::string, std::shared_ptr<hittable_list>> m_groups{};
 		hittable_list m_objects{};
+        double m_meshLoadTime = 0.0;
+
+        // emissive triangles lights, keyed by the instance they follow (mesh, its transform wrappers, then its group node)
+        std::map<const hittable*, std::vector<std::shared_ptr<mesh_light>>> m_meshLights{};
+        // mesh lights of the meshes in the scene (grouped meshes only once their group is added)
+        hittable_list m_sceneMeshLights{};
 
         std::shared_ptr<material> fetchMaterial(const std::string& name);
         std::shared_ptr<texture> fetchTexture(const std::string& name);
+
+        /// <summary>
+        /// Mesh lights of an instance follow it when it is wrapped by a transform
+        /// </summary>
+        void followMeshLights(const hittable* from, const hittable* to, const matrix4& transform);
 };
\ No newline at end of file
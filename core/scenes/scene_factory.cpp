@@ -164,6 +164,7 @@ std::shared_ptr<hittable> scene_factory::createObjMesh(
 	const std::shared_ptr<material>& material,
 	const bool use_mtl,
     const bool use_smoothing,
+    std::vector<std::shared_ptr<light>>& lights,
     randomizer& rnd)
 {
     std::shared_ptr<hittable> mesh = nullptr;
@@ -172,7 +173,7 @@ std::shared_ptr<hittable> scene_factory::createObjMesh(
     
     if (obj_mesh_loader::load_model_from_file(filepath, data))
     {
-        mesh = obj_mesh_loader::convert_model_from_file(data, material, use_mtl, use_smoothing, rnd, name);
+        mesh = obj_mesh_loader::convert_model_from_file(data, material, use_mtl, use_smoothing, lights, rnd, name);
     }
 
     return mesh;
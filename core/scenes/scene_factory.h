@@ -33,7 +33,7 @@ public:
 
 	static std::shared_ptr<hittable> createVolume(const std::string name, const std::shared_ptr<hittable>& boundary, double density, const color& rgb);
 
-	static std::shared_ptr<hittable> createObjMesh(const std::string name, const point3& center, const std::string filepath, const std::shared_ptr<material>& material, const bool use_mtl, const bool use_smoothing, randomizer& rnd);
+	static std::shared_ptr<hittable> createObjMesh(const std::string name, const point3& center, const std::string filepath, const std::shared_ptr<material>& material, const bool use_mtl, const bool use_smoothing, std::vector<std::shared_ptr<light>>& lights, randomizer& rnd);
 
 	static std::shared_ptr<hittable> createFbxMesh(const std::string name, const point3& center, const std::string filepath, bool use_cameras, bool use_lights, std::vector<std::shared_ptr<camera>>& cameras, std::vector<std::shared_ptr<light>>& lights, double aspect_ratio, randomizer& rnd, const std::map<std::string, std::shared_ptr<material>>& scene_materials, const std::map<std::string, std::shared_ptr<texture>>& scene_textures);
 
@@ -310,6 +310,9 @@ void scene_loader::addNoiseTexture(const libconfig::Setting& textures, scene_bui
 				throw std::runtime_error("Noise texture name is empty");
 
 			builder.addNoiseTexture(name, scale);
+
+			if (texture.exists("bake"))
+				builder.bakeTexture(name, this->getBakeOptions(texture["bake"]));
 		}
 	}
 }
@@ -375,6 +378,9 @@ void scene_loader::addCheckerTexture(const libconfig::Setting& textures, scene_b
 				builder.addCheckerTexture(name, scale, oddTextureName, evenTextureName);
 			else
 				builder.addCheckerTexture(name, scale, oddColor, evenColor);
+
+			if (texture.exists("bake"))
+				builder.bakeTexture(name, this->getBakeOptions(texture["bake"]));
 		}
 	}
 }
@@ -409,6 +415,9 @@ void scene_loader::addGradientColorTexture(const libconfig::Setting& textures, s
 				throw std::runtime_error("Gradient color texture name is empty");
 
 			builder.addGradientColorTexture(name, color1, color2, !vertical, hsv);
+
+			if (texture.exists("bake"))
+				builder.bakeTexture(name, this->getBakeOptions(texture["bake"]));
 		}
 	}
 }
@@ -434,6 +443,9 @@ void scene_loader::addMarbleTexture(const libconfig::Setting& textures, scene_bu
 				throw std::runtime_error("Marble texture name is empty");
 
 			builder.addMarbleTexture(name, scale);
+
+			if (texture.exists("bake"))
+				builder.bakeTexture(name, this->getBakeOptions(texture["bake"]));
 		}
 	}
 }
@@ -1622,6 +1634,30 @@ color scene_loader::getColor(const libconfig::Setting& setting)
 	return color(r2, g2, b2);
 }
 
+texture_bake_options scene_loader::getBakeOptions(const libconfig::Setting& setting)
+{
+	texture_bake_options options{};
+
+	std::string space;
+	if (setting.exists("space"))
+		setting.lookupValue("space", space);
+	if (setting.exists("resolution"))
+		setting.lookupValue("resolution", options.resolution);
+	if (setting.exists("min"))
+		options.min = this->getPoint(setting["min"]);
+	if (setting.exists("max"))
+		options.max = this->getPoint(setting["max"]);
+	if (setting.exists("persist"))
+		setting.lookupValue("persist", options.persist);
+
+	if (space == "volume")
+		options.space = texture_bake_options::bake_space::volume;
+	else if (!space.empty() && space != "uv")
+		throw std::runtime_error("Unknown texture bake space " + space);
+
+	return options;
+}
+
 uvmapping scene_loader::getUVmapping(const libconfig::Setting& setting)
 {
 	uvmapping uv{};
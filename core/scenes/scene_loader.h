@@ -37,6 +37,7 @@ private:
   vector3 getVector(const libconfig::Setting& setting);
   color getColor(const libconfig::Setting& setting);
   uvmapping getUVmapping(const libconfig::Setting& setting);
+  texture_bake_options getBakeOptions(const libconfig::Setting& setting);
   rt::transform getTransform(const libconfig::Setting& setting);
 
 
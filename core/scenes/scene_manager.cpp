@@ -69,6 +69,7 @@ scene scene_manager::load_scene(const renderParameters& params, randomizer& rnd)
     // get data from .scene file
     scene_loader config(params.sceneName);
     scene_builder scene = config.loadSceneFromFile(rnd);
+    m_mesh_load_time = scene.getMeshLoadTime();
     scene::imageConfig imageCfg = scene.getImageConfig();
     scene::cameraConfig cameraCfg = scene.getCameraConfig();
     world.set(scene.getSceneObjects());
@@ -131,4 +132,9 @@ scene scene_manager::load_scene(const renderParameters& params, randomizer& rnd)
     world.set_camera(cam);
 
     return world;
+}
+
+double scene_manager::mesh_load_time() const
+{
+    return m_mesh_load_time;
 }
\ No newline at end of file
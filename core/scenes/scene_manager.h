@@ -7,4 +7,12 @@ class scene_manager
 {
 public:
     scene load_scene(const renderParameters& params, randomizer& rnd);
+
+    /// <summary>
+    /// Milliseconds spent reading the mesh files during the last load
+    /// </summary>
+    double mesh_load_time() const;
+
+private:
+    double m_mesh_load_time = 0.0;
 };
\ No newline at end of file
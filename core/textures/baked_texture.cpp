@@ -0,0 +1,267 @@
+#include "baked_texture.h"
+
+#include "../utilities/half.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    constexpr char baked_magic[4] = { 'C', 'T', 'B', '1' };
+
+    template<typename T>
+    void write_value(std::ofstream& out, T value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool read_value(std::ifstream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+baked_texture::baked_texture(std::shared_ptr<texture> source, const texture_bake_options& options)
+    : m_source(source), m_options(options)
+{
+    if (m_options.resolution <= 0)
+        m_options.resolution = (m_options.space == texture_bake_options::bake_space::volume) ? 128 : 512;
+
+    m_options.resolution = std::max(m_options.resolution, 2);
+
+    // the cache file name changes with the texture parameters and the bake options
+    std::string key = m_source->bake_key();
+    std::filesystem::path cache_path;
+
+    if (m_options.persist && !key.empty())
+    {
+        std::ostringstream options_key;
+        options_key.precision(17);
+        options_key << key << "|" << (m_options.space == texture_bake_options::bake_space::volume ? "volume" : "uv") << "|" << m_options.resolution;
+        if (m_options.space == texture_bake_options::bake_space::volume)
+            options_key << "|" << m_options.min.x << "," << m_options.min.y << "," << m_options.min.z << "|" << m_options.max.x << "," << m_options.max.y << "," << m_options.max.z;
+
+        std::error_code ec;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(ec) / "cortex_bakes";
+        std::filesystem::create_directories(directory, ec);
+
+        cache_path = directory / ("baked_" + std::to_string(std::hash<std::string>{}(options_key.str())) + ".ctb");
+
+        if (load(cache_path.string()))
+        {
+            std::cout << "[INFO] Baked texture read from " << cache_path.string() << std::endl;
+            return;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    bake();
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[INFO] Texture baked (" << m_options.resolution << (m_options.space == texture_bake_options::bake_space::volume ? "^3 volume" : "^2 uv")
+        << ") in " << static_cast<int>(elapsed) << " ms" << std::endl;
+
+    if (!cache_path.empty() && !save(cache_path.string()))
+        std::cerr << "[WARN] Could not write baked texture file '" << cache_path.string() << "'" << std::endl;
+}
+
+bool baked_texture::can_bake(const texture& source, const texture_bake_options& options, std::string& reason)
+{
+    if (source.bake_key().empty())
+    {
+        reason = "not a procedural texture";
+        return false;
+    }
+
+    // a uv bake has no position to give, a volume bake has no uv
+    const int inputs = source.lookup_inputs();
+    const bool volume = options.space == texture_bake_options::bake_space::volume;
+
+    if (volume && (inputs & uv_input))
+    {
+        reason = "depends on the uv coordinates, can't be baked in a volume";
+        return false;
+    }
+
+    if (!volume && (inputs & position_input))
+    {
+        reason = "depends on the hit point, can't be baked in uv";
+        return false;
+    }
+
+    return true;
+}
+
+color baked_texture::value(double u, double v, const point3& p) const
+{
+    const int n = m_options.resolution;
+
+    // texel centers are at half integer coordinates
+    auto split = [n](double t, int& i0, double& f)
+    {
+        double x = t * n - 0.5;
+        i0 = static_cast<int>(std::floor(x));
+        f = x - i0;
+    };
+
+    if (m_options.space == texture_bake_options::bake_space::uv)
+    {
+        int x0, y0;
+        double fx, fy;
+        split(std::clamp(u, 0.0, 1.0), x0, fx);
+        split(std::clamp(v, 0.0, 1.0), y0, fy);
+
+        return (1.0 - fx) * (1.0 - fy) * texel(x0, y0, 0) + fx * (1.0 - fy) * texel(x0 + 1, y0, 0)
+            + (1.0 - fx) * fy * texel(x0, y0 + 1, 0) + fx * fy * texel(x0 + 1, y0 + 1, 0);
+    }
+
+    const point3& lo = m_options.min;
+    const point3& hi = m_options.max;
+
+    if (p.x < lo.x || p.y < lo.y || p.z < lo.z || p.x > hi.x || p.y > hi.y || p.z > hi.z)
+        return m_source->value(u, v, p);
+
+    int x0, y0, z0;
+    double fx, fy, fz;
+    split((p.x - lo.x) / (hi.x - lo.x), x0, fx);
+    split((p.y - lo.y) / (hi.y - lo.y), y0, fy);
+    split((p.z - lo.z) / (hi.z - lo.z), z0, fz);
+
+    color c0 = (1.0 - fx) * (1.0 - fy) * texel(x0, y0, z0) + fx * (1.0 - fy) * texel(x0 + 1, y0, z0)
+        + (1.0 - fx) * fy * texel(x0, y0 + 1, z0) + fx * fy * texel(x0 + 1, y0 + 1, z0);
+    color c1 = (1.0 - fx) * (1.0 - fy) * texel(x0, y0, z0 + 1) + fx * (1.0 - fy) * texel(x0 + 1, y0, z0 + 1)
+        + (1.0 - fx) * fy * texel(x0, y0 + 1, z0 + 1) + fx * fy * texel(x0 + 1, y0 + 1, z0 + 1);
+
+    return (1.0 - fz) * c0 + fz * c1;
+}
+
+std::string baked_texture::bake_key() const
+{
+    return m_source->bake_key();
+}
+
+int baked_texture::lookup_inputs() const
+{
+    return m_source->lookup_inputs();
+}
+
+void baked_texture::bake()
+{
+    const int n = m_options.resolution;
+    const bool volume = m_options.space == texture_bake_options::bake_space::volume;
+    const int slices = volume ? n : 1;
+
+    m_texels.resize(static_cast<size_t>(n) * n * slices * 3);
+
+    const point3& lo = m_options.min;
+    const vector3 extent = m_options.max - m_options.min;
+
+    // one row per iteration, the procedural textures are read only
+    #pragma omp parallel for schedule(dynamic)
+    for (int row = 0; row < n * slices; row++)
+    {
+        const int y = row % n;
+        const int z = row / n;
+
+        for (int x = 0; x < n; x++)
+        {
+            const double tx = (x + 0.5) / n;
+            const double ty = (y + 0.5) / n;
+            const double tz = (z + 0.5) / n;
+
+            color c = volume
+                ? m_source->value(0.0, 0.0, point3(lo.x + tx * extent.x, lo.y + ty * extent.y, lo.z + tz * extent.z))
+                : m_source->value(tx, ty, point3(0, 0, 0));
+
+            // half floats top at 65504
+            uint16_t* t = &m_texels[(static_cast<size_t>(row) * n + x) * 3];
+            t[0] = float_to_half(static_cast<float>(std::clamp<double>(c.r(), 0.0, 65504.0)));
+            t[1] = float_to_half(static_cast<float>(std::clamp<double>(c.g(), 0.0, 65504.0)));
+            t[2] = float_to_half(static_cast<float>(std::clamp<double>(c.b(), 0.0, 65504.0)));
+        }
+    }
+}
+
+bool baked_texture::load(const std::string& filepath)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if (!in)
+        return false;
+
+    char magic[4] = {};
+    int32_t space = 0, resolution = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, baked_magic, sizeof(magic)) != 0)
+        return false;
+
+    if (!read_value(in, space) || !read_value(in, resolution) || space != static_cast<int32_t>(m_options.space) || resolution != m_options.resolution)
+        return false;
+
+    const int slices = (m_options.space == texture_bake_options::bake_space::volume) ? resolution : 1;
+    std::vector<uint16_t> texels(static_cast<size_t>(resolution) * resolution * slices * 3);
+
+    if (!in.read(reinterpret_cast<char*>(texels.data()), static_cast<std::streamsize>(texels.size() * sizeof(uint16_t))))
+        return false;
+
+    m_texels = std::move(texels);
+    return true;
+}
+
+bool baked_texture::save(const std::string& filepath) const
+{
+    // written next to the final file then renamed, a concurrent render never reads a partial file
+    // (the temporary name is unique, two renders baking the same texture don't write the same file)
+    static std::atomic<uint64_t> next_id{ 0 };
+    std::string temp_path = filepath + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" + std::to_string(next_id++);
+
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(baked_magic, sizeof(baked_magic));
+        write_value<int32_t>(out, static_cast<int32_t>(m_options.space));
+        write_value<int32_t>(out, m_options.resolution);
+        out.write(reinterpret_cast<const char*>(m_texels.data()), static_cast<std::streamsize>(m_texels.size() * sizeof(uint16_t)));
+
+        if (!out)
+        {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, filepath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+color baked_texture::texel(int x, int y, int z) const
+{
+    const int n = m_options.resolution;
+
+    x = std::clamp(x, 0, n - 1);
+    y = std::clamp(y, 0, n - 1);
+    z = std::clamp(z, 0, (m_options.space == texture_bake_options::bake_space::volume) ? n - 1 : 0);
+
+    const uint16_t* t = &m_texels[((static_cast<size_t>(z) * n + y) * n + x) * 3];
+    return color(half_to_float(t[0]), half_to_float(t[1]), half_to_float(t[2]));
+}
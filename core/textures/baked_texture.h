@@ -0,0 +1,58 @@
+#pragma once
+
+#include "texture.h"
+#include "../misc/color.h"
+#include "../utilities/types.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// How a procedural texture is rasterized
+/// uv : a resolution x resolution map over [0,1]^2, for textures depending on the uv coordinates only (gradient)
+/// volume : a resolution^3 grid over a world space box, for textures depending on the hit point only (noise, marble, checker)
+/// </summary>
+struct texture_bake_options
+{
+    enum class bake_space { uv, volume };
+
+    bake_space space = bake_space::uv;
+    int resolution = 0; // texels per side (0 : 512 in uv, 128 in volume)
+    point3 min{}; // volume bounds
+    point3 max{};
+    bool persist = true; // keep the baked texels on the disk (only textures with a bake key)
+};
+
+/// <summary>
+/// Procedural texture rasterized at scene load, sampled like an image texture (bilinear in uv, trilinear in a volume)
+/// The texels are computed in parallel and cached in the temp directory, named after the texture parameters and the bake options
+/// Volume lookups outside of the baked box fall back to the procedural texture
+/// </summary>
+class baked_texture : public texture
+{
+public:
+    baked_texture(std::shared_ptr<texture> source, const texture_bake_options& options);
+
+    /// <summary>
+    /// A texture can be baked when it has a bake key and only depends on the coordinates of the bake space (uv or position)
+    /// </summary>
+    static bool can_bake(const texture& source, const texture_bake_options& options, std::string& reason);
+
+    color value(double u, double v, const point3& p) const override;
+
+    std::string bake_key() const override;
+    int lookup_inputs() const override;
+
+private:
+    std::shared_ptr<texture> m_source;
+    texture_bake_options m_options;
+    std::vector<uint16_t> m_texels; // rgb half floats, x fastest then y (then z)
+
+    void bake();
+    bool load(const std::string& filepath);
+    bool save(const std::string& filepath) const;
+
+    color texel(int x, int y, int z) const;
+};
@@ -10,6 +10,33 @@ bump_texture::bump_texture()
 	
 bump_texture::bump_texture(std::shared_ptr<texture> bump, double strength) : m_bump(bump), m_strength(strength * 10.0)
 {
+    std::shared_ptr<image_texture> imageTex = std::dynamic_pointer_cast<image_texture>(m_bump);
+    if (imageTex)
+    {
+        // built on the loading threads, its image is still being decoded (requested before, no deadlock)
+        auto promise = std::make_shared<std::promise<std::shared_ptr<const derivative_map>>>();
+        m_pending_derivatives = promise->get_future().share();
+
+        texture_registry::instance().run_async([imageTex, promise]()
+        {
+            std::shared_ptr<const derivative_map> derivatives = nullptr;
+            if (imageTex->getWidth() > 0 && imageTex->getHeight() > 0)
+                derivatives = std::make_shared<derivative_map>(*imageTex, imageTex->getWidth(), imageTex->getHeight());
+
+            promise->set_value(derivatives);
+        });
+    }
+}
+
+const derivative_map* bump_texture::derivatives() const
+{
+    std::call_once(m_derivatives_built, [this]()
+    {
+        if (m_pending_derivatives.valid())
+            m_derivatives = m_pending_derivatives.get();
+    });
+
+    return m_derivatives.get();
 }
 
 color bump_texture::value(double u, double v, const point3& p) const
@@ -17,8 +44,16 @@ color bump_texture::value(double u, double v, const point3& p) const
     return m_bump->value(u, v, p);
 }
 
-vector3 bump_texture::perturb_normal(const vector3& normal, double u, double v, const vector3& p) const
+vector3 bump_texture::perturb_normal(const vector3& normal, double u, double v, const vector3& p, rreal footprint) const
 {
+    if (const derivative_map* derivatives = this->derivatives())
+    {
+        double du, dv;
+        derivatives->slopes(u, v, footprint, du, dv);
+
+        return convert_to_world_space(glm::normalize(vector3(m_strength * du, m_strength * dv, 1.0)), normal);
+    }
+
     double m_bump_width = 0.0; // doesn't change anything ?
     double m_bump_height = 0.0; // doesn't change anything ?
 
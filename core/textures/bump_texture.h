@@ -3,9 +3,16 @@
 #include "texture.h"
 #include "../misc/color.h"
 #include "../utilities/types.h"
+#include "derivative_map.h"
+
+#include <future>
+#include <memory>
+#include <mutex>
 
 /// <summary>
 /// Bump texture
+/// Image height maps are converted to a derivative map in the background (after their decode), a perturbation is then a single slopes lookup
+/// Other height textures are differentiated at every lookup (4 samples)
 /// </summary>
 class bump_texture : public texture
 {
@@ -15,11 +22,16 @@ public:
 
 	color value(double u, double v, const point3& p) const;
 
-	vector3 perturb_normal(const vector3& normal, double u, double v, const vector3& p) const;
+	vector3 perturb_normal(const vector3& normal, double u, double v, const vector3& p, rreal footprint = 0) const;
 	vector3 convert_to_world_space(const vector3& tangentSpaceNormal, const vector3& originalNormal) const;
 	void compute_tangent_space(const vector3& normal, vector3& tangent, vector3& bitangent) const;
 
 private:
 	std::shared_ptr<texture> m_bump = nullptr;
 	double m_strength = 0.5; // normalized and can be between 0.0 and 1.0 (0.5 is usually good)
+	std::shared_future<std::shared_ptr<const derivative_map>> m_pending_derivatives; // image height maps only
+	mutable std::shared_ptr<const derivative_map> m_derivatives = nullptr;
+	mutable std::once_flag m_derivatives_built;
+
+	const derivative_map* derivatives() const;
 };
\ No newline at end of file
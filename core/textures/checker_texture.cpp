@@ -2,6 +2,8 @@
 
 #include "solid_color_texture.h"
 
+#include <sstream>
+
 checker_texture::checker_texture(double _scale, std::shared_ptr<texture> _even, std::shared_ptr<texture> _odd)
     : m_scale(_scale), m_inv_scale(1.0 / _scale), m_even(_even), m_odd(_odd)
 {
@@ -21,4 +23,24 @@ color checker_texture::value(double u, double v, const point3& p) const
     bool isEven = (xInteger + yInteger + zInteger) % 2 == 0;
 
     return isEven ? m_even->value(u, v, p) : m_odd->value(u, v, p);
+}
+
+std::string checker_texture::bake_key() const
+{
+    // only when both nested textures can be identified
+    std::string even = m_even->bake_key();
+    std::string odd = m_odd->bake_key();
+    if (even.empty() || odd.empty())
+        return {};
+
+    std::ostringstream key;
+    key.precision(17);
+    key << "checker|" << m_scale << "|(" << even << ")|(" << odd << ")";
+    return key.str();
+}
+
+int checker_texture::lookup_inputs() const
+{
+    // the cells depend on the position, the nested textures may add the uv
+    return position_input | m_even->lookup_inputs() | m_odd->lookup_inputs();
 }
\ No newline at end of file
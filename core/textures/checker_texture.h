@@ -15,6 +15,9 @@ public:
 
     color value(double u, double v, const point3& p) const override;
 
+    std::string bake_key() const override;
+    int lookup_inputs() const override;
+
 private:
     double m_scale = 0.0;
     double m_inv_scale = 0.0;
@@ -0,0 +1,162 @@
+#include "derivative_map.h"
+#include "../utilities/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+derivative_map::derivative_map(const texture& heights, int width, int height)
+{
+    const int w = std::max(width, 1);
+    const int h = std::max(height, 1);
+
+    // heights at the texel centers, v is flipped like the image textures do (row 0 is v = 1)
+    std::vector<float> samples(static_cast<size_t>(w) * h);
+
+    #pragma omp parallel for schedule(static) num_threads(thread_pool::region_threads())
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+            samples[static_cast<size_t>(y) * w + x] = static_cast<float>(heights.value((x + 0.5) / w, 1.0 - (y + 0.5) / h, point3(0, 0, 0)).r());
+    }
+
+    // central differences with clamped neighbors, +v is the row above
+    std::vector<float> slopes(static_cast<size_t>(w) * h * 2);
+    float steepest = 0.0f;
+
+    #pragma omp parallel for schedule(static) reduction(max:steepest) num_threads(thread_pool::region_threads())
+    for (int y = 0; y < h; y++)
+    {
+        const float* up = &samples[static_cast<size_t>(std::max(y - 1, 0)) * w];
+        const float* row = &samples[static_cast<size_t>(y) * w];
+        const float* down = &samples[static_cast<size_t>(std::min(y + 1, h - 1)) * w];
+
+        for (int x = 0; x < w; x++)
+        {
+            float du = row[std::min(x + 1, w - 1)] - row[std::max(x - 1, 0)];
+            float dv = up[x] - down[x];
+
+            slopes[(static_cast<size_t>(y) * w + x) * 2 + 0] = du;
+            slopes[(static_cast<size_t>(y) * w + x) * 2 + 1] = dv;
+            steepest = std::max(steepest, std::max(std::fabs(du), std::fabs(dv)));
+        }
+    }
+
+    m_scale = (steepest > 0.0f) ? steepest / 32767.0f : 1.0f;
+
+    level base;
+    base.width = w;
+    base.height = h;
+    base.texels.resize(slopes.size());
+
+    for (size_t i = 0; i < slopes.size(); i++)
+        base.texels[i] = static_cast<int16_t>(std::lround(slopes[i] / m_scale));
+
+    m_levels.push_back(std::move(base));
+
+    // 2x2 box filter of the slopes (averages stay in the range of the full resolution), the last row/column of odd sizes is clamped
+    while (m_levels.back().width > 1 || m_levels.back().height > 1)
+    {
+        const level& src = m_levels.back();
+
+        level next;
+        next.width = std::max(1, src.width / 2);
+        next.height = std::max(1, src.height / 2);
+        next.texels.resize(static_cast<size_t>(next.width) * next.height * 2);
+
+        const int sw = src.width;
+        const int sh = src.height;
+
+        #pragma omp parallel for schedule(static) num_threads(thread_pool::region_threads()) if (next.width * next.height > 16384)
+        for (int y = 0; y < next.height; y++)
+        {
+            int y0 = std::min(2 * y, sh - 1);
+            int y1 = std::min(2 * y + 1, sh - 1);
+
+            for (int x = 0; x < next.width; x++)
+            {
+                int x0 = std::min(2 * x, sw - 1);
+                int x1 = std::min(2 * x + 1, sw - 1);
+
+                for (int c = 0; c < 2; c++)
+                {
+                    int sum = src.texels[(static_cast<size_t>(y0) * sw + x0) * 2 + c] + src.texels[(static_cast<size_t>(y0) * sw + x1) * 2 + c]
+                        + src.texels[(static_cast<size_t>(y1) * sw + x0) * 2 + c] + src.texels[(static_cast<size_t>(y1) * sw + x1) * 2 + c];
+
+                    next.texels[(static_cast<size_t>(y) * next.width + x) * 2 + c] = static_cast<int16_t>(sum >= 0 ? (sum + 2) / 4 : (sum - 2) / 4);
+                }
+            }
+        }
+
+        m_levels.push_back(std::move(next));
+    }
+}
+
+int derivative_map::width() const
+{
+    return m_levels.front().width;
+}
+
+int derivative_map::height() const
+{
+    return m_levels.front().height;
+}
+
+void derivative_map::slopes(double u, double v, rreal footprint, double& du, double& dv) const
+{
+    u = std::clamp(u, 0.0, 1.0);
+    v = 1.0 - std::clamp(v, 0.0, 1.0);
+
+    // level whose texels are as wide as the footprint (same selection as the image textures)
+    const int last_level = static_cast<int>(m_levels.size()) - 1;
+    const double lod = (footprint > 0) ? std::log2(footprint * std::max(width(), height())) : 0.0;
+
+    if (lod <= 0.0 || last_level == 0)
+    {
+        bilinear(u, v, 0, du, dv);
+        return;
+    }
+
+    if (lod >= last_level)
+    {
+        bilinear(u, v, last_level, du, dv);
+        return;
+    }
+
+    const int level_index = static_cast<int>(lod);
+    const double t = lod - level_index;
+
+    double du0, dv0, du1, dv1;
+    bilinear(u, v, level_index, du0, dv0);
+    bilinear(u, v, level_index + 1, du1, dv1);
+
+    du = (1.0 - t) * du0 + t * du1;
+    dv = (1.0 - t) * dv0 + t * dv1;
+}
+
+void derivative_map::bilinear(double u, double v, int level_index, double& du, double& dv) const
+{
+    const level& l = m_levels[level_index];
+
+    // texel centers are at half integer coordinates
+    const double x = u * l.width - 0.5;
+    const double y = v * l.height - 0.5;
+
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    const double fx = x - x0;
+    const double fy = y - y0;
+
+    // the 4 texels around (u, v), both slopes of a texel are next to each other
+    const int xa = std::clamp(x0, 0, l.width - 1), xb = std::clamp(x0 + 1, 0, l.width - 1);
+    const int ya = std::clamp(y0, 0, l.height - 1), yb = std::clamp(y0 + 1, 0, l.height - 1);
+
+    const int16_t* t00 = &l.texels[(static_cast<size_t>(ya) * l.width + xa) * 2];
+    const int16_t* t10 = &l.texels[(static_cast<size_t>(ya) * l.width + xb) * 2];
+    const int16_t* t01 = &l.texels[(static_cast<size_t>(yb) * l.width + xa) * 2];
+    const int16_t* t11 = &l.texels[(static_cast<size_t>(yb) * l.width + xb) * 2];
+
+    const double w00 = (1.0 - fx) * (1.0 - fy), w10 = fx * (1.0 - fy), w01 = (1.0 - fx) * fy, w11 = fx * fy;
+
+    du = m_scale * (w00 * t00[0] + w10 * t10[0] + w01 * t01[0] + w11 * t11[0]);
+    dv = m_scale * (w00 * t00[1] + w10 * t10[1] + w01 * t01[1] + w11 * t11[1]);
+}
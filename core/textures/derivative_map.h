@@ -0,0 +1,42 @@
+#pragma once
+
+#include "texture.h"
+#include "../utilities/types.h"
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Height map converted to its slopes (dU, dV) at load time, so that bump mapping is a single filtered fetch
+/// Slopes are the central differences of the heights between the texels on each side, in height units per texel of the full resolution map
+/// Stored as 16 bits fixed point (scaled by the steepest slope of the map) with a MIP pyramid (averaged slopes), lookups are bilinear, trilinear when a footprint is given
+/// </summary>
+class derivative_map
+{
+public:
+    /// <summary>
+    /// Build from the red channel of a texture sampled at the texel centers of a width x height grid (rows computed in parallel)
+    /// </summary>
+    derivative_map(const texture& heights, int width, int height);
+
+    int width() const;
+    int height() const;
+
+    /// <summary>
+    /// Slopes at (u, v) : du towards +u, dv towards +v
+    /// </summary>
+    void slopes(double u, double v, rreal footprint, double& du, double& dv) const;
+
+private:
+    struct level
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<int16_t> texels; // du dv pairs, rows top to bottom like the images
+    };
+
+    std::vector<level> m_levels;
+    float m_scale = 1.0f; // slope of a texel value of 1
+
+    void bilinear(double u, double v, int level_index, double& du, double& dv) const;
+};
@@ -22,6 +22,9 @@ displacement_texture::displacement_texture(std::shared_ptr<texture> t, double st
 color displacement_texture::value(double u, double v, const point3& p) const
 {
     double value = 0.0;
+
+    if (m_data.empty())
+        return color(0, 0, 0);
     
     // Clamp u and v to [0, 1]
     u = std::fmod(u, 1.0f);
@@ -4,6 +4,8 @@
 #include "texture.h"
 #include "../misc/color.h"
 
+#include <vector>
+
 /// <summary>
 /// Displacement texture
 /// https://stackoverflow.com/questions/4476669/ray-tracing-a-sphere-with-displacement-mapping
@@ -27,5 +29,5 @@ private:
     int m_height = 0;
     int m_channels = 3;
 
-    float* m_data = nullptr;
+    std::vector<float> m_data;
 };
\ No newline at end of file
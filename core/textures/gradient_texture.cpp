@@ -1,5 +1,7 @@
 #include "gradient_texture.h"
 
+#include <sstream>
+
 gradient_texture::gradient_texture()
 {
 
@@ -17,4 +19,19 @@ color gradient_texture::value(double u, double v, const point3& p) const
     color final_color = aligned_v ? gamma_color1 * (1 - u) + u * gamma_color2 : gamma_color1 * (1 - v) + v * gamma_color2;
 
     return (hsv ? color::HSVtoRGB(final_color) : final_color);
+}
+
+std::string gradient_texture::bake_key() const
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << "gradient|" << gamma_color1.r() << "," << gamma_color1.g() << "," << gamma_color1.b()
+        << "|" << gamma_color2.r() << "," << gamma_color2.g() << "," << gamma_color2.b()
+        << (aligned_v ? "|u" : "|v") << (hsv ? "|hsv" : "|rgb");
+    return key.str();
+}
+
+int gradient_texture::lookup_inputs() const
+{
+    return uv_input;
 }
\ No newline at end of file
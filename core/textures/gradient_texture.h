@@ -13,6 +13,9 @@ public:
 
     virtual color value(double u, double v, const point3& p) const;
 
+    std::string bake_key() const override;
+    int lookup_inputs() const override;
+
 private:
     color gamma_color1{}, gamma_color2{};
     bool aligned_v = false;
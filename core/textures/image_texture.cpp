@@ -1,50 +1,169 @@
 #include "image_texture.h"
 
+#include "texture_cache.h"
 #include "../utilities/interval.h"
 
-image_texture::image_texture(const std::string filepath) : m_image(filepath.c_str())
+#include <algorithm>
+#include <cmath>
+
+image_texture::image_texture(const std::string filepath, const image_decode_options& options)
+    : m_filepath(filepath), m_options(options)
 {
+    // out of core : only the tiles actually sampled are read, when the render needs them
+    // the tile conversion decodes the whole image once, images whose MIP pyramid fits the cache budget are simply decoded
+    const texture_cache& cache = texture_cache::instance();
+    int width = 0, height = 0;
+    if (cache.enabled() && !bitmap_image::is_hdr_file(filepath) && bitmap_image::read_size(filepath, width, height)
+        && static_cast<uint64_t>(width) * height * 4 > cache.budget())
+        m_tiled = tiled_image::open(filepath);
+
+    if (!m_tiled)
+        m_pending = texture_registry::instance().load_async(filepath, options);
 }
 
 
 color image_texture::value(double u, double v, const point3& p) const
 {
+    // image() waits for the decode when it is still running on the texture registry pool, resolved once per lookup
+    const bitmap_image* img = m_tiled ? nullptr : &image();
+
     // If we have no texture data, then return solid cyan as a debugging aid.
-    if (m_image.height() <= 0) return color(0, 1, 1);
+    if (level_height(img, 0) <= 0) return color(0, 1, 1);
+
+    return nearest(img, u, v);
+}
+
+color image_texture::value(double u, double v, const point3& p, rreal footprint) const
+{
+    const bitmap_image* img = m_tiled ? nullptr : &image();
+
+    if (level_height(img, 0) <= 0) return color(0, 1, 1);
+
+    // no footprint (first hit without ray differentials) : unfiltered lookup
+    if (footprint <= 0)
+        return nearest(img, u, v);
+
+    u = interval(0, 1).clamp(u);
+    v = 1.0 - interval(0, 1).clamp(v);
+
+    // level whose texels are as wide as the footprint
+    int last_level = levels(img) - 1;
+    double lod = std::log2(footprint * std::max(level_width(img, 0), level_height(img, 0)));
+
+    if (lod <= 0.0 || last_level == 0)
+        return bilinear(img, u, v, 0);
 
+    if (lod >= last_level)
+        return bilinear(img, u, v, last_level);
+
+    int level = static_cast<int>(lod);
+    double t = lod - level;
+
+    return (1.0 - t) * bilinear(img, u, v, level) + t * bilinear(img, u, v, level + 1);
+}
+
+color image_texture::nearest(const bitmap_image* img, double u, double v) const
+{
     // Clamp input texture coordinates to [0,1] x [1,0]
     u = interval(0, 1).clamp(u);
     v = 1.0 - interval(0, 1).clamp(v);  // Flip V to image coordinates
 
-    auto i = static_cast<int>(u * m_image.width());
-    auto j = static_cast<int>(v * m_image.height());
-    
-    double color_scale = 1.0 / 255.0;
-    const unsigned char* pixel = m_image.pixel_data(i, j);
+    auto i = static_cast<int>(u * level_width(img, 0));
+    auto j = static_cast<int>(v * level_height(img, 0));
+
+    return texel(img, i, j, 0);
+}
+
+color image_texture::bilinear(const bitmap_image* img, double u, double v, int level) const
+{
+    // texel centers are at half integer coordinates
+    double x = u * level_width(img, level) - 0.5;
+    double y = v * level_height(img, level) - 0.5;
+
+    int x0 = static_cast<int>(std::floor(x));
+    int y0 = static_cast<int>(std::floor(y));
+    double fx = x - x0;
+    double fy = y - y0;
+
+    return (1.0 - fx) * (1.0 - fy) * texel(img, x0, y0, level) + fx * (1.0 - fy) * texel(img, x0 + 1, y0, level)
+        + (1.0 - fx) * fy * texel(img, x0, y0 + 1, level) + fx * fy * texel(img, x0 + 1, y0 + 1, level);
+}
+
+color image_texture::texel(const bitmap_image* img, int x, int y, int level) const
+{
+    const double color_scale = 1.0 / 255.0;
+
+    if (m_tiled)
+    {
+        unsigned char rgb[3];
+        texture_cache::instance().texel(*m_tiled, level, x, y, rgb);
+        return color(color_scale * rgb[0], color_scale * rgb[1], color_scale * rgb[2]);
+    }
+
+    if (img->is_hdr())
+        return img->hdr_pixel(x, y, level);
+
+    texel_rgb8 pixel = img->pixel_data(x, y, level);
     return color(color_scale * pixel[0], color_scale * pixel[1], color_scale * pixel[2]);
 }
 
+int image_texture::levels(const bitmap_image* img) const
+{
+    return m_tiled ? m_tiled->levels() : img->levels();
+}
+
+int image_texture::level_width(const bitmap_image* img, int level) const
+{
+    return m_tiled ? m_tiled->width(level) : img->level_width(level);
+}
+
+int image_texture::level_height(const bitmap_image* img, int level) const
+{
+    return m_tiled ? m_tiled->height(level) : img->level_height(level);
+}
+
+const bitmap_image& image_texture::image() const
+{
+    // a tiled texture only decodes the whole image if some code asks for its raw data
+    std::call_once(m_image_loaded, [this]()
+    {
+        m_image = m_pending.valid() ? m_pending.get() : texture_registry::instance().get_image(m_filepath, m_options);
+    });
+
+    return *m_image;
+}
+
 int image_texture::getWidth() const
 {
-    return m_image.width();
+    return m_tiled ? m_tiled->width() : image().width();
 }
 
 int image_texture::getHeight() const
 {
-    return m_image.height();
+    return m_tiled ? m_tiled->height() : image().height();
 }
 
 int image_texture::getChannels() const
 {
-    return m_image.channels();
+    return image().channels();
 }
 
 unsigned char* image_texture::get_data() const
 {
-	return m_image.get_data();
+	return image().get_data();
+}
+
+std::vector<float> image_texture::get_data_float() const
+{
+    return image().get_data_float();
+}
+
+bool image_texture::is_hdr() const
+{
+    return image().is_hdr();
 }
 
-float* image_texture::get_data_float() const
+const uint16_t* image_texture::get_hdr_data() const
 {
-    return m_image.get_data_float();
-}
\ No newline at end of file
+    return image().get_hdr_data();
+}
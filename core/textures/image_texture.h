@@ -3,24 +3,59 @@
 #include "../utilities/types.h"
 #include "texture.h"
 #include "../misc/color.h"
-#include "../utilities/bitmap_image.h"
+#include "texture_registry.h"
+#include "tiled_image.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /// <summary>
 /// Image texture
+/// The decoded image comes from the texture registry, textures of the same file share it
+/// Filtered lookups blend the two MIP levels matching the footprint (trilinear)
+/// When the texture cache is enabled, texels are read from the tiled version of the file instead
+/// HDR images (.hdr, .exr) return their radiance (half floats), they are never tiled
+/// The image is decoded in the background while the scene is parsed, the first access waits for it
 /// </summary>
 class image_texture : public texture
 {
 public:
-    image_texture(const std::string filepath);
+    image_texture(const std::string filepath, const image_decode_options& options = {});
 
     color value(double u, double v, const point3& p) const override;
+    color value(double u, double v, const point3& p, rreal footprint) const override;
 
     int getWidth() const;
     int getHeight() const;
     int getChannels() const;
 
     unsigned char* get_data() const;
-    float* get_data_float() const;
+    std::vector<float> get_data_float() const;
+
+    bool is_hdr() const;
+    const uint16_t* get_hdr_data() const;
 private:
-    bitmap_image m_image;
+    std::string m_filepath;
+    image_decode_options m_options;
+
+    std::shared_ptr<tiled_image> m_tiled = nullptr; // out of core texels (texture cache)
+    mutable std::shared_ptr<const bitmap_image> m_image = nullptr;
+    mutable std::once_flag m_image_loaded;
+    std::shared_future<std::shared_ptr<const bitmap_image>> m_pending; // decode started by the constructor
+
+    // img is the decoded image resolved once by value() (nullptr for tiled textures)
+    color nearest(const bitmap_image* img, double u, double v) const;
+    color bilinear(const bitmap_image* img, double u, double v, int level) const;
+    color texel(const bitmap_image* img, int x, int y, int level) const;
+
+    int levels(const bitmap_image* img) const;
+    int level_width(const bitmap_image* img, int level) const;
+    int level_height(const bitmap_image* img, int level) const;
+
+    /// <summary>
+    /// Whole decoded image (waits for the background decode, loaded on first use for tiled textures)
+    /// </summary>
+    const bitmap_image& image() const;
 };
\ No newline at end of file
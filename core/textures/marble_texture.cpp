@@ -1,5 +1,7 @@
 #include "marble_texture.h"
 
+#include <sstream>
+
 marble_texture::marble_texture()
 {
 }
@@ -11,4 +13,17 @@ marble_texture::marble_texture(double sc) : scale(sc)
 color marble_texture::value(double u, double v, const point3& p) const
 {
     return color(1, 1, 1) * 0.5 * (1 + sin(scale * p.z + 10 * noise.turb(p)));
+}
+
+std::string marble_texture::bake_key() const
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << "marble|" << scale;
+    return key.str();
+}
+
+int marble_texture::lookup_inputs() const
+{
+    return position_input;
 }
\ No newline at end of file
@@ -12,6 +12,9 @@ public:
 
     virtual color value(double u, double v, const point3& p) const override;
 
+    std::string bake_key() const override;
+    int lookup_inputs() const override;
+
 public:
     perlin noise;
     double scale;
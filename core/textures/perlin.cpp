@@ -1,130 +1,189 @@
 #include "perlin.h"
 
+#include "../randomizers/randomizer.h"
 #include "../utilities/math_utils.h"
 
-//#include "../randomizers/pcg_randomizer.h"
+#include <algorithm>
+#include <cmath>
 
-perlin::perlin()
-{
-    ranvec = new vector3[point_count];
-
-    randomizer rnd(DefaultRNGSeed);
-
-    //std::shared_ptr<randomizer> rnd = std::make_shared<pcg_randomizer>();
-
-    //randomizer rnd(1, "MySeed");
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PERLIN_SSE2
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
 
-    for (int i = 0; i < point_count; ++i)
-    {
-        ranvec[i] = unit_vector(rnd.get_vector3(-1, 1));
-    }
-
-    perm_x = perlin_generate_perm(rnd);
-    perm_y = perlin_generate_perm(rnd);
-    perm_z = perlin_generate_perm(rnd);
+namespace
+{
+    alignas(16) const float zero_gradient[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 }
 
-perlin::~perlin()
+const perlin::tables& perlin::shared_tables()
 {
-    delete[] ranvec;
-    delete[] perm_x;
-    delete[] perm_y;
-    delete[] perm_z;
+    // same random sequence as the former per instance tables, the noise patterns are unchanged
+    static const tables shared = []()
+    {
+        tables t;
+        randomizer rnd(DefaultRNGSeed);
+
+        for (int i = 0; i < point_count; ++i)
+        {
+            vector3 g = unit_vector(rnd.get_vector3(-1, 1));
+            t.gradients[i][0] = static_cast<float>(g.x);
+            t.gradients[i][1] = static_cast<float>(g.y);
+            t.gradients[i][2] = static_cast<float>(g.z);
+            t.gradients[i][3] = 0.0f;
+        }
+
+        for (uint8_t* perm : { t.perm_x, t.perm_y, t.perm_z })
+        {
+            for (int i = 0; i < point_count; i++)
+                perm[i] = static_cast<uint8_t>(i);
+
+            for (int i = point_count - 1; i > 0; i--)
+                std::swap(perm[i], perm[rnd.get_int(0, i)]);
+        }
+
+        return t;
+    }();
+
+    return shared;
 }
 
 double perlin::noise(const point3& p) const
 {
-    auto u = p.x - floor(p.x);
-    auto v = p.y - floor(p.y);
-    auto w = p.z - floor(p.z);
-
-    u = u * u * (3 - 2 * u);
-    v = v * v * (3 - 2 * v);
-    w = w * w * (3 - 2 * w);
-
-    auto i = static_cast<int>(floor(p.x));
-    auto j = static_cast<int>(floor(p.y));
-    auto k = static_cast<int>(floor(p.z));
-    vector3 c[2][2][2];
-
-    for (int di = 0; di < 2; di++)
-        for (int dj = 0; dj < 2; dj++)
-            for (int dk = 0; dk < 2; dk++)
-                c[di][dj][dk] = ranvec[
-                    perm_x[(i + di) & 255] ^
-                        perm_y[(j + dj) & 255] ^
-                        perm_z[(k + dk) & 255]
-                ];
-
-    return perlin_interp(c, u, v, w);
+    const double x[4] = { p.x, 0, 0, 0 };
+    const double y[4] = { p.y, 0, 0, 0 };
+    const double z[4] = { p.z, 0, 0, 0 };
+
+    float n[4];
+    noise4(x, y, z, 1, n);
+
+    return n[0];
 }
 
 double perlin::turb(const point3& p, int depth) const
 {
-    auto accum = 0.0;
-    auto temp_p = p;
-    auto weight = 1.0;
-
-    for (int i = 0; i < depth; i++) {
-        accum += weight * noise(temp_p);
-        weight *= 0.5;
-        temp_p *= 2;
+    // 4 octaves per noise evaluation, lane l of a group is octave o + l
+    double accum = 0.0;
+    double frequency = 1.0;
+    double weight = 1.0;
+
+    for (int o = 0; o < depth; o += 4)
+    {
+        const int count = std::min(4, depth - o);
+        double x[4] = {}, y[4] = {}, z[4] = {}, weights[4] = {};
+
+        for (int l = 0; l < count; l++)
+        {
+            x[l] = p.x * frequency;
+            y[l] = p.y * frequency;
+            z[l] = p.z * frequency;
+            weights[l] = weight;
+            frequency *= 2;
+            weight *= 0.5;
+        }
+
+        float n[4];
+        noise4(x, y, z, count, n);
+
+        for (int l = 0; l < count; l++)
+            accum += weights[l] * n[l];
     }
 
     return fabs(accum);
 }
 
-int* perlin::perlin_generate_perm(randomizer& rnd)
+void perlin::noise4(const double x[4], const double y[4], const double z[4], int count, float out[4])
 {
-    auto p = new int[point_count];
-
-    for (int i = 0; i < perlin::point_count; i++)
-        p[i] = i;
+    const tables& t = shared_tables();
 
-    permute(p, point_count, rnd);
+    // lattice cell in double precision (large coordinates), offsets in the cell as floats
+    alignas(16) float u[4] = {}, v[4] = {}, w[4] = {};
+    const float* g[4][8]; // gradients of the 8 cell corners of each lane (corner c is di = c >> 2, dj = (c >> 1) & 1, dk = c & 1)
 
-    return p;
-}
+    // unused lanes give 0 (zero gradients)
+    for (int l = count; l < 4; l++)
+        for (int c = 0; c < 8; c++)
+            g[l][c] = zero_gradient;
 
-void perlin::permute(int* p, int n, randomizer& rnd)
-{
-    for (int i = n - 1; i > 0; i--) {
-        int target = rnd.get_int(0, i);
-        int tmp = p[i];
-        p[i] = p[target];
-        p[target] = tmp;
+    for (int l = 0; l < count; l++)
+    {
+        // truncation is a floor once the negative values are fixed (std::floor is a libm call without SSE4.1)
+        int i = static_cast<int>(x[l]), j = static_cast<int>(y[l]), k = static_cast<int>(z[l]);
+        i -= (x[l] < i);
+        j -= (y[l] < j);
+        k -= (z[l] < k);
+
+        u[l] = static_cast<float>(x[l] - i);
+        v[l] = static_cast<float>(y[l] - j);
+        w[l] = static_cast<float>(z[l] - k);
+
+        const int h00 = t.perm_x[i & 255] ^ t.perm_y[j & 255];
+        const int h01 = t.perm_x[i & 255] ^ t.perm_y[(j + 1) & 255];
+        const int h10 = t.perm_x[(i + 1) & 255] ^ t.perm_y[j & 255];
+        const int h11 = t.perm_x[(i + 1) & 255] ^ t.perm_y[(j + 1) & 255];
+        const int z0 = t.perm_z[k & 255];
+        const int z1 = t.perm_z[(k + 1) & 255];
+
+        g[l][0] = t.gradients[h00 ^ z0];
+        g[l][1] = t.gradients[h00 ^ z1];
+        g[l][2] = t.gradients[h01 ^ z0];
+        g[l][3] = t.gradients[h01 ^ z1];
+        g[l][4] = t.gradients[h10 ^ z0];
+        g[l][5] = t.gradients[h10 ^ z1];
+        g[l][6] = t.gradients[h11 ^ z0];
+        g[l][7] = t.gradients[h11 ^ z1];
     }
-}
 
-double perlin::trilinear_interp(double c[2][2][2], double u, double v, double w)
-{
-    auto accum = 0.0;
-    for (int i = 0; i < 2; i++)
-        for (int j = 0; j < 2; j++)
-            for (int k = 0; k < 2; k++)
-                accum += (i * u + (1 - i) * (1 - u)) *
-                (j * v + (1 - j) * (1 - v)) *
-                (k * w + (1 - k) * (1 - w)) * c[i][j][k];
-
-    return accum;
-}
+    // the offsets are smoothed before the gradient dot products and smoothed again for the interpolation weights
+    // (the hermite curve was applied twice by the former code, kept for identical patterns)
+#ifdef PERLIN_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
 
-double perlin::perlin_interp(vector3 c[2][2][2], double u, double v, double w)
-{
-    auto uu = u * u * (3 - 2 * u);
-    auto vv = v * v * (3 - 2 * v);
-    auto ww = w * w * (3 - 2 * w);
-    auto accum = 0.0;
-
-    for (int i = 0; i < 2; i++)
-        for (int j = 0; j < 2; j++)
-            for (int k = 0; k < 2; k++) {
-                vector3 weight_v(u - i, v - j, w - k);
-                accum += (i * uu + (1 - i) * (1 - uu))
-                    * (j * vv + (1 - j) * (1 - vv))
-                    * (k * ww + (1 - k) * (1 - ww))
-                    * dot(c[i][j][k], weight_v);
-            }
-
-    return accum;
-}
\ No newline at end of file
+    auto smooth = [&](__m128 a) { return _mm_mul_ps(_mm_mul_ps(a, a), _mm_sub_ps(three, _mm_mul_ps(two, a))); };
+    auto lerp = [](__m128 a, __m128 b, __m128 f) { return _mm_add_ps(a, _mm_mul_ps(f, _mm_sub_ps(b, a))); };
+
+    const __m128 su = smooth(_mm_load_ps(u)), sv = smooth(_mm_load_ps(v)), sw = smooth(_mm_load_ps(w));
+    const __m128 uu = smooth(su), vv = smooth(sv), ww = smooth(sw);
+
+    const __m128 su1 = _mm_sub_ps(su, one), sv1 = _mm_sub_ps(sv, one), sw1 = _mm_sub_ps(sw, one);
+
+    // one gradient per lane, transposed to x, y, z registers, dot product with the offset to the corner
+    auto corner = [&](int c, __m128 dx, __m128 dy, __m128 dz)
+    {
+        __m128 gx = _mm_load_ps(g[0][c]), gy = _mm_load_ps(g[1][c]), gz = _mm_load_ps(g[2][c]), gw = _mm_load_ps(g[3][c]);
+        _MM_TRANSPOSE4_PS(gx, gy, gz, gw);
+
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, dx), _mm_mul_ps(gy, dy)), _mm_mul_ps(gz, dz));
+    };
+
+    const __m128 x00 = lerp(corner(0, su, sv, sw), corner(1, su, sv, sw1), ww);
+    const __m128 x01 = lerp(corner(2, su, sv1, sw), corner(3, su, sv1, sw1), ww);
+    const __m128 x10 = lerp(corner(4, su1, sv, sw), corner(5, su1, sv, sw1), ww);
+    const __m128 x11 = lerp(corner(6, su1, sv1, sw), corner(7, su1, sv1, sw1), ww);
+    _mm_storeu_ps(out, lerp(lerp(x00, x01, vv), lerp(x10, x11, vv), uu));
+#else
+    auto smooth = [](float a) { return a * a * (3.0f - 2.0f * a); };
+    auto lerp = [](float a, float b, float f) { return a + f * (b - a); };
+
+    for (int l = 0; l < 4; l++)
+    {
+        if (l >= count)
+        {
+            out[l] = 0.0f;
+            continue;
+        }
+
+        const float su = smooth(u[l]), sv = smooth(v[l]), sw = smooth(w[l]);
+        const float uu = smooth(su), vv = smooth(sv), ww = smooth(sw);
+
+        float d[8];
+        for (int c = 0; c < 8; c++)
+            d[c] = g[l][c][0] * ((c >> 2) ? su - 1.0f : su) + g[l][c][1] * (((c >> 1) & 1) ? sv - 1.0f : sv) + g[l][c][2] * ((c & 1) ? sw - 1.0f : sw);
+
+        out[l] = lerp(lerp(lerp(d[0], d[1], ww), lerp(d[2], d[3], ww), vv), lerp(lerp(d[4], d[5], ww), lerp(d[6], d[7], ww), vv), uu);
+    }
+#endif
+}
@@ -1,5 +1,7 @@
 #include "perlin_noise_texture.h"
 
+#include <sstream>
+
 perlin_noise_texture::perlin_noise_texture()
 {
 
@@ -12,6 +14,19 @@ perlin_noise_texture::perlin_noise_texture(double sc) : scale(sc)
 
 color perlin_noise_texture::value(double u, double v, const point3& p) const
 {
-    auto s = scale * p;
+    auto s = rreal(scale) * p;
     return color(1, 1, 1) * 0.5 * (1 + sin(s.z + 10 * noise.turb(s)));
+}
+
+std::string perlin_noise_texture::bake_key() const
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << "noise|" << scale;
+    return key.str();
+}
+
+int perlin_noise_texture::lookup_inputs() const
+{
+    return position_input;
 }
\ No newline at end of file
@@ -16,6 +16,9 @@ public:
 
     color value(double u, double v, const point3& p) const override;
 
+    std::string bake_key() const override;
+    int lookup_inputs() const override;
+
 private:
     perlin noise;
     double scale = 0.0;
@@ -1,5 +1,7 @@
 #include "solid_color_texture.h"
 
+#include <sstream>
+
 //solid_color_texture::solid_color_texture(color c) : m_color_value(c)
 //{
 //}
@@ -20,4 +22,17 @@ color solid_color_texture::value(double u, double v, const point3& p) const
 color solid_color_texture::get_color() const
 {
     return m_color_value;
+}
+
+std::string solid_color_texture::bake_key() const
+{
+    std::ostringstream key;
+    key.precision(17);
+    key << "solid|" << m_color_value.r() << "," << m_color_value.g() << "," << m_color_value.b();
+    return key.str();
+}
+
+int solid_color_texture::lookup_inputs() const
+{
+    return 0;
 }
\ No newline at end of file
@@ -18,6 +18,9 @@ public:
 
     color value(double u, double v, const point3& p) const override;
 
+    std::string bake_key() const override;
+    int lookup_inputs() const override;
+
     color get_color() const;
 
 private:
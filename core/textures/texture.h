@@ -4,6 +4,8 @@
 #include "../constants.h"
 #include "../misc/color.h"
 
+#include <string>
+
 /// <summary>
 /// Texture base class
 /// </summary>
@@ -13,4 +15,31 @@ public:
     virtual ~texture() = default;
 
     virtual color value(double u, double v, const point3& p) const = 0;
+
+    /// <summary>
+    /// Filtered lookup, footprint is the width (in uv units) of the ray cone at the hit point (point lookup by default)
+    /// </summary>
+    virtual color value(double u, double v, const point3& p, rreal footprint) const
+    {
+        return value(u, v, p);
+    }
+
+    /// <summary>
+    /// Parameters identifying the texels of a procedural texture (baked texture cache files), empty when it can't be baked
+    /// </summary>
+    virtual std::string bake_key() const
+    {
+        return {};
+    }
+
+    static constexpr int uv_input = 1;
+    static constexpr int position_input = 2;
+
+    /// <summary>
+    /// Lookup coordinates value() depends on (uv_input | position_input), a baked texture can only rasterize one of them
+    /// </summary>
+    virtual int lookup_inputs() const
+    {
+        return uv_input | position_input;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+    constexpr int local_slot_count = 64;
+
+    struct local_slot
+    {
+        uint64_t key = ~0ull;
+        std::shared_ptr<const std::vector<unsigned char>> data;
+    };
+
+    // last tiles used by this thread (no lock, no atomic on a hit)
+    thread_local local_slot t_slots[local_slot_count];
+    thread_local uint64_t t_local_hits = 0;
+
+    uint64_t tile_key(uint32_t id, int level, int tx, int ty)
+    {
+        // 32 bits image id, 6 bits level, 13 bits per tile coordinate
+        return (static_cast<uint64_t>(id) << 32) | (static_cast<uint64_t>(level & 0x3F) << 26)
+            | (static_cast<uint64_t>(ty & 0x1FFF) << 13) | static_cast<uint64_t>(tx & 0x1FFF);
+    }
+}
+
+texture_cache& texture_cache::instance()
+{
+    static texture_cache cache;
+    return cache;
+}
+
+void texture_cache::configure(size_t budget_bytes)
+{
+    m_budget = budget_bytes;
+}
+
+bool texture_cache::enabled() const
+{
+    return m_budget > 0;
+}
+
+size_t texture_cache::budget() const
+{
+    return m_budget;
+}
+
+void texture_cache::texel(const tiled_image& image, int level, int x, int y, unsigned char rgb[3])
+{
+    x = std::clamp(x, 0, image.width(level) - 1);
+    y = std::clamp(y, 0, image.height(level) - 1);
+
+    const int size = image.tile_size();
+    const int tx = x / size;
+    const int ty = y / size;
+    const uint64_t key = tile_key(image.id(), level, tx, ty);
+
+    local_slot& slot = t_slots[(key ^ (key >> 13) ^ (key >> 32)) & (local_slot_count - 1)];
+
+    if (slot.key == key)
+    {
+        // flushed in batches, a shared counter on every lookup would be contended
+        if (++t_local_hits == 4096)
+        {
+            m_local_hits.fetch_add(t_local_hits, std::memory_order_relaxed);
+            t_local_hits = 0;
+        }
+    }
+    else
+    {
+        slot.data = fetch(image, level, tx, ty, key);
+        slot.key = slot.data ? key : ~0ull;
+    }
+
+    if (!slot.data)
+    {
+        rgb[0] = 255; rgb[1] = 0; rgb[2] = 255;
+        return;
+    }
+
+    std::memcpy(rgb, slot.data->data() + (static_cast<size_t>(y % size) * size + (x % size)) * 3, 3);
+}
+
+std::shared_ptr<const texture_cache::tile> texture_cache::fetch(const tiled_image& image, int level, int tx, int ty, uint64_t key)
+{
+    shard& s = m_shards[(key ^ (key >> 32)) % shard_count];
+
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        auto it = s.tiles.find(key);
+        if (it != s.tiles.end())
+        {
+            s.lru.splice(s.lru.begin(), s.lru, it->second.second);
+            m_shared_hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.first;
+        }
+    }
+
+    // read outside of the lock, other threads keep using the shard
+    auto loaded = std::make_shared<tile>();
+    if (!image.read_tile(level, tx, ty, *loaded))
+        return nullptr;
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    m_bytes_read.fetch_add(loaded->size(), std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    // another thread may have loaded it meanwhile
+    auto it = s.tiles.find(key);
+    if (it != s.tiles.end())
+        return it->second.first;
+
+    s.lru.push_front(key);
+    s.tiles.emplace(key, std::make_pair(std::shared_ptr<const tile>(loaded), s.lru.begin()));
+    s.bytes += loaded->size();
+
+    // retired tiles no thread holds anymore are freed (nothing can take a new reference once out of the map)
+    auto released = std::remove_if(s.retired.begin(), s.retired.end(), [&s](const std::shared_ptr<const tile>& t)
+    {
+        if (t.use_count() > 1)
+            return false;
+
+        s.bytes -= t->size();
+        return true;
+    });
+    s.retired.erase(released, s.retired.end());
+
+    // the retired tiles still use memory, more shared tiles are evicted to stay within the budget
+    const size_t shard_budget = std::max<size_t>(m_budget / shard_count, loaded->size());
+    while (s.bytes > shard_budget && s.lru.size() > 1)
+    {
+        auto victim = s.tiles.find(s.lru.back());
+        if (victim->second.first.use_count() > 1)
+            s.retired.push_back(std::move(victim->second.first));
+        else
+            s.bytes -= victim->second.first->size();
+
+        s.tiles.erase(victim);
+        s.lru.pop_back();
+
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return loaded;
+}
+
+void texture_cache::print_stats()
+{
+    size_t bytes = 0;
+    for (auto& s : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        bytes += s.bytes;
+    }
+
+    // hits not flushed yet by the render threads are left out
+    uint64_t local_hits = m_local_hits.load();
+    uint64_t shared_hits = m_shared_hits.load();
+    uint64_t misses = m_misses.load();
+    uint64_t lookups = local_hits + shared_hits + misses;
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "[INFO] Texture cache : " << bytes / (1024.0 * 1024.0) << " MB used of " << m_budget / (1024.0 * 1024.0) << " MB, "
+        << misses << " tiles read (" << m_bytes_read.load() / (1024.0 * 1024.0) << " MB), " << m_evictions.load() << " evicted" << std::endl;
+
+    std::cout << "[INFO] Texture cache : hit rate " << (lookups > 0 ? 100.0 * (local_hits + shared_hits) / lookups : 0.0)
+        << "% (thread " << local_hits << ", shared " << shared_hits << ", miss " << misses << ")" << std::defaultfloat << std::endl;
+}
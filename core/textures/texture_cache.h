@@ -0,0 +1,68 @@
+#pragma once
+
+#include "tiled_image.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Out of core texture cache
+/// Tiled images are read tile by tile on first access and kept within a fixed memory budget (least recently used tiles are evicted)
+/// Each thread keeps its last tiles in a small direct mapped table, most lookups take no lock
+/// The shared tiles are split in shards, each with its own lock, LRU list and share of the budget
+/// A tile evicted while a thread still holds it stays alive until that thread drops it, its bytes are still counted against the budget meanwhile
+/// </summary>
+class texture_cache
+{
+public:
+    static texture_cache& instance();
+
+    texture_cache(const texture_cache&) = delete;
+    texture_cache& operator=(const texture_cache&) = delete;
+
+    /// <summary>
+    /// Memory budget of the cache, 0 disables it (image textures are then decoded whole)
+    /// </summary>
+    void configure(size_t budget_bytes);
+    bool enabled() const;
+    size_t budget() const;
+
+    /// <summary>
+    /// Texel of a tiled image (coordinates are clamped to the level size), magenta if its tile can't be read
+    /// </summary>
+    void texel(const tiled_image& image, int level, int x, int y, unsigned char rgb[3]);
+
+    void print_stats();
+
+private:
+    texture_cache() = default;
+
+    using tile = std::vector<unsigned char>;
+
+    static constexpr int shard_count = 16;
+
+    struct shard
+    {
+        std::mutex mutex;
+        std::list<uint64_t> lru; // most recent first
+        std::unordered_map<uint64_t, std::pair<std::shared_ptr<const tile>, std::list<uint64_t>::iterator>> tiles;
+        std::vector<std::shared_ptr<const tile>> retired; // evicted but still held by a thread table
+        size_t bytes = 0; // tiles and retired
+    };
+
+    size_t m_budget = 0;
+    shard m_shards[shard_count];
+
+    std::atomic<uint64_t> m_local_hits{ 0 };
+    std::atomic<uint64_t> m_shared_hits{ 0 };
+    std::atomic<uint64_t> m_misses{ 0 };
+    std::atomic<uint64_t> m_evictions{ 0 };
+    std::atomic<uint64_t> m_bytes_read{ 0 };
+
+    std::shared_ptr<const tile> fetch(const tiled_image& image, int level, int tx, int ty, uint64_t key);
+};
@@ -0,0 +1,228 @@
+#include "texture_registry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+texture_registry& texture_registry::instance()
+{
+    static texture_registry registry;
+    return registry;
+}
+
+std::shared_ptr<const bitmap_image> texture_registry::get_image(const std::string& filepath, const image_decode_options& options)
+{
+    // decoded by the calling thread : a worker asking for an image doesn't wait for a free worker
+    return request(filepath, options, false).get();
+}
+
+std::shared_future<std::shared_ptr<const bitmap_image>> texture_registry::load_async(const std::string& filepath, const image_decode_options& options)
+{
+    return request(filepath, options, true);
+}
+
+std::shared_future<std::shared_ptr<const bitmap_image>> texture_registry::request(const std::string& filepath, const image_decode_options& options, bool async)
+{
+    image_decode_options decode = options;
+    if (decode.layout == texel_layout::automatic)
+        decode.layout = m_default_layout;
+    if (decode.compression == texture_compression::automatic)
+        decode.compression = !m_default_compression ? texture_compression::none : (decode.normal_map ? texture_compression::bc5 : texture_compression::bc1);
+
+    const std::string path = bitmap_image::resolve_path(filepath);
+    const std::string key = path + "|" + decode.key();
+
+    auto promise = std::make_shared<std::promise<std::shared_ptr<const bitmap_image>>>();
+    std::shared_future<std::shared_ptr<const bitmap_image>> pending = promise->get_future().share();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        if (auto image = it->second.image.lock())
+        {
+            promise->set_value(image);
+            return pending;
+        }
+
+        // another texture already asked for it
+        if (it->second.pending.valid())
+            return it->second.pending;
+    }
+
+    entry& e = m_entries[key];
+    e.image.reset();
+    e.pending = pending;
+
+    // decoded outside of the lock, other files are loaded at the same time
+    if (async)
+    {
+        pool().submit([this, key, path, decode, promise]() { promise->set_value(this->decode(key, path, decode)); });
+    }
+    else
+    {
+        lock.unlock();
+        promise->set_value(this->decode(key, path, decode));
+    }
+
+    return pending;
+}
+
+std::shared_ptr<const bitmap_image> texture_registry::decode(const std::string& key, const std::string& path, const image_decode_options& options)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // a throwing decode (allocation, corrupt file) leaves an empty image like a missing file, the waiters must still get a value
+    std::shared_ptr<const bitmap_image> image;
+    try
+    {
+        image = std::make_shared<const bitmap_image>(path, options);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[ERROR] Texture decode failed " << path << " (" << e.what() << ")" << std::endl;
+        image = std::make_shared<const bitmap_image>();
+    }
+    catch (...)
+    {
+        std::cerr << "[ERROR] Texture decode failed " << path << std::endl;
+        image = std::make_shared<const bitmap_image>();
+    }
+
+    m_decode_microseconds += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    if (image->width() > 0)
+    {
+        // a single write per image, the workers log at the same time
+        std::ostringstream message;
+        message << "[INFO] Texture loaded " << path << " (" << image->width() << "x" << image->height()
+            << (image->is_hdr() ? " hdr" : "") << ", " << image->levels() << " levels, " << std::fixed << std::setprecision(2)
+            << image->memory_size() / (1024.0 * 1024.0) << " MB";
+
+        // quality report of the compressed texels against the decoded file
+        if (image->compression() != texture_compression::none)
+        {
+            message << ", " << (image->compression() == texture_compression::bc5 ? "bc5" : "bc1") << " PSNR "
+                << std::setprecision(1) << image->compression_psnr() << " dB";
+        }
+
+        message << ")" << std::endl;
+        std::cout << message.str();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    entry& e = m_entries[key];
+    e.image = image;
+    e.pending = {};
+
+    return image;
+}
+
+void texture_registry::run_async(std::function<void()> task)
+{
+    auto done = std::make_shared<std::promise<void>>();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_tasks.push_back(done->get_future().share());
+
+    pool().submit([task, done]()
+    {
+        // wait_pending only waits, a failed task is reported here and never leaves its future unset
+        try
+        {
+            task();
+            done->set_value();
+        }
+        catch (...)
+        {
+            std::cerr << "[ERROR] Texture task failed" << std::endl;
+            done->set_exception(std::current_exception());
+        }
+    });
+}
+
+void texture_registry::wait_pending()
+{
+    // tasks may request more images, wait until nothing is left
+    for (;;)
+    {
+        std::vector<std::shared_future<std::shared_ptr<const bitmap_image>>> images;
+        std::vector<std::shared_future<void>> tasks;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (const auto& [key, e] : m_entries)
+            {
+                if (e.pending.valid())
+                    images.push_back(e.pending);
+            }
+
+            tasks.swap(m_tasks);
+        }
+
+        if (images.empty() && tasks.empty())
+            return;
+
+        for (auto& image : images)
+            image.wait();
+
+        for (auto& task : tasks)
+            task.wait();
+    }
+}
+
+double texture_registry::decode_milliseconds() const
+{
+    return m_decode_microseconds / 1000.0;
+}
+
+thread_pool& texture_registry::pool()
+{
+    if (!m_pool)
+        m_pool = std::make_unique<thread_pool>(std::max(1u, std::thread::hardware_concurrency()));
+
+    return *m_pool;
+}
+
+void texture_registry::set_default_layout(texel_layout layout)
+{
+    m_default_layout = (layout == texel_layout::automatic) ? texel_layout::linear : layout;
+}
+
+void texture_registry::set_default_compression(bool enabled)
+{
+    m_default_compression = enabled;
+}
+
+size_t texture_registry::memory_size()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t bytes = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (auto image = it->second.image.lock())
+        {
+            bytes += image->memory_size();
+            ++it;
+        }
+        else if (!it->second.pending.valid())
+        {
+            // the last texture using it is gone
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return bytes;
+}
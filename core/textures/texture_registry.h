@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../utilities/bitmap_image.h"
+#include "../utilities/thread_pool.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// Process wide registry of the decoded images
+/// Every image texture asks the registry for its file : the same file (canonical path) with the same decode options is decoded once
+/// and shared by all the textures using it. The registry only keeps weak references, an image is freed with its last texture
+/// Thread safe, concurrent requests for an image being decoded wait for it instead of decoding it again
+/// Images are decoded on a pool of worker threads : the scene parsing goes on while they load, wait_pending() joins them before the render
+/// </summary>
+class texture_registry
+{
+public:
+    static texture_registry& instance();
+
+    texture_registry(const texture_registry&) = delete;
+    texture_registry& operator=(const texture_registry&) = delete;
+
+    /// <summary>
+    /// Decoded image of a file, loaded on first request (never null, a missing file gives an empty image)
+    /// </summary>
+    std::shared_ptr<const bitmap_image> get_image(const std::string& filepath, const image_decode_options& options = {});
+
+    /// <summary>
+    /// Start decoding an image on the worker threads (or share the decode already started), the future gives the image
+    /// </summary>
+    std::shared_future<std::shared_ptr<const bitmap_image>> load_async(const std::string& filepath, const image_decode_options& options = {});
+
+    /// <summary>
+    /// Run some load time work on the worker threads (data derived from the images), it may wait for the images requested before
+    /// </summary>
+    void run_async(std::function<void()> task);
+
+    /// <summary>
+    /// Wait for every image decode and task started so far
+    /// </summary>
+    void wait_pending();
+
+    /// <summary>
+    /// Time spent decoding images, summed over the worker threads
+    /// </summary>
+    double decode_milliseconds() const;
+
+    /// <summary>
+    /// Bytes held by the images still alive
+    /// </summary>
+    size_t memory_size();
+
+    /// <summary>
+    /// Layout of the images loaded with the automatic layout option (set before the scene textures are created)
+    /// </summary>
+    void set_default_layout(texel_layout layout);
+
+    /// <summary>
+    /// Block compression of the images loaded with the automatic compression option (bc5 for normal maps, bc1 for the others)
+    /// </summary>
+    void set_default_compression(bool enabled);
+
+private:
+    texture_registry() = default;
+
+    struct entry
+    {
+        std::weak_ptr<const bitmap_image> image;
+        std::shared_future<std::shared_ptr<const bitmap_image>> pending; // valid while the image is being decoded
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, entry> m_entries;
+    std::vector<std::shared_future<void>> m_tasks;
+    std::unique_ptr<thread_pool> m_pool;
+    std::atomic<int64_t> m_decode_microseconds{ 0 };
+
+    texel_layout m_default_layout = texel_layout::linear;
+    bool m_default_compression = false;
+
+    std::shared_future<std::shared_ptr<const bitmap_image>> request(const std::string& filepath, const image_decode_options& options, bool async);
+    std::shared_ptr<const bitmap_image> decode(const std::string& key, const std::string& path, const image_decode_options& options);
+    thread_pool& pool(); // m_mutex held
+};
@@ -0,0 +1,221 @@
+#include "tiled_image.h"
+
+#include "../utilities/bitmap_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+
+namespace
+{
+    constexpr char tiled_magic[4] = { 'C', 'T', 'T', '1' };
+
+    template<typename T>
+    void write_value(std::ofstream& out, T value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    bool read_value(std::ifstream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+std::atomic<uint32_t> tiled_image::next_id{ 1 };
+
+std::shared_ptr<tiled_image> tiled_image::open(const std::string& filepath)
+{
+    std::string source = bitmap_image::resolve_path(filepath);
+
+    std::error_code ec;
+    auto source_size = std::filesystem::file_size(source, ec);
+    if (ec)
+    {
+        std::cerr << "[ERROR] Image not found '" << source << "'" << std::endl;
+        return nullptr;
+    }
+
+    auto source_time = std::filesystem::last_write_time(source, ec).time_since_epoch().count();
+
+    // the name changes with the source file, stale conversions are never read
+    size_t hash = std::hash<std::string>{}(source + "|" + std::to_string(source_size) + "|" + std::to_string(source_time));
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path(ec) / "cortex_tiles";
+    std::filesystem::create_directories(directory, ec);
+
+    std::filesystem::path tiled_path = directory / (std::filesystem::path(source).stem().string() + "_" + std::to_string(hash) + ".ctt");
+
+    if (!std::filesystem::exists(tiled_path))
+    {
+        std::cout << "[INFO] Converting texture " << source << " to tiles" << std::endl;
+
+        if (!convert(source, tiled_path.string(), default_tile_size))
+        {
+            std::cerr << "[ERROR] Could not convert image file '" << source << "'" << std::endl;
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<tiled_image> image(new tiled_image());
+    if (!image->read_header(tiled_path.string()))
+    {
+        std::cerr << "[ERROR] Could not read tiled image file '" << tiled_path.string() << "'" << std::endl;
+        return nullptr;
+    }
+
+    image->m_id = next_id++;
+
+    return image;
+}
+
+bool tiled_image::convert(const std::string& source, const std::string& destination, int tile_size)
+{
+    bitmap_image image(source, image_decode_options{ false, true });
+    if (image.levels() == 0)
+        return false;
+
+    // written aside then renamed, another process never reads a partial file
+    std::string temporary = destination + ".tmp" + std::to_string(next_id++);
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+
+        out.write(tiled_magic, sizeof(tiled_magic));
+        write_value<int32_t>(out, tile_size);
+        write_value<int32_t>(out, image.levels());
+
+        for (int level = 0; level < image.levels(); level++)
+        {
+            write_value<int32_t>(out, image.level_width(level));
+            write_value<int32_t>(out, image.level_height(level));
+        }
+
+        std::vector<unsigned char> tile(static_cast<size_t>(tile_size) * tile_size * 3);
+
+        for (int level = 0; level < image.levels(); level++)
+        {
+            int width = image.level_width(level);
+            int height = image.level_height(level);
+
+            for (int ty = 0; ty * tile_size < height; ty++)
+            {
+                for (int tx = 0; tx * tile_size < width; tx++)
+                {
+                    // texels past the image edge repeat the last ones (clamped addressing)
+                    for (int y = 0; y < tile_size; y++)
+                    {
+                        for (int x = 0; x < tile_size; x++)
+                        {
+                            texel_rgb8 texel = image.pixel_data(tx * tile_size + x, ty * tile_size + y, level);
+                            std::memcpy(&tile[(static_cast<size_t>(y) * tile_size + x) * 3], texel.rgb, 3);
+                        }
+                    }
+
+                    out.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+                }
+            }
+        }
+
+        if (!out)
+            return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, destination, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+        return std::filesystem::exists(destination);
+    }
+
+    return true;
+}
+
+bool tiled_image::read_header(const std::string& path)
+{
+    m_file.open(path, std::ios::binary);
+    if (!m_file)
+        return false;
+
+    char magic[4] = {};
+    m_file.read(magic, sizeof(magic));
+    if (!m_file || std::memcmp(magic, tiled_magic, sizeof(magic)) != 0)
+        return false;
+
+    int32_t tile_size = 0, level_count = 0;
+    if (!read_value(m_file, tile_size) || !read_value(m_file, level_count) || tile_size <= 0 || level_count <= 0)
+        return false;
+
+    m_tile_size = tile_size;
+    m_levels.resize(level_count);
+
+    uint64_t offset = sizeof(tiled_magic) + 2 * sizeof(int32_t) + static_cast<uint64_t>(level_count) * 2 * sizeof(int32_t);
+    uint64_t tile_bytes = static_cast<uint64_t>(tile_size) * tile_size * 3;
+
+    for (auto& level : m_levels)
+    {
+        int32_t w = 0, h = 0;
+        if (!read_value(m_file, w) || !read_value(m_file, h) || w <= 0 || h <= 0)
+            return false;
+
+        level.width = w;
+        level.height = h;
+        level.offset = offset;
+
+        offset += static_cast<uint64_t>((w + tile_size - 1) / tile_size) * ((h + tile_size - 1) / tile_size) * tile_bytes;
+    }
+
+    return true;
+}
+
+uint32_t tiled_image::id() const
+{
+    return m_id;
+}
+
+int tiled_image::tile_size() const
+{
+    return m_tile_size;
+}
+
+int tiled_image::levels() const
+{
+    return static_cast<int>(m_levels.size());
+}
+
+int tiled_image::width(int level) const
+{
+    return m_levels[level].width;
+}
+
+int tiled_image::height(int level) const
+{
+    return m_levels[level].height;
+}
+
+int tiled_image::tiles_x(int level) const
+{
+    return (m_levels[level].width + m_tile_size - 1) / m_tile_size;
+}
+
+bool tiled_image::read_tile(int level, int tx, int ty, std::vector<unsigned char>& texels) const
+{
+    uint64_t tile_bytes = static_cast<uint64_t>(m_tile_size) * m_tile_size * 3;
+    uint64_t offset = m_levels[level].offset + (static_cast<uint64_t>(ty) * tiles_x(level) + tx) * tile_bytes;
+
+    texels.resize(tile_bytes);
+
+    std::lock_guard<std::mutex> lock(m_file_mutex);
+
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(offset));
+    m_file.read(reinterpret_cast<char*>(texels.data()), static_cast<std::streamsize>(tile_bytes));
+
+    return static_cast<bool>(m_file);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Image converted to the tiled, mipmapped on-disk format read by the texture cache
+/// Layout : "CTT1" magic, tile size, level count, size of each level, then the tiles of each level in row order (rgb, edge tiles padded)
+/// Converted files are kept in the temp directory, named after the source path, size and date (a modified source is converted again)
+/// The conversion decodes the whole source once (the decoders have no row by row mode), only images larger than the cache budget are converted
+/// </summary>
+class tiled_image
+{
+public:
+    static constexpr int default_tile_size = 64;
+
+    /// <summary>
+    /// Open the tiled version of an image file, converting it first if needed (nullptr if the image can't be read)
+    /// </summary>
+    static std::shared_ptr<tiled_image> open(const std::string& filepath);
+
+    tiled_image(const tiled_image&) = delete;
+    tiled_image& operator=(const tiled_image&) = delete;
+
+    uint32_t id() const;
+    int tile_size() const;
+    int levels() const;
+    int width(int level = 0) const;
+    int height(int level = 0) const;
+    int tiles_x(int level) const;
+
+    /// <summary>
+    /// Read one tile from the disk (tile_size x tile_size rgb texels)
+    /// </summary>
+    bool read_tile(int level, int tx, int ty, std::vector<unsigned char>& texels) const;
+
+private:
+    tiled_image() = default;
+
+    struct level_info
+    {
+        int width = 0;
+        int height = 0;
+        uint64_t offset = 0; // first tile of the level in the file
+    };
+
+    uint32_t m_id = 0;
+    int m_tile_size = default_tile_size;
+    std::vector<level_info> m_levels;
+
+    mutable std::mutex m_file_mutex;
+    mutable std::ifstream m_file;
+
+    static std::atomic<uint32_t> next_id;
+
+    static bool convert(const std::string& source, const std::string& destination, int tile_size);
+    bool read_header(const std::string& path);
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../constants.h"
+
 #include <glm/glm.hpp>
 
 #include <tuple>
@@ -10,20 +12,20 @@
 #include <Eigen/StdVector>
 #include <Eigen/Geometry>
 
-using vector2 = glm::dvec2;
-using vector3 = glm::dvec3;
-using vector4 = glm::dvec4;
+using vector2 = glm::vec<2, rreal>;
+using vector3 = glm::vec<3, rreal>;
+using vector4 = glm::vec<4, rreal>;
 
-using matrix3 = glm::dmat3;
-using matrix4 = glm::dmat4;
+using matrix3 = glm::mat<3, 3, rreal>;
+using matrix4 = glm::mat<4, 4, rreal>;
 
-using point2 = glm::dvec2;
-using point3 = glm::dvec3;
+using point2 = glm::vec<2, rreal>;
+using point3 = glm::vec<3, rreal>;
 
 typedef Eigen::Matrix<double, 5, 1> Vector5d;
 
 
-inline double vector_multiply_to_double(const vector3& v1, const vector3& v2)
+inline rreal vector_multiply_to_double(const vector3& v1, const vector3& v2)
 {
 	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
 }
@@ -33,30 +35,44 @@ inline vector3 vector_modulo_operator(const vector3& v1, const vector3& v2)
 	return vector3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
 }
 
-inline double vector_length_squared(vector3 v)
+inline rreal vector_length_squared(vector3 v)
 {
     return v.x * v.x + v.y * v.y + v.z * v.z;
 }
 
-inline double vector_length(vector3 v)
+inline rreal vector_length(vector3 v)
 {
     return glm::sqrt(vector_length_squared(v));
 }
 
 inline vector3 unit_vector(vector3 v)
 {
-    double len = vector_length(v);
+    rreal len = vector_length(v);
     return v / vector3(len, len, len);
 }
 
-static bool isZero(const glm::dvec3& vec, double epsilon = 1e-9)
+static bool isZero(const vector3& vec, rreal epsilon = ZERO_EPSILON)
 {
     return std::abs(vec.x) < epsilon &&
         std::abs(vec.y) < epsilon &&
         std::abs(vec.z) < epsilon;
 }
 
-static bool isNotZero(const glm::dvec3& vec, double epsilon = 1e-9)
+static bool isNotZero(const vector3& vec, rreal epsilon = ZERO_EPSILON)
 {
     return !isZero(vec, epsilon);
+}
+
+/// <summary>
+/// Ray offset epsilon relative to the magnitude of a point coordinates
+/// (a fixed epsilon is too small far from the origin in single precision, double keeps the fixed one)
+/// </summary>
+inline rreal robust_epsilon(const point3& p)
+{
+#ifdef USE_SINGLE_PRECISION_REAL
+    rreal m = glm::max(glm::max(std::abs(p.x), std::abs(p.y)), std::abs(p.z));
+    return SHADOW_ACNE_FIX * (m > rreal(1) ? m : rreal(1));
+#else
+    return SHADOW_ACNE_FIX;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "alias_table.h"
+
+#include <algorithm>
+#include <cstdint>
+
+alias_table::alias_table(const std::vector<double>& weights)
+{
+    build(weights);
+}
+
+void alias_table::build(const std::vector<double>& weights)
+{
+    clear();
+
+    const size_t n = weights.size();
+    if (n == 0)
+        return;
+
+    for (double w : weights)
+        m_total_weight += std::max(w, 0.0);
+
+    m_pmf.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        m_pmf[i] = m_total_weight > 0.0 ? std::max(weights[i], 0.0) / m_total_weight : 1.0 / static_cast<double>(n);
+    }
+
+    m_probabilities.assign(n, 1.0);
+    m_aliases.resize(n);
+
+    // scaled probabilities (average is 1), split in small and large bins
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    small.reserve(n);
+    large.reserve(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        m_aliases[i] = static_cast<int>(i);
+        scaled[i] = m_pmf[i] * static_cast<double>(n);
+
+        if (scaled[i] < 1.0)
+            small.push_back(static_cast<int>(i));
+        else
+            large.push_back(static_cast<int>(i));
+    }
+
+    // each small bin is filled up with a large one
+    while (!small.empty() && !large.empty())
+    {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+
+        m_probabilities[s] = scaled[s];
+        m_aliases[s] = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // remaining bins are full (rounding errors)
+    for (int l : large)
+        m_probabilities[l] = 1.0;
+    for (int s : small)
+        m_probabilities[s] = 1.0;
+}
+
+void alias_table::clear()
+{
+    m_probabilities.clear();
+    m_aliases.clear();
+    m_pmf.clear();
+    m_total_weight = 0.0;
+}
+
+size_t alias_table::size() const
+{
+    return m_pmf.size();
+}
+
+bool alias_table::empty() const
+{
+    return m_pmf.empty();
+}
+
+int alias_table::sample(double u) const
+{
+    double remapped_u;
+    return sample(u, remapped_u);
+}
+
+int alias_table::sample(double u, double& remapped_u) const
+{
+    const size_t n = m_probabilities.size();
+
+    // first part of u selects the bin, the fractional part selects bin or alias
+    double scaled_u = u * static_cast<double>(n);
+    size_t bin = std::min(static_cast<size_t>(scaled_u), n - 1);
+    double frac = std::min(scaled_u - static_cast<double>(bin), 0.99999999999999989);
+
+    if (frac < m_probabilities[bin])
+    {
+        remapped_u = frac / m_probabilities[bin];
+        return static_cast<int>(bin);
+    }
+
+    remapped_u = (frac - m_probabilities[bin]) / (1.0 - m_probabilities[bin]);
+    return m_aliases[bin];
+}
+
+double alias_table::pmf(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(m_pmf.size()))
+        return 0.0;
+
+    return m_pmf[index];
+}
+
+double alias_table::total_weight() const
+{
+    return m_total_weight;
+}
+
+bool alias_table::write(std::ostream& out) const
+{
+    uint64_t n = m_pmf.size();
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.write(reinterpret_cast<const char*>(&m_total_weight), sizeof(m_total_weight));
+    out.write(reinterpret_cast<const char*>(m_probabilities.data()), n * sizeof(double));
+    out.write(reinterpret_cast<const char*>(m_aliases.data()), n * sizeof(int));
+    out.write(reinterpret_cast<const char*>(m_pmf.data()), n * sizeof(double));
+
+    return out.good();
+}
+
+bool alias_table::read(std::istream& in)
+{
+    clear();
+
+    uint64_t n = 0;
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    in.read(reinterpret_cast<char*>(&m_total_weight), sizeof(m_total_weight));
+    if (!in.good() || n > (uint64_t(1) << 32))
+    {
+        clear();
+        return false;
+    }
+
+    m_probabilities.resize(n);
+    m_aliases.resize(n);
+    m_pmf.resize(n);
+    in.read(reinterpret_cast<char*>(m_probabilities.data()), n * sizeof(double));
+    in.read(reinterpret_cast<char*>(m_aliases.data()), n * sizeof(int));
+    in.read(reinterpret_cast<char*>(m_pmf.data()), n * sizeof(double));
+
+    if (!in.good())
+    {
+        clear();
+        return false;
+    }
+
+    return true;
+}
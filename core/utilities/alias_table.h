@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+/// <summary>
+/// Walker alias table
+/// Samples an index proportionally to a set of weights in O(1) with a single uniform number
+/// https://en.wikipedia.org/wiki/Alias_method (Vose construction)
+/// </summary>
+class alias_table
+{
+public:
+    alias_table() = default;
+    alias_table(const std::vector<double>& weights);
+
+    /// <summary>
+    /// Build the table from (non negative) weights, an all zero set of weights gives an uniform distribution
+    /// </summary>
+    void build(const std::vector<double>& weights);
+
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+
+    /// <summary>
+    /// Sample an index with a uniform number in [0, 1)
+    /// </summary>
+    int sample(double u) const;
+
+    /// <summary>
+    /// Sample an index with a uniform number in [0, 1) and return the remapped uniform number (can be reused for another dimension)
+    /// </summary>
+    int sample(double u, double& remapped_u) const;
+
+    /// <summary>
+    /// Probability to pick the given index
+    /// </summary>
+    double pmf(int index) const;
+
+    /// <summary>
+    /// Sum of the weights used to build the table
+    /// </summary>
+    double total_weight() const;
+
+    /// <summary>
+    /// Binary serialization (precomputed tables can be cached on disk)
+    /// </summary>
+    bool write(std::ostream& out) const;
+    bool read(std::istream& in);
+
+private:
+    std::vector<double> m_probabilities; // probability to keep the bin (else take alias)
+    std::vector<int> m_aliases;
+    std::vector<double> m_pmf;
+    double m_total_weight = 0.0;
+};
@@ -1,6 +1,9 @@
 #include "bitmap_image.h"
 
 #include "../utilities/interval.h"
+#include "../utilities/half.h"
+#include "../utilities/block_compression.h"
+#include "../utilities/thread_pool.h"
 
 
 
@@ -12,14 +15,42 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+#include <tinyexr.h>
 
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 
+namespace
+{
+    // spread the low bits of v to the even bits (Morton order)
+    uint32_t part_1by1(uint32_t v)
+    {
+        v &= 0x1F;
+        v = (v | (v << 4)) & 0x0F0F;
+        v = (v | (v << 2)) & 0x3333;
+        v = (v | (v << 1)) & 0x5555;
+        return v;
+    }
+}
+
+std::string image_decode_options::key() const
+{
+    static const char* layouts[] = { "linear", "morton", "block", "auto" };
+    static const char* compressions[] = { "raw", "bc1", "bc5", "auto" };
+    return std::string(keep_hdr ? "hdr" : "ldr") + (mipmaps ? "|mip|" : "|") + layouts[static_cast<int>(layout)]
+        + "|" + compressions[static_cast<int>(compression)] + (normal_map ? "|normal" : "");
+}
+
 bitmap_image::bitmap_image() : data(nullptr)
 {
 }
 
-bitmap_image::bitmap_image(std::string filepath)
+bitmap_image::bitmap_image(std::string filepath, const image_decode_options& options)
 {
     // Loads image data from the specified file. If the RTW_IMAGES environment variable is
     // defined, looks only in that directory for the image file. If the image was not found,
@@ -28,90 +59,566 @@ bitmap_image::bitmap_image(std::string filepath)
     // parent, on so on, for six levels up. If the image was not loaded successfully,
     // width() and height() will return 0.
 
-    std::filesystem::path dir(std::filesystem::current_path());
-    std::filesystem::path file(filepath);
-    std::filesystem::path fullImagePath = dir / file;
-
-    auto fullImageAbsPath = std::filesystem::absolute(fullImagePath);
+    std::string fullImageAbsPath = resolve_path(filepath);
 
     if (std::filesystem::exists(fullImageAbsPath))
     {
-        if (!load(fullImageAbsPath.generic_string()))
+        if (!load(fullImageAbsPath, options))
         {
-            std::cerr << "[ERROR] Could not load image file '" << fullImageAbsPath.generic_string() << "'" << std::endl;
+            std::cerr << "[ERROR] Could not load image file '" << fullImageAbsPath << "'" << std::endl;
         }
 
         return;
     }
     else
     {
-        std::cerr << "[ERROR] Image not found '" << fullImageAbsPath.generic_string() << "'" << std::endl;
+        std::cerr << "[ERROR] Image not found '" << fullImageAbsPath << "'" << std::endl;
     }
 }
 
+std::string bitmap_image::resolve_path(const std::string& filepath)
+{
+    std::filesystem::path dir(std::filesystem::current_path());
+    std::filesystem::path file(filepath);
+    std::filesystem::path fullImagePath = std::filesystem::absolute(dir / file);
+
+    // remove the ./ and ../ parts and follow symlinks so that two spellings of the same file match
+    std::error_code ec;
+    std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(fullImagePath, ec);
+
+    return ec ? fullImagePath.generic_string() : canonicalPath.generic_string();
+}
+
 bitmap_image::~bitmap_image()
 {
     STBI_FREE(data);
 }
 
-bool bitmap_image::load(const std::string filepath)
+bool bitmap_image::load(const std::string filepath, const image_decode_options& options)
 {
     // Loads image data from the given file name. Returns true if the load succeeded.
-    auto n = bytes_per_pixel; // Dummy out parameter: original components per pixel
-    data = stbi_load(filepath.c_str(), &image_width, &image_height, &n, bytes_per_pixel);
+    hdr_data.clear();
+    hdr_offsets.clear();
+
+    if (is_hdr_file(filepath))
+    {
+        if (!load_hdr(filepath, options.keep_hdr))
+            return false;
+    }
+    else
+    {
+        auto n = bytes_per_pixel; // Dummy out parameter: original components per pixel
+        data = stbi_load(filepath.c_str(), &image_width, &image_height, &n, bytes_per_pixel);
+    }
 
     image_channels = bytes_per_pixel;
 
     bytes_per_scanline = image_width * bytes_per_pixel;
-    return data != nullptr;
+
+    mip_levels.clear();
+    if (options.mipmaps && data != nullptr)
+        build_mipmaps();
+
+    // block compression already stores 4x4 blocks, it takes precedence over the swizzled layouts (HDR radiance is never compressed)
+    if (data != nullptr && hdr_data.empty() && (options.compression == texture_compression::bc1 || options.compression == texture_compression::bc5))
+        compress(options.compression);
+    else if (data != nullptr && (options.layout == texel_layout::morton || options.layout == texel_layout::block))
+        swizzle(options.layout);
+
+    return is_loaded();
+}
+
+void bitmap_image::compress(texture_compression target)
+{
+    const int block_bytes = (target == texture_compression::bc5) ? block_compression::bc5_block_bytes : block_compression::bc1_block_bytes;
+
+    m_compression = target;
+    compressed_levels.resize(1 + mip_levels.size());
+
+    for (int level = 0; level < static_cast<int>(compressed_levels.size()); level++)
+    {
+        compressed_level& c = compressed_levels[level];
+        c.width = (level == 0) ? image_width : mip_levels[level - 1].width;
+        c.height = (level == 0) ? image_height : mip_levels[level - 1].height;
+        c.blocks_x = (c.width + 3) / 4;
+
+        const unsigned char* src = (level == 0) ? data : mip_levels[level - 1].texels.data();
+        const int w = c.width;
+        const int h = c.height;
+        const int blocks_x = c.blocks_x;
+        const int blocks_y = (h + 3) / 4;
+
+        c.blocks.resize(static_cast<size_t>(blocks_x) * blocks_y * block_bytes);
+        uint8_t* dst = c.blocks.data();
+
+        #pragma omp parallel for schedule(static) num_threads(thread_pool::region_threads()) if (blocks_x * blocks_y > 1024)
+        for (int by = 0; by < blocks_y; by++)
+        {
+            for (int bx = 0; bx < blocks_x; bx++)
+            {
+                // blocks crossing the level border repeat its last row/column
+                unsigned char texels[16][3];
+                for (int i = 0; i < 16; i++)
+                {
+                    int x = std::min(bx * 4 + (i & 3), w - 1);
+                    int y = std::min(by * 4 + (i >> 2), h - 1);
+                    std::memcpy(texels[i], src + (static_cast<size_t>(y) * w + x) * bytes_per_pixel, bytes_per_pixel);
+                }
+
+                uint8_t* block = dst + (static_cast<size_t>(by) * blocks_x + bx) * block_bytes;
+                if (target == texture_compression::bc5)
+                    block_compression::encode_bc5(texels, block);
+                else
+                    block_compression::encode_bc1(texels, block);
+            }
+        }
+    }
+
+    // quality of the full resolution level (bc5 only keeps red and green, blue is rebuilt)
+    const int channels = (target == texture_compression::bc5) ? 2 : 3;
+    const int w = image_width;
+    const int h = image_height;
+    double error = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:error) num_threads(thread_pool::region_threads()) if (w * h > 16384)
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            unsigned char rgb[3];
+            decode_texel(compressed_levels[0], x, y, rgb);
+
+            const unsigned char* texel = data + (static_cast<size_t>(y) * w + x) * bytes_per_pixel;
+            for (int c = 0; c < channels; c++)
+                error += static_cast<double>((rgb[c] - texel[c]) * (rgb[c] - texel[c]));
+        }
+    }
+
+    double mse = error / (static_cast<double>(w) * h * channels);
+    m_psnr = (mse > 0.0) ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+
+    // the compressed levels replace the linear ones
+    STBI_FREE(data);
+    data = nullptr;
+    mip_levels.clear();
+}
+
+void bitmap_image::decode_texel(const compressed_level& level, int x, int y, unsigned char rgb[3]) const
+{
+    const size_t block = static_cast<size_t>(y >> 2) * level.blocks_x + (x >> 2);
+    const int i = ((y & 3) << 2) | (x & 3);
+
+    if (m_compression == texture_compression::bc5)
+        block_compression::decode_bc5(level.blocks.data() + block * block_compression::bc5_block_bytes, i, rgb);
+    else
+        block_compression::decode_bc1(level.blocks.data() + block * block_compression::bc1_block_bytes, i, rgb);
+}
+
+texture_compression bitmap_image::compression() const
+{
+    return m_compression;
+}
+
+double bitmap_image::compression_psnr() const
+{
+    return m_psnr;
+}
+
+void bitmap_image::swizzle(texel_layout target)
+{
+    const int edge = (target == texel_layout::block) ? 4 : 32;
+
+    m_layout = target;
+    swizzled_levels.resize(1 + mip_levels.size());
+
+    for (int level = 0; level < static_cast<int>(swizzled_levels.size()); level++)
+    {
+        swizzled_level& s = swizzled_levels[level];
+        s.width = (level == 0) ? image_width : mip_levels[level - 1].width;
+        s.height = (level == 0) ? image_height : mip_levels[level - 1].height;
+        s.stride = (s.width + edge - 1) / edge;
+
+        const unsigned char* src = (level == 0) ? data : mip_levels[level - 1].texels.data();
+        const int w = s.width;
+        const int h = s.height;
+
+        // padding texels stay black, lookups are clamped to the level size
+        s.texels.assign(static_cast<size_t>(s.stride) * edge * ((h + edge - 1) / edge) * edge, 0u);
+
+        #pragma omp parallel for schedule(static) num_threads(thread_pool::region_threads()) if (w * h > 16384)
+        for (int y = 0; y < h; y++)
+        {
+            for (int x = 0; x < w; x++)
+            {
+                const unsigned char* texel = src + (static_cast<size_t>(y) * w + x) * bytes_per_pixel;
+                unsigned char* dst = reinterpret_cast<unsigned char*>(&s.texels[swizzled_index(s, x, y)]);
+                dst[0] = texel[0];
+                dst[1] = texel[1];
+                dst[2] = texel[2];
+            }
+        }
+    }
+
+    // the swizzled levels replace the linear ones
+    STBI_FREE(data);
+    data = nullptr;
+    mip_levels.clear();
+}
+
+size_t bitmap_image::swizzled_index(const swizzled_level& level, int x, int y) const
+{
+    if (m_layout == texel_layout::block)
+        return ((static_cast<size_t>(y >> 2) * level.stride + (x >> 2)) << 4) | static_cast<size_t>(((y & 3) << 2) | (x & 3));
+
+    return ((static_cast<size_t>(y >> 5) * level.stride + (x >> 5)) << 10) | (part_1by1(x) | (part_1by1(y) << 1));
+}
+
+bool bitmap_image::is_loaded() const
+{
+    return data != nullptr || !swizzled_levels.empty() || !compressed_levels.empty();
+}
+
+texel_layout bitmap_image::layout() const
+{
+    return m_layout;
+}
+
+bool bitmap_image::read_size(const std::string& filepath, int& width, int& height)
+{
+    // header only, nothing is decoded
+    int channels = 0;
+    return stbi_info(resolve_path(filepath).c_str(), &width, &height, &channels) != 0;
+}
+
+bool bitmap_image::is_hdr_file(const std::string& filepath)
+{
+    std::string extension = std::filesystem::path(filepath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    return extension == ".hdr" || extension == ".exr";
+}
+
+bool bitmap_image::load_hdr(const std::string& filepath, bool keep_hdr)
+{
+    // decoded once as floats, the 8 bits data is derived from them
+    float* pixels = nullptr;
+    int pixel_stride = bytes_per_pixel;
+
+    std::string extension = std::filesystem::path(filepath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".exr")
+    {
+        const char* error = nullptr;
+        if (LoadEXR(&pixels, &image_width, &image_height, filepath.c_str(), &error) != TINYEXR_SUCCESS)
+        {
+            if (error)
+            {
+                std::cerr << "[ERROR] " << error << std::endl;
+                FreeEXRErrorMessage(error);
+            }
+            return false;
+        }
+
+        pixel_stride = 4; // tinyexr always gives rgba
+    }
+    else
+    {
+        int n = 0;
+        pixels = stbi_loadf(filepath.c_str(), &image_width, &image_height, &n, bytes_per_pixel);
+        if (pixels == nullptr)
+            return false;
+    }
+
+    const size_t count = static_cast<size_t>(image_width) * image_height;
+
+    // tone mapped like stb does for its 8 bits view of HDR files (gamma 2.2, clamped)
+    data = static_cast<unsigned char*>(STBI_MALLOC(count * bytes_per_pixel));
+    if (keep_hdr)
+        hdr_data.resize(count * bytes_per_pixel);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int c = 0; c < bytes_per_pixel; c++)
+        {
+            float radiance = std::max(pixels[i * pixel_stride + c], 0.0f);
+            if (radiance != radiance)
+                radiance = 0.0f;
+
+            float ldr = std::pow(std::min(radiance, 1.0f), 1.0f / 2.2f) * 255.0f + 0.5f;
+            data[i * bytes_per_pixel + c] = static_cast<unsigned char>(std::min(ldr, 255.0f));
+
+            // half floats top at 65504
+            if (keep_hdr)
+                hdr_data[i * bytes_per_pixel + c] = float_to_half(std::min(radiance, 65504.0f));
+        }
+    }
+
+    if (keep_hdr)
+        hdr_offsets.push_back(0);
+
+    // tinyexr allocates with malloc, stb with STBI_MALLOC (malloc by default)
+    if (extension == ".exr")
+        free(pixels);
+    else
+        stbi_image_free(pixels);
+
+    return true;
+}
+
+void bitmap_image::build_mipmaps()
+{
+    int src_width = image_width;
+    int src_height = image_height;
+    const unsigned char* src = data;
+
+    while (src_width > 1 || src_height > 1)
+    {
+        mip_level level;
+        level.width = std::max(1, src_width / 2);
+        level.height = std::max(1, src_height / 2);
+        level.texels.resize(static_cast<size_t>(level.width) * level.height * bytes_per_pixel);
+
+        // 2x2 box filter, the last row/column of odd sizes is clamped
+        const int w = level.width;
+        const int h = level.height;
+        const int sw = src_width;
+        const int sh = src_height;
+        unsigned char* dst = level.texels.data();
+
+        #pragma omp parallel for schedule(static) num_threads(thread_pool::region_threads()) if (w * h > 16384)
+        for (int y = 0; y < h; y++)
+        {
+            int y0 = std::min(2 * y, sh - 1);
+            int y1 = std::min(2 * y + 1, sh - 1);
+
+            for (int x = 0; x < w; x++)
+            {
+                int x0 = std::min(2 * x, sw - 1);
+                int x1 = std::min(2 * x + 1, sw - 1);
+
+                for (int c = 0; c < bytes_per_pixel; c++)
+                {
+                    int sum = src[(y0 * sw + x0) * bytes_per_pixel + c] + src[(y0 * sw + x1) * bytes_per_pixel + c]
+                        + src[(y1 * sw + x0) * bytes_per_pixel + c] + src[(y1 * sw + x1) * bytes_per_pixel + c];
+
+                    dst[(y * w + x) * bytes_per_pixel + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        // same box filter on the radiance
+        if (!hdr_offsets.empty())
+        {
+            const size_t src_offset = hdr_offsets.back();
+            const size_t dst_offset = hdr_data.size();
+            hdr_data.resize(dst_offset + static_cast<size_t>(w) * h * bytes_per_pixel);
+            hdr_offsets.push_back(dst_offset);
+
+            uint16_t* hdr = hdr_data.data();
+
+            #pragma omp parallel for schedule(static) num_threads(thread_pool::region_threads()) if (w * h > 16384)
+            for (int y = 0; y < h; y++)
+            {
+                int y0 = std::min(2 * y, sh - 1);
+                int y1 = std::min(2 * y + 1, sh - 1);
+
+                for (int x = 0; x < w; x++)
+                {
+                    int x0 = std::min(2 * x, sw - 1);
+                    int x1 = std::min(2 * x + 1, sw - 1);
+
+                    for (int c = 0; c < bytes_per_pixel; c++)
+                    {
+                        float sum = half_to_float(hdr[src_offset + (y0 * sw + x0) * bytes_per_pixel + c]) + half_to_float(hdr[src_offset + (y0 * sw + x1) * bytes_per_pixel + c])
+                            + half_to_float(hdr[src_offset + (y1 * sw + x0) * bytes_per_pixel + c]) + half_to_float(hdr[src_offset + (y1 * sw + x1) * bytes_per_pixel + c]);
+
+                        hdr[dst_offset + (y * w + x) * bytes_per_pixel + c] = float_to_half(0.25f * sum);
+                    }
+                }
+            }
+        }
+
+        mip_levels.push_back(std::move(level));
+
+        src = mip_levels.back().texels.data();
+        src_width = mip_levels.back().width;
+        src_height = mip_levels.back().height;
+    }
 }
 
 int bitmap_image::width()  const
 {
-    return (data == nullptr) ? 0 : image_width;
+    return is_loaded() ? image_width : 0;
 }
 
 int bitmap_image::height() const
 {
-    return (data == nullptr) ? 0 : image_height;
+    return is_loaded() ? image_height : 0;
 }
 
 int bitmap_image::channels() const
 {
-    return (data == nullptr) ? 0 : bytes_per_pixel;
+    return is_loaded() ? bytes_per_pixel : 0;
 }
 
 unsigned char* bitmap_image::get_data() const
 {
-    return data;
+    if (swizzled_levels.empty() && compressed_levels.empty())
+        return data;
+
+    std::call_once(linear_once, [this]()
+    {
+        linear_copy.resize(static_cast<size_t>(image_width) * image_height * bytes_per_pixel);
+        for (int y = 0; y < image_height; y++)
+            for (int x = 0; x < image_width; x++)
+                std::memcpy(&linear_copy[(static_cast<size_t>(y) * image_width + x) * bytes_per_pixel], pixel_data(x, y, 0).rgb, bytes_per_pixel);
+    });
+
+    return linear_copy.data();
 }
 
-float* bitmap_image::get_data_float() const
+std::vector<float> bitmap_image::get_data_float() const
 {
-	size_t numElements = image_width * image_height * bytes_per_pixel;
-	float* floatArray = new float[numElements];
-	for (size_t i = 0; i < numElements; ++i)
+    size_t numElements = static_cast<size_t>(width()) * height() * bytes_per_pixel;
+    std::vector<float> floatArray(numElements);
+
+    if (is_hdr())
     {
-		floatArray[i] = static_cast<float>(data[i]) / 255.0f; // Normalize to [0, 1]
-	}
+        for (size_t i = 0; i < numElements; ++i)
+            floatArray[i] = half_to_float(hdr_data[i]);
 
-    // TODO free memory !
-    //stbi_image_free(image);
-    //delete[] floatImage;
+        return floatArray;
+    }
+
+    const unsigned char* pixels = get_data();
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        floatArray[i] = static_cast<float>(pixels[i]) / 255.0f; // Normalize to [0, 1]
+    }
 
     return floatArray;
 }
 
-const unsigned char* bitmap_image::pixel_data(int x, int y) const
+bool bitmap_image::is_hdr() const
+{
+    return !hdr_data.empty();
+}
+
+const uint16_t* bitmap_image::get_hdr_data() const
+{
+    return hdr_data.empty() ? nullptr : hdr_data.data();
+}
+
+color bitmap_image::hdr_pixel(int x, int y, int level) const
+{
+    const int w = level_width(level);
+
+    x = clamp(x, 0, w);
+    y = clamp(y, 0, level_height(level));
+
+    const uint16_t* texel = hdr_data.data() + hdr_offsets[level] + (static_cast<size_t>(y) * w + x) * bytes_per_pixel;
+    return color(half_to_float(texel[0]), half_to_float(texel[1]), half_to_float(texel[2]));
+}
+
+size_t bitmap_image::memory_size() const
+{
+    size_t bytes = hdr_data.size() * sizeof(uint16_t);
+    if (data != nullptr)
+        bytes += static_cast<size_t>(image_width) * image_height * bytes_per_pixel;
+
+    for (const auto& level : mip_levels)
+        bytes += level.texels.size();
+
+    for (const auto& level : swizzled_levels)
+        bytes += level.texels.size() * sizeof(uint32_t);
+
+    for (const auto& level : compressed_levels)
+        bytes += level.blocks.size();
+
+    return bytes + linear_copy.size();
+}
+
+int bitmap_image::levels() const
+{
+    if (!compressed_levels.empty())
+        return static_cast<int>(compressed_levels.size());
+
+    if (!swizzled_levels.empty())
+        return static_cast<int>(swizzled_levels.size());
+
+    return (data == nullptr) ? 0 : 1 + static_cast<int>(mip_levels.size());
+}
+
+int bitmap_image::level_width(int level) const
+{
+    if (!compressed_levels.empty())
+        return compressed_levels[level].width;
+
+    if (!swizzled_levels.empty())
+        return swizzled_levels[level].width;
+
+    return (level <= 0) ? width() : mip_levels[level - 1].width;
+}
+
+int bitmap_image::level_height(int level) const
+{
+    if (!compressed_levels.empty())
+        return compressed_levels[level].height;
+
+    if (!swizzled_levels.empty())
+        return swizzled_levels[level].height;
+
+    return (level <= 0) ? height() : mip_levels[level - 1].height;
+}
+
+texel_rgb8 bitmap_image::pixel_data(int x, int y, int level) const
+{
+    texel_rgb8 texel;
+
+    if (!compressed_levels.empty())
+    {
+        const compressed_level& c = compressed_levels[level];
+        decode_texel(c, clamp(x, 0, c.width), clamp(y, 0, c.height), texel.rgb);
+
+        return texel;
+    }
+
+    if (!swizzled_levels.empty())
+    {
+        const swizzled_level& s = swizzled_levels[level];
+
+        x = clamp(x, 0, s.width);
+        y = clamp(y, 0, s.height);
+
+        std::memcpy(texel.rgb, &s.texels[swizzled_index(s, x, y)], bytes_per_pixel);
+        return texel;
+    }
+
+    if (level <= 0 || data == nullptr)
+        return pixel_data(x, y);
+
+    const mip_level& mip = mip_levels[level - 1];
+
+    x = clamp(x, 0, mip.width);
+    y = clamp(y, 0, mip.height);
+
+    std::memcpy(texel.rgb, mip.texels.data() + (static_cast<size_t>(y) * mip.width + x) * bytes_per_pixel, bytes_per_pixel);
+    return texel;
+}
+
+texel_rgb8 bitmap_image::pixel_data(int x, int y) const
 {
-    // Return the address of the three bytes of the pixel at x,y (or magenta if no data).
-    static unsigned char magenta[] = { 255, 0, 255 };
-    if (data == nullptr) return magenta;
+    // Return the three bytes of the pixel at x,y (or magenta if no data).
+    if (!swizzled_levels.empty() || !compressed_levels.empty()) return pixel_data(x, y, 0);
+    if (data == nullptr) return texel_rgb8{ { 255, 0, 255 } };
 
     x = clamp(x, 0, image_width);
     y = clamp(y, 0, image_height);
 
-    return data + y * bytes_per_scanline + x * bytes_per_pixel;
+    texel_rgb8 texel;
+    std::memcpy(texel.rgb, data + y * bytes_per_scanline + x * bytes_per_pixel, bytes_per_pixel);
+    return texel;
 }
 
 uint8_t* bitmap_image::buildPNG(std::vector<std::vector<color>> image, const int width, const int height, const int samples_per_pixel, bool gamma_correction)
@@ -7,28 +7,139 @@
 
 #include "../misc/color.h"
 
+#include <cstdint>
+#include <mutex>
+#include <string>
 #include <vector>
 
+/// <summary>
+/// Memory order of the texels sampled by the textures
+/// </summary>
+enum class texel_layout
+{
+    linear = 0, // rows of 3 bytes texels (stb layout)
+    morton = 1, // 32x32 tiles in row order, Z order inside a tile, 4 bytes texels
+    block = 2, // 4x4 blocks in row order, 4 bytes texels
+    automatic = 3 // default layout of the texture registry
+};
+
+/// <summary>
+/// Block compression of the 8 bits texels, decoded on every lookup
+/// </summary>
+enum class texture_compression
+{
+    none = 0,
+    bc1 = 1, // rgb, 4 bits per texel
+    bc5 = 2, // red and green of normal maps, 8 bits per texel (blue is rebuilt)
+    automatic = 3 // default compression of the texture registry
+};
+
+/// <summary>
+/// Options changing the decoded data of an image (part of the texture registry key)
+/// </summary>
+struct image_decode_options
+{
+    bool keep_hdr = true; // keep the radiance of .hdr/.exr files (half floats) next to the 8 bits data
+    bool mipmaps = true; // build the MIP pyramid for filtered lookups
+    texel_layout layout = texel_layout::automatic;
+    texture_compression compression = texture_compression::automatic;
+    bool normal_map = false; // tangent space normals, compressed as bc5
+
+    std::string key() const;
+};
+
+/// <summary>
+/// 8 bits rgb texel returned by value (compressed texels are decoded on the fly, there is no stored texel to point to)
+/// </summary>
+struct texel_rgb8
+{
+    unsigned char rgb[3] = { 0, 0, 0 };
+
+    unsigned char operator[](int i) const { return rgb[i]; }
+};
+
 class bitmap_image
 {
 public:
     bitmap_image();
-    bitmap_image(std::string filepath);
+    bitmap_image(std::string filepath, const image_decode_options& options = {});
     
     ~bitmap_image();
 
+    // owns the stb buffer
+    bitmap_image(const bitmap_image&) = delete;
+    bitmap_image& operator=(const bitmap_image&) = delete;
 
+    bool load(const std::string filepath, const image_decode_options& options = {});
 
-    bool load(const std::string filepath);
+    /// <summary>
+    /// Absolute canonical path of an image file (relative paths are resolved from the working directory)
+    /// </summary>
+    static std::string resolve_path(const std::string& filepath);
 
     int width()  const;
     int height() const;
     int channels() const;
 
     unsigned char* get_data() const;
-    float* get_data_float() const;
 
-    const unsigned char* pixel_data(int x, int y) const;
+    /// <summary>
+    /// RGB data as floats (radiance of HDR images, [0,1] otherwise)
+    /// </summary>
+    std::vector<float> get_data_float() const;
+
+    /// <summary>
+    /// True when the file holds high dynamic range data (.hdr, .exr)
+    /// </summary>
+    bool is_hdr() const;
+
+    /// <summary>
+    /// Linear RGB half float data of an HDR image (nullptr for 8 bits images)
+    /// </summary>
+    const uint16_t* get_hdr_data() const;
+
+    /// <summary>
+    /// Radiance of a texel of an HDR image (coordinates are clamped to the level size)
+    /// </summary>
+    color hdr_pixel(int x, int y, int level) const;
+
+    /// <summary>
+    /// True for the high dynamic range file formats (.hdr, .exr)
+    /// </summary>
+    static bool is_hdr_file(const std::string& filepath);
+
+    /// <summary>
+    /// Size of an 8 bits image file read from its header (false if it can't be read)
+    /// </summary>
+    static bool read_size(const std::string& filepath, int& width, int& height);
+
+    /// <summary>
+    /// Bytes held by the decoded data (8 bits and HDR float copies)
+    /// </summary>
+    size_t memory_size() const;
+
+    texel_rgb8 pixel_data(int x, int y) const;
+
+    /// <summary>
+    /// MIP levels (level 0 is the full resolution image, each next one is half the size down to 1x1)
+    /// </summary>
+    int levels() const;
+    int level_width(int level) const;
+    int level_height(int level) const;
+
+    /// <summary>
+    /// Pixel of a MIP level (coordinates are clamped to the level size)
+    /// </summary>
+    texel_rgb8 pixel_data(int x, int y, int level) const;
+
+    texel_layout layout() const;
+
+    texture_compression compression() const;
+
+    /// <summary>
+    /// Peak signal to noise ratio (dB) of the compressed level 0 against the decoded file (0 when not compressed)
+    /// </summary>
+    double compression_psnr() const;
 
     static uint8_t* buildPNG(std::vector<std::vector<color>> pixels, const int width, const int height, const int samples_per_pixel, bool gamma_correction);
     static bool saveAsPNG(const std::string& filename, int width, int height, int comp, const uint8_t* data, int strides_per_byte);
@@ -40,6 +151,57 @@ private:
     int image_height = 0;
     int image_channels = 0;
     int bytes_per_scanline = 0;
+    std::vector<uint16_t> hdr_data; // level 0, then every MIP level (same sizes as the 8 bits levels)
+    std::vector<size_t> hdr_offsets; // first texel of each level in hdr_data
+
+    bool load_hdr(const std::string& filepath, bool keep_hdr);
+
+    struct mip_level
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> texels; // rgb, same layout as data
+    };
+
+    std::vector<mip_level> mip_levels; // levels 1 and above
+
+    void build_mipmaps();
+
+    // swizzled layouts : every level (0 included) is stored as rgbx texels, the linear data is released
+    struct swizzled_level
+    {
+        int width = 0;
+        int height = 0;
+        int stride = 0; // tiles (or blocks) per row
+        std::vector<uint32_t> texels;
+    };
+
+    texel_layout m_layout = texel_layout::linear;
+    std::vector<swizzled_level> swizzled_levels;
+
+    // rows of rgb texels rebuilt on demand for the code reading the raw data of a swizzled image
+    mutable std::once_flag linear_once;
+    mutable std::vector<unsigned char> linear_copy;
+
+    // compressed levels : every level (0 included) is stored as 4x4 blocks, the linear data is released
+    struct compressed_level
+    {
+        int width = 0;
+        int height = 0;
+        int blocks_x = 0;
+        std::vector<uint8_t> blocks;
+    };
+
+    texture_compression m_compression = texture_compression::none;
+    std::vector<compressed_level> compressed_levels;
+    double m_psnr = 0.0;
+
+    void compress(texture_compression target);
+    void decode_texel(const compressed_level& level, int x, int y, unsigned char rgb[3]) const;
+
+    void swizzle(texel_layout target);
+    size_t swizzled_index(const swizzled_level& level, int x, int y) const;
+    bool is_loaded() const;
 
     static int clamp(int x, int low, int high)
     {
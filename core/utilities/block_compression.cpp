@@ -0,0 +1,227 @@
+#include "block_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    uint16_t to_565(float r, float g, float b)
+    {
+        int ri = std::clamp(static_cast<int>(std::lround(r * 31.0f / 255.0f)), 0, 31);
+        int gi = std::clamp(static_cast<int>(std::lround(g * 63.0f / 255.0f)), 0, 63);
+        int bi = std::clamp(static_cast<int>(std::lround(b * 31.0f / 255.0f)), 0, 31);
+        return static_cast<uint16_t>((ri << 11) | (gi << 5) | bi);
+    }
+
+    void from_565(uint16_t c, int rgb[3])
+    {
+        // bit replication, 31 -> 255 and 63 -> 255
+        int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    void bc1_palette(uint16_t c0, uint16_t c1, int palette[4][3])
+    {
+        from_565(c0, palette[0]);
+        from_565(c1, palette[1]);
+
+        for (int k = 0; k < 3; k++)
+        {
+            if (c0 > c1)
+            {
+                palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+                palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+            }
+            else
+            {
+                palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+                palette[3][k] = 0;
+            }
+        }
+    }
+
+    void bc4_palette(int a0, int a1, int palette[8])
+    {
+        palette[0] = a0;
+        palette[1] = a1;
+
+        if (a0 > a1)
+        {
+            for (int k = 1; k <= 6; k++)
+                palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+        }
+        else
+        {
+            for (int k = 1; k <= 4; k++)
+                palette[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    void encode_bc4(const unsigned char rgb[16][3], int channel, uint8_t block[8])
+    {
+        int lo = 255, hi = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            lo = std::min<int>(lo, rgb[i][channel]);
+            hi = std::max<int>(hi, rgb[i][channel]);
+        }
+
+        // 8 values mode (a0 > a1), a flat block uses index 0 everywhere
+        int palette[8];
+        bc4_palette(hi, lo, palette);
+
+        uint64_t indices = 0;
+        if (hi > lo)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                int best = 0, best_error = 256;
+                for (int k = 0; k < 8; k++)
+                {
+                    int error = std::abs(palette[k] - rgb[i][channel]);
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        best = k;
+                    }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+
+        block[0] = static_cast<uint8_t>(hi);
+        block[1] = static_cast<uint8_t>(lo);
+        for (int b = 0; b < 6; b++)
+            block[2 + b] = static_cast<uint8_t>(indices >> (8 * b));
+    }
+
+    int decode_bc4(const uint8_t* block, int i)
+    {
+        uint64_t indices = 0;
+        for (int b = 0; b < 6; b++)
+            indices |= static_cast<uint64_t>(block[2 + b]) << (8 * b);
+
+        int palette[8];
+        bc4_palette(block[0], block[1], palette);
+
+        return palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+void block_compression::encode_bc1(const unsigned char rgb[16][3], uint8_t block[bc1_block_bytes])
+{
+    // principal axis of the block colors (power iteration on the covariance)
+    float mean[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+        for (int k = 0; k < 3; k++)
+            mean[k] += rgb[i][k] / 16.0f;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 }; // rr rg rb gg gb bb
+    for (int i = 0; i < 16; i++)
+    {
+        float d[3] = { rgb[i][0] - mean[0], rgb[i][1] - mean[1], rgb[i][2] - mean[2] };
+        cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+
+    float axis[3] = { 0.577f, 0.577f, 0.577f };
+    for (int iteration = 0; iteration < 4; iteration++)
+    {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float length = std::sqrt(x * x + y * y + z * z);
+        if (length < 1e-6f)
+            break;
+        axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+    }
+
+    // extreme projections, inset by 1/16 of the range against the quantization
+    float lo = 1e9f, hi = -1e9f;
+    for (int i = 0; i < 16; i++)
+    {
+        float t = (rgb[i][0] - mean[0]) * axis[0] + (rgb[i][1] - mean[1]) * axis[1] + (rgb[i][2] - mean[2]) * axis[2];
+        lo = std::min(lo, t);
+        hi = std::max(hi, t);
+    }
+
+    float inset = (hi - lo) / 16.0f;
+    lo += inset;
+    hi -= inset;
+
+    uint16_t c0 = to_565(mean[0] + hi * axis[0], mean[1] + hi * axis[1], mean[2] + hi * axis[2]);
+    uint16_t c1 = to_565(mean[0] + lo * axis[0], mean[1] + lo * axis[1], mean[2] + lo * axis[2]);
+
+    // 4 colors mode needs c0 > c1
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1)
+    {
+        int palette[4][3];
+        bc1_palette(c0, c1, palette);
+
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, best_error = 1 << 30;
+            for (int k = 0; k < 4; k++)
+            {
+                int dr = palette[k][0] - rgb[i][0], dg = palette[k][1] - rgb[i][1], db = palette[k][2] - rgb[i][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < best_error)
+                {
+                    best_error = error;
+                    best = k;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+
+    block[0] = static_cast<uint8_t>(c0); block[1] = static_cast<uint8_t>(c0 >> 8);
+    block[2] = static_cast<uint8_t>(c1); block[3] = static_cast<uint8_t>(c1 >> 8);
+    for (int b = 0; b < 4; b++)
+        block[4 + b] = static_cast<uint8_t>(indices >> (8 * b));
+}
+
+void block_compression::encode_bc5(const unsigned char rgb[16][3], uint8_t block[bc5_block_bytes])
+{
+    encode_bc4(rgb, 0, block);
+    encode_bc4(rgb, 1, block + 8);
+}
+
+void block_compression::decode_bc1(const uint8_t* block, int i, unsigned char rgb[3])
+{
+    uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+    uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+
+    int palette[4][3];
+    bc1_palette(c0, c1, palette);
+
+    const int* c = palette[(indices >> (2 * i)) & 3];
+    rgb[0] = static_cast<unsigned char>(c[0]);
+    rgb[1] = static_cast<unsigned char>(c[1]);
+    rgb[2] = static_cast<unsigned char>(c[2]);
+}
+
+void block_compression::decode_bc5(const uint8_t* block, int i, unsigned char rgb[3])
+{
+    int r = decode_bc4(block, i);
+    int g = decode_bc4(block + 8, i);
+
+    // z of a unit normal, stored in [0,1] like the other normal maps
+    float x = r / 127.5f - 1.0f;
+    float y = g / 127.5f - 1.0f;
+    float z = std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+
+    rgb[0] = static_cast<unsigned char>(r);
+    rgb[1] = static_cast<unsigned char>(g);
+    rgb[2] = static_cast<unsigned char>(std::lround((z + 1.0f) * 127.5f));
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+/// <summary>
+/// Block compression of 4x4 texel blocks (BC1 for colors, BC5 for the two channels of normal maps)
+/// BC1 : 8 bytes per block (two 565 endpoints and 2 bits indices), BC5 : 16 bytes per block (two BC4 blocks, 8 bits endpoints and 3 bits indices)
+/// Encoders are range fits along the principal axis (load time), decoders work on a single texel (lookup time)
+/// </summary>
+namespace block_compression
+{
+    constexpr int bc1_block_bytes = 8;
+    constexpr int bc5_block_bytes = 16;
+
+    /// <summary>
+    /// Encode 16 rgb texels (row order inside the block)
+    /// </summary>
+    void encode_bc1(const unsigned char rgb[16][3], uint8_t block[bc1_block_bytes]);
+
+    /// <summary>
+    /// Encode the red and green channels of 16 rgb texels
+    /// </summary>
+    void encode_bc5(const unsigned char rgb[16][3], uint8_t block[bc5_block_bytes]);
+
+    /// <summary>
+    /// Decode texel i (0..15) of a block
+    /// </summary>
+    void decode_bc1(const uint8_t* block, int i, unsigned char rgb[3]);
+
+    /// <summary>
+    /// Decode texel i (0..15) of a block, blue is rebuilt from red and green (unit length tangent space normal)
+    /// </summary>
+    void decode_bc5(const uint8_t* block, int i, unsigned char rgb[3]);
+}
@@ -622,7 +622,7 @@ std::shared_ptr<texture> fbx_mesh_loader::get_texture(const ofbx::Material* mat,
             std::cout << "[INFO] " << textureKindName << " texture " << buffer << std::endl;
 
             if (textureKind == ofbx::Texture::NORMAL)
-                tex = std::make_shared<normal_texture>(std::make_shared<image_texture>(std::string(buffer)), amount);
+                tex = std::make_shared<normal_texture>(std::make_shared<image_texture>(std::string(buffer), image_decode_options{ .normal_map = true }), amount);
             else
                 tex = std::make_shared<image_texture>(std::string(buffer));
         }
@@ -640,7 +640,7 @@ void fbx_mesh_loader::computeTangentBasis(std::array<vector3, 3>& vertices, std:
 		vector2 deltaUV1 = uvs[1] - uvs[0];
 		vector2 deltaUV2 = uvs[2] - uvs[0];
 
-		double r = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
+		rreal r = rreal(1) / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
 		vector3 tangent = (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
 		vector3 bitangent = (deltaPos2 * deltaUV1.x - deltaPos1 * deltaUV2.x) * r;
 
@@ -834,8 +834,8 @@ void fbx_mesh_loader::apply_transformation_to_directional(const ofbx::DMatrix& m
     vector3 transformed_v = transform_vector(matrix, v) - transform_vector(matrix, origin);
 
     // Center the quad around the transformed position
-    u = transformed_u * 0.5;
-    v = transformed_v * 0.5;
+    u = transformed_u * rreal(0.5);
+    v = transformed_v * rreal(0.5);
 
     // Update position to the center of the quad
     pos = pos - u - v; // Adjust position to the new bottom-left corner
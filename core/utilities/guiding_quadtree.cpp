@@ -0,0 +1,178 @@
+#include "guiding_quadtree.h"
+
+#include "../constants.h"
+
+#include <algorithm>
+#include <cmath>
+
+void guiding_quadtree::build(const std::vector<guiding_record>& records, double rho, int max_depth)
+{
+    m_nodes.clear();
+
+    double total = 0.0;
+    for (const auto& r : records)
+        total += r.weight;
+
+    if (records.empty() || total <= 0.0)
+        return;
+
+    std::vector<int> indices(records.size());
+    for (size_t i = 0; i < indices.size(); i++)
+        indices[i] = static_cast<int>(i);
+
+    build_node(records, indices, 0, static_cast<int>(indices.size()), 0.0, 0.0, 1.0, 0, total, rho, max_depth);
+}
+
+int guiding_quadtree::build_node(const std::vector<guiding_record>& records, std::vector<int>& indices, int begin, int end, double u0, double v0, double size, int depth, double total, double rho, int max_depth)
+{
+    int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(node());
+
+    double half = size * 0.5;
+
+    // partition the records in the 4 quadrants
+    auto quadrant_of = [&](const guiding_record& r)
+    {
+        return (r.u >= u0 + half ? 1 : 0) + (r.v >= v0 + half ? 2 : 0);
+    };
+
+    int bounds[5] = { begin, begin, begin, begin, end };
+    for (int q = 0; q < 3; q++)
+    {
+        auto it = std::partition(indices.begin() + bounds[q], indices.begin() + end, [&](int i) { return quadrant_of(records[i]) == q; });
+        bounds[q + 1] = static_cast<int>(it - indices.begin());
+    }
+
+    for (int q = 0; q < 4; q++)
+    {
+        double energy = 0.0;
+        for (int i = bounds[q]; i < bounds[q + 1]; i++)
+            energy += records[indices[i]].weight;
+
+        m_nodes[index].energy[q] = static_cast<float>(energy);
+
+        // refine where the energy is concentrated
+        if (depth + 1 < max_depth && energy > rho * total && bounds[q + 1] - bounds[q] > 1)
+        {
+            double cu = u0 + (q & 1 ? half : 0.0);
+            double cv = v0 + (q & 2 ? half : 0.0);
+            int child = build_node(records, indices, bounds[q], bounds[q + 1], cu, cv, half, depth + 1, total, rho, max_depth);
+            m_nodes[index].child[q] = child;
+        }
+    }
+
+    return index;
+}
+
+bool guiding_quadtree::empty() const
+{
+    return m_nodes.empty();
+}
+
+size_t guiding_quadtree::node_count() const
+{
+    return m_nodes.size();
+}
+
+int guiding_quadtree::quadrant(double& u, double& v)
+{
+    // quadrant of (u, v) in the unit square, (u, v) is remapped to the unit square of the quadrant
+    int q = 0;
+    if (u >= 0.5) { q |= 1; u -= 0.5; }
+    if (v >= 0.5) { q |= 2; v -= 0.5; }
+    u *= 2.0;
+    v *= 2.0;
+    return q;
+}
+
+double guiding_quadtree::pdf(const vector3& direction) const
+{
+    if (m_nodes.empty())
+        return 0.0;
+
+    float fu, fv;
+    to_square(direction, fu, fv);
+    double u = fu, v = fv;
+
+    // density over the unit square
+    double density = 1.0;
+    int index = 0;
+
+    while (true)
+    {
+        const node& n = m_nodes[index];
+        double node_energy = n.energy[0] + n.energy[1] + n.energy[2] + n.energy[3];
+        if (node_energy <= 0.0)
+            return 0.0;
+
+        int q = quadrant(u, v);
+        density *= 4.0 * n.energy[q] / node_energy;
+
+        if (n.child[q] == 0 || density <= 0.0)
+            break;
+
+        index = n.child[q];
+    }
+
+    return density / (4.0 * M_PI);
+}
+
+vector3 guiding_quadtree::sample(randomizer& rnd) const
+{
+    if (m_nodes.empty())
+        return from_square(rnd.get_real(0.0, 1.0), rnd.get_real(0.0, 1.0));
+
+    double u0 = 0.0, v0 = 0.0, size = 1.0;
+    int index = 0;
+
+    while (true)
+    {
+        const node& n = m_nodes[index];
+        double node_energy = n.energy[0] + n.energy[1] + n.energy[2] + n.energy[3];
+
+        // pick a quadrant proportionally to its energy
+        double x = rnd.get_real(0.0, 1.0) * node_energy;
+        int q = 0;
+        while (q < 3 && x >= n.energy[q])
+        {
+            x -= n.energy[q];
+            q++;
+        }
+
+        // skip empty trailing quadrants (rounding)
+        while (q > 0 && n.energy[q] <= 0.0f)
+            q--;
+
+        size *= 0.5;
+        if (q & 1) u0 += size;
+        if (q & 2) v0 += size;
+
+        if (n.child[q] == 0)
+            break;
+
+        index = n.child[q];
+    }
+
+    return from_square(u0 + rnd.get_real(0.0, 1.0) * size, v0 + rnd.get_real(0.0, 1.0) * size);
+}
+
+void guiding_quadtree::to_square(const vector3& direction, float& u, float& v)
+{
+    // u : cos(theta) around z, v : phi
+    double cos_theta = std::clamp(static_cast<double>(direction.z), -1.0, 1.0);
+    double phi = std::atan2(static_cast<double>(direction.y), static_cast<double>(direction.x));
+    if (phi < 0.0)
+        phi += 2.0 * M_PI;
+
+    u = static_cast<float>(std::clamp((cos_theta + 1.0) * 0.5, 0.0, 0.99999994));
+    v = static_cast<float>(std::clamp(phi / (2.0 * M_PI), 0.0, 0.99999994));
+}
+
+vector3 guiding_quadtree::from_square(double u, double v)
+{
+    double cos_theta = 2.0 * u - 1.0;
+    double sin_theta = std::sqrt(std::max(0.0, 1.0 - cos_theta * cos_theta));
+    double phi = 2.0 * M_PI * v;
+
+    return vector3(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "types.h"
+#include "../randomizers/randomizer.h"
+
+#include <vector>
+
+/// <summary>
+/// One radiance sample recorded for path guiding
+/// Direction is stored in the equal area cylindrical square [0, 1]^2 (see guiding_quadtree::to_square)
+/// </summary>
+struct guiding_record
+{
+    point3 position{};
+    float u = 0.0f;
+    float v = 0.0f;
+    float weight = 0.0f; // incident radiance luminance / sampling pdf
+};
+
+/// <summary>
+/// Directional distribution of path guiding (the "D" of an SD-tree)
+/// Quadtree over the equal area square of directions, each quadrant is refined while it holds more than a fraction of the energy
+/// Sampling and pdf evaluation walk down the tree, O(depth)
+/// https://tom94.net/data/publications/mueller17practical/mueller17practical.pdf (Muller et al. 2017)
+/// </summary>
+class guiding_quadtree
+{
+public:
+    guiding_quadtree() = default;
+
+    /// <summary>
+    /// Build the tree from recorded samples, quadrants holding more than rho of the total energy are split (up to max_depth)
+    /// </summary>
+    void build(const std::vector<guiding_record>& records, double rho, int max_depth);
+
+    bool empty() const;
+
+    /// <summary>
+    /// Solid angle pdf of a direction
+    /// </summary>
+    double pdf(const vector3& direction) const;
+
+    /// <summary>
+    /// Unit direction distributed proportionally to the recorded energy
+    /// </summary>
+    vector3 sample(randomizer& rnd) const;
+
+    size_t node_count() const;
+
+    /// <summary>
+    /// Equal area mapping between unit directions and [0, 1]^2
+    /// </summary>
+    static void to_square(const vector3& direction, float& u, float& v);
+    static vector3 from_square(double u, double v);
+
+private:
+    struct node
+    {
+        float energy[4] = { 0, 0, 0, 0 }; // quadrants : 0 (-u,-v), 1 (+u,-v), 2 (-u,+v), 3 (+u,+v)
+        int child[4] = { 0, 0, 0, 0 }; // 0 means leaf quadrant (the root is never a child)
+    };
+
+    std::vector<node> m_nodes;
+
+    int build_node(const std::vector<guiding_record>& records, std::vector<int>& indices, int begin, int end, double u0, double v0, double size, int depth, double total, double rho, int max_depth);
+
+    static int quadrant(double& u, double& v);
+};
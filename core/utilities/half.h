@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/// <summary>
+/// IEEE 754 half precision floats (storage only, the math is done in float)
+/// Used for the HDR texels : 6 bytes per rgb texel instead of 12, with the full range of radiance values (up to 65504)
+/// </summary>
+inline uint16_t float_to_half(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    // infinity and NaN
+    if (exponent == 0xFFu)
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+    int half_exponent = static_cast<int>(exponent) - 127 + 15;
+
+    // overflow : infinity
+    if (half_exponent >= 0x1F)
+        return static_cast<uint16_t>(sign | 0x7C00u);
+
+    // underflow : denormal or zero
+    if (half_exponent <= 0)
+    {
+        if (half_exponent < -10)
+            return static_cast<uint16_t>(sign);
+
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - half_exponent);
+        uint32_t half_mantissa = mantissa >> shift;
+
+        // round to nearest even
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u)))
+            half_mantissa++;
+
+        return static_cast<uint16_t>(sign | half_mantissa);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(half_exponent) << 10) | (mantissa >> 13);
+
+    // round to nearest even (a carry into the exponent is still correct, up to infinity)
+    uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+        half++;
+
+    return static_cast<uint16_t>(half);
+}
+
+inline float half_to_float(uint16_t value)
+{
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+
+    uint32_t bits;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // denormal : normalize it
+            int e = -1;
+            do
+            {
+                e++;
+                mantissa <<= 1;
+            } while ((mantissa & 0x400u) == 0);
+
+            bits = sign | (static_cast<uint32_t>(127 - 15 - e) << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    }
+    else if (exponent == 0x1F)
+    {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    }
+    else
+    {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
@@ -4,7 +4,7 @@ interval::interval() : min(+infinity), max(-infinity)
 {
 }
 
-interval::interval(double _min, double _max) : min(_min), max(_max)
+interval::interval(rreal _min, rreal _max) : min(_min), max(_max)
 {
 }
 
@@ -12,19 +12,19 @@ interval::interval(const interval& a, const interval& b) : min(std::fmin(a.min,
 {
 }
 
-bool interval::contains(double x) const
+bool interval::contains(rreal x) const
 {
     // is value inside the interval ?
     return min <= x && x <= max;
 }
 
-bool interval::surrounds(double x) const
+bool interval::surrounds(rreal x) const
 {
     // is value strictly inside the interval ?
     return min < x && x < max;
 }
 
-double interval::clamp(double x) const
+rreal interval::clamp(rreal x) const
 {
     // clamp smaller or bigger value to the min/max interval values
     if (x < min) return min;
@@ -32,12 +32,12 @@ double interval::clamp(double x) const
     return x;
 }
 
-double interval::size() const
+rreal interval::size() const
 {
     return max - min;
 }
 
-interval interval::expand(double delta) const
+interval interval::expand(rreal delta) const
 {
     auto padding = delta / 2;
     return interval(min - padding, max + padding);
@@ -48,22 +48,22 @@ const interval interval::empty = interval(+infinity, -infinity);
 const interval interval::universe = interval(-infinity, +infinity);
 
 
-interval operator+(const interval& ival, double displacement)
+interval operator+(const interval& ival, rreal displacement)
 {
     return interval(ival.min + displacement, ival.max + displacement);
 }
 
-interval operator+(double displacement, const interval& ival)
+interval operator+(rreal displacement, const interval& ival)
 {
     return ival + displacement;
 }
 
-interval operator*(const interval& ival, double displacement)
+interval operator*(const interval& ival, rreal displacement)
 {
     return interval(ival.min * displacement, ival.max * displacement);
 }
 
-interval operator*(double displacement, const interval& ival)
+interval operator*(rreal displacement, const interval& ival)
 {
     return ival * displacement;
 }
@@ -6,31 +6,31 @@
 class interval
 {
 public:
-    double min, max;
+    rreal min, max;
 
     interval(); // Default interval is empty
-    interval(double _min, double _max);
+    interval(rreal _min, rreal _max);
     interval(const interval& a, const interval& b);
 
 
     // is value inside the interval ?
-    bool contains(double x) const;
+    bool contains(rreal x) const;
 
     // is value strictly inside the interval ?
-    bool surrounds(double x) const;
+    bool surrounds(rreal x) const;
 
     // clamp smaller or bigger value to the min/max interval values
-    double clamp(double x) const;
+    rreal clamp(rreal x) const;
 
-    double size() const;
+    rreal size() const;
 
-    interval expand(double delta) const;
+    interval expand(rreal delta) const;
 
     static const interval empty, universe;
 };
 
-interval operator+(const interval& ival, double displacement);
-interval operator+(double displacement, const interval& ival);
+interval operator+(const interval& ival, rreal displacement);
+interval operator+(rreal displacement, const interval& ival);
 
-interval operator*(const interval& ival, double displacement);
-interval operator*(double displacement, const interval& ival);
\ No newline at end of file
+interval operator*(const interval& ival, rreal displacement);
+interval operator*(rreal displacement, const interval& ival);
\ No newline at end of file
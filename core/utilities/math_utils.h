@@ -55,6 +55,16 @@ static bool near_zero(vector3 v)
     return (fabs(v.x) < s) && (fabs(v.y) < s) && (fabs(v.z) < s);
 }
 
+/// <summary>
+/// Multiple importance sampling weight of strategy a against strategy b (Veach power heuristic, beta = 2)
+/// </summary>
+inline double power_heuristic(double pdf_a, double pdf_b)
+{
+    double a2 = pdf_a * pdf_a;
+    double b2 = pdf_b * pdf_b;
+    return (a2 + b2) > 0.0 ? a2 / (a2 + b2) : 0.0;
+}
+
 inline double degrees_to_radians(double degrees)
 {
     return degrees * M_PI / 180.0;
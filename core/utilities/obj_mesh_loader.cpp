@@ -12,6 +12,7 @@
 #include "../textures/displacement_texture.h"
 #include "../materials/phong_material.h"
 #include "../misc/bvh_node.h"
+#include "../lights/mesh_light.h"
 
 #include <array>
 #include <filesystem>
@@ -85,7 +86,7 @@ bool obj_mesh_loader::load_model_from_file(std::string filepath, obj_mesh_data&
 }
 
 
-std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data& data, std::shared_ptr<material> model_material, bool use_mtl, bool shade_smooth, randomizer& rnd, std::string name)
+std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data& data, std::shared_ptr<material> model_material, bool use_mtl, bool shade_smooth, std::vector<std::shared_ptr<light>>& lights, randomizer& rnd, std::string name)
 {
     hittable_list model_output;
 
@@ -93,6 +94,9 @@ std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data
 
     std::vector<std::shared_ptr<material>> converted_mats;
 
+    // candidates for the mesh light (only emissive ones are kept)
+    std::vector<std::shared_ptr<triangle>> model_triangles;
+
     const bool use_mtl_file = use_mtl && data.materials.size() > 0;
 
     if (use_mtl_file)
@@ -113,7 +117,7 @@ std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data
 
             if (!filepath.empty())
             {
-                auto image_tex = std::make_shared<image_texture>(filepath);
+                auto image_tex = std::make_shared<image_texture>(filepath, image_decode_options{ .compression = texture_compression::none });
                 auto displace_texture = std::make_shared<displacement_texture>(image_tex, strength);
                 if (displace_texture)
                 {
@@ -193,7 +197,7 @@ std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data
                 tri_mat = model_material;
             }
 
-            shape_triangles.add(make_shared<triangle>(
+            auto tri = make_shared<triangle>(
                 s,
                 f,
                 tri_v[0], tri_v[1], tri_v[2],
@@ -201,7 +205,10 @@ std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data
                 tri_uv[0], tri_uv[1], tri_uv[2],
                 tri_tan[0], tri_tan[1], tri_tan[2],
                 tri_bitan[0], tri_bitan[1], tri_bitan[2],
-                shade_smooth, tri_mat));
+                shade_smooth, tri_mat);
+
+            shape_triangles.add(tri);
+            model_triangles.push_back(tri);
 
             index_offset += fv;
 
@@ -214,6 +221,14 @@ std::shared_ptr<hittable> obj_mesh_loader::convert_model_from_file(obj_mesh_data
 
     std::cout << "[INFO] End building obj file" << std::endl;
 
+    // emissive triangles become an area light (distinct name, the mesh keeps its own for the transforms)
+    auto emissive_mesh = std::make_shared<mesh_light>(model_triangles, name + "_light");
+    if (emissive_mesh->size() > 0)
+    {
+        std::cout << "[INFO] Obj file emissive triangles registered as a light (" << emissive_mesh->size() << " triangles)" << std::endl;
+        lights.push_back(emissive_mesh);
+    }
+
 
     // group all objects in the .obj file in a single bvh node
     return std::make_shared<bvh_node>(model_output, rnd, name);
@@ -250,7 +265,7 @@ void obj_mesh_loader::computeTangentBasis(std::array<vector3 ,3>& vertices, std:
         vector2 deltaUV1 = uv1 - uv0;
         vector2 deltaUV2 = uv2 - uv0;
 
-		double r = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
+		rreal r = rreal(1) / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
 		vector3 tangent = (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
         vector3 bitangent = (deltaPos2 * deltaUV1.x - deltaPos1 * deltaUV2.x) * r;
 
@@ -333,15 +348,20 @@ std::shared_ptr<material> obj_mesh_loader::get_mtl_mat(const tinyobj::material_t
         double normal_m = reader_mat.normal_texopt.bump_multiplier;
         
         // normal texture
-        auto normal_tex = std::make_shared<image_texture>(reader_mat.normal_texname);
+        auto normal_tex = std::make_shared<image_texture>(reader_mat.normal_texname, image_decode_options{ .normal_map = true });
         normal_a = std::make_shared<normal_texture>(normal_tex, normal_m);
     }
 
     // emissive
-    // 
+    // map_Ke ..\..\data\models\neon_emissive.jpg
     if (!reader_mat.emissive_texname.empty())
     {
-        
+        emissive_a = std::make_shared<image_texture>(reader_mat.emissive_texname);
+    }
+    else if (reader_mat.emission[0] > 0 || reader_mat.emission[1] > 0 || reader_mat.emission[2] > 0)
+    {
+        // Ke 10.0 10.0 10.0
+        emissive_a = std::make_shared<solid_color_texture>(get_color((tinyobj::real_t*)reader_mat.emission));
     }
 
     // displacement/height
@@ -352,7 +372,7 @@ std::shared_ptr<material> obj_mesh_loader::get_mtl_mat(const tinyobj::material_t
         double displace_m = (double)reader_mat.displacement_texopt.bump_multiplier;
         
         // displace texture
-        auto displace_tex = std::make_shared<image_texture>(reader_mat.displacement_texname);
+        auto displace_tex = std::make_shared<image_texture>(reader_mat.displacement_texname, image_decode_options{ .compression = texture_compression::none });
         displace_a = std::make_shared<displacement_texture>(displace_tex, displace_m);
     }
 
@@ -7,6 +7,10 @@
 #include "../utilities/types.h"
 #include "../textures/displacement_texture.h"
 
+#include <vector>
+
+class light;
+
 class obj_mesh_loader
 {
 public:
@@ -32,7 +36,10 @@ public:
     /// <returns></returns>
     static bool load_model_from_file(std::string filepath, obj_mesh_data& data);
 
-    static std::shared_ptr<hittable> convert_model_from_file(obj_mesh_data& data, std::shared_ptr<material> model_material, bool use_mtl, bool shade_smooth, randomizer& rnd, std::string name = "");
+    /// <summary>
+    /// Emissive triangles are also returned as a mesh light (lights is left empty if the model doesn't emit)
+    /// </summary>
+    static std::shared_ptr<hittable> convert_model_from_file(obj_mesh_data& data, std::shared_ptr<material> model_material, bool use_mtl, bool shade_smooth, std::vector<std::shared_ptr<light>>& lights, randomizer& rnd, std::string name = "");
 
 
 private:
@@ -0,0 +1,218 @@
+#include "quartic_solver.h"
+
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    // Coefficients smaller than this are considered as zero (degenerated polynomial)
+    constexpr double SOLVER_EPSILON = 1e-12;
+
+    // Number of Newton iterations used to refine the closed-form roots
+    constexpr int POLISH_ITERATIONS = 2;
+
+    // 2*pi/3 (angle between the 3 real roots of the trigonometric cubic solution)
+    constexpr double TWO_PI_OVER_3 = 2.09439510239319549231;
+}
+
+int quartic_solver::solve_quadratic(double c2, double c1, double c0, double roots[2])
+{
+    if (std::fabs(c2) < SOLVER_EPSILON)
+    {
+        // linear equation
+        if (std::fabs(c1) < SOLVER_EPSILON)
+            return 0;
+
+        roots[0] = -c0 / c1;
+        return 1;
+    }
+
+    double discriminant = c1 * c1 - 4.0 * c2 * c0;
+    if (discriminant < 0.0)
+        return 0;
+
+    if (discriminant == 0.0)
+    {
+        roots[0] = -0.5 * c1 / c2;
+        return 1;
+    }
+
+    // Numerically stable form (avoids catastrophic cancellation when c1^2 >> 4*c2*c0)
+    double q = -0.5 * (c1 + std::copysign(std::sqrt(discriminant), c1));
+    roots[0] = q / c2;
+    roots[1] = (q != 0.0) ? c0 / q : -roots[0];
+
+    if (roots[0] > roots[1])
+        std::swap(roots[0], roots[1]);
+
+    return 2;
+}
+
+int quartic_solver::solve_cubic(double c3, double c2, double c1, double c0, double roots[3])
+{
+    if (std::fabs(c3) < SOLVER_EPSILON)
+        return solve_quadratic(c2, c1, c0, roots);
+
+    // normalize to x^3 + a*x^2 + b*x + c = 0
+    const double a = c2 / c3;
+    const double b = c1 / c3;
+    const double c = c0 / c3;
+
+    // depressed cubic t^3 + p*t + q = 0 with x = t - a/3
+    const double a_third = a / 3.0;
+    const double p = b - a * a_third;
+    const double q = (2.0 * a * a * a) / 27.0 - (a * b) / 3.0 + c;
+
+    const double half_q = 0.5 * q;
+    const double third_p = p / 3.0;
+    const double discriminant = half_q * half_q + third_p * third_p * third_p;
+
+    int count = 0;
+
+    if (discriminant > 0.0)
+    {
+        // one real root (Cardano, stable variant)
+        double A = -std::copysign(std::cbrt(std::fabs(half_q) + std::sqrt(discriminant)), q);
+        double B = (A != 0.0) ? -third_p / A : 0.0;
+        roots[count++] = A + B - a_third;
+    }
+    else if (p == 0.0)
+    {
+        // triple root
+        roots[count++] = -a_third;
+    }
+    else
+    {
+        // three real roots (trigonometric method)
+        double r = std::sqrt(-third_p);
+        double cos_phi = -half_q / (r * r * r);
+        cos_phi = cos_phi < -1.0 ? -1.0 : (cos_phi > 1.0 ? 1.0 : cos_phi);
+
+        double phi = std::acos(cos_phi) / 3.0;
+        roots[count++] = 2.0 * r * std::cos(phi) - a_third;
+        roots[count++] = 2.0 * r * std::cos(phi - TWO_PI_OVER_3) - a_third;
+        roots[count++] = 2.0 * r * std::cos(phi + TWO_PI_OVER_3) - a_third;
+    }
+
+    sort_roots(roots, count);
+
+    return count;
+}
+
+int quartic_solver::solve_quartic(double c4, double c3, double c2, double c1, double c0, double roots[4])
+{
+    if (std::fabs(c4) < SOLVER_EPSILON)
+        return solve_cubic(c3, c2, c1, c0, roots);
+
+    // normalize to x^4 + a*x^3 + b*x^2 + c*x + d = 0
+    const double a = c3 / c4;
+    const double b = c2 / c4;
+    const double c = c1 / c4;
+    const double d = c0 / c4;
+
+    // depressed quartic y^4 + p*y^2 + q*y + r = 0 with x = y - a/4
+    const double a_quarter = 0.25 * a;
+    const double a2 = a * a;
+    const double p = b - 0.375 * a2;
+    const double q = c - 0.5 * a * b + 0.125 * a2 * a;
+    const double r = d - 0.25 * a * c + 0.0625 * a2 * b - 0.01171875 * a2 * a2;
+
+    int count = 0;
+
+    if (std::fabs(q) < SOLVER_EPSILON)
+    {
+        // biquadratic equation : z = y^2
+        double z[2];
+        int nz = solve_quadratic(1.0, p, r, z);
+        for (int i = 0; i < nz; i++)
+        {
+            if (z[i] < 0.0)
+                continue;
+
+            double y = std::sqrt(z[i]);
+            roots[count++] = y - a_quarter;
+            roots[count++] = -y - a_quarter;
+        }
+    }
+    else
+    {
+        // Ferrari : find m > 0 root of the resolvent cubic m^3 + p*m^2 + (p^2/4 - r)*m - q^2/8 = 0
+        double cubic_roots[3];
+        int nc = solve_cubic(1.0, p, 0.25 * p * p - r, -0.125 * q * q, cubic_roots);
+        double m = cubic_roots[nc - 1];
+
+        // refine m because the quartic roots are very sensitive to it
+        for (int i = 0; i < POLISH_ITERATIONS; i++)
+        {
+            double f = ((m + p) * m + (0.25 * p * p - r)) * m - 0.125 * q * q;
+            double df = (3.0 * m + 2.0 * p) * m + (0.25 * p * p - r);
+            if (df == 0.0)
+                break;
+            m -= f / df;
+        }
+
+        if (m <= 0.0)
+            return 0;
+
+        // y^4 + p*y^2 + q*y + r = (y^2 + p/2 + m)^2 - (s*y - q/(2s))^2 with s = sqrt(2m)
+        double s = std::sqrt(2.0 * m);
+        double half_p_m = 0.5 * p + m;
+        double q_2s = q / (2.0 * s);
+
+        double y[2];
+        int ny = solve_quadratic(1.0, -s, half_p_m + q_2s, y);
+        for (int i = 0; i < ny; i++)
+            roots[count++] = y[i] - a_quarter;
+
+        ny = solve_quadratic(1.0, s, half_p_m - q_2s, y);
+        for (int i = 0; i < ny; i++)
+            roots[count++] = y[i] - a_quarter;
+    }
+
+    for (int i = 0; i < count; i++)
+        roots[i] = polish_quartic_root(c4, c3, c2, c1, c0, roots[i]);
+
+    sort_roots(roots, count);
+
+    return count;
+}
+
+double quartic_solver::polish_quartic_root(double c4, double c3, double c2, double c1, double c0, double x)
+{
+    double f = (((c4 * x + c3) * x + c2) * x + c1) * x + c0;
+
+    for (int i = 0; i < POLISH_ITERATIONS; i++)
+    {
+        double df = ((4.0 * c4 * x + 3.0 * c3) * x + 2.0 * c2) * x + c1;
+        if (df == 0.0)
+            break;
+
+        double x_new = x - f / df;
+        double f_new = (((c4 * x_new + c3) * x_new + c2) * x_new + c1) * x_new + c0;
+
+        // only keep the Newton step when it actually improves the residual
+        if (std::fabs(f_new) >= std::fabs(f))
+            break;
+
+        x = x_new;
+        f = f_new;
+    }
+
+    return x;
+}
+
+void quartic_solver::sort_roots(double* roots, int count)
+{
+    // tiny insertion sort (4 values max)
+    for (int i = 1; i < count; i++)
+    {
+        double key = roots[i];
+        int j = i - 1;
+        while (j >= 0 && roots[j] > key)
+        {
+            roots[j + 1] = roots[j];
+            j--;
+        }
+        roots[j + 1] = key;
+    }
+}
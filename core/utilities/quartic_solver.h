@@ -0,0 +1,32 @@
+#pragma once
+
+/// <summary>
+/// Allocation free closed-form polynomial solvers (quadratic, cubic and quartic)
+/// Used by primitives needing higher degree intersections (torus for example)
+/// Roots are returned sorted in ascending order and polished with a few Newton iterations
+/// </summary>
+class quartic_solver
+{
+public:
+    /// <summary>
+    /// Solve c2*x^2 + c1*x + c0 = 0
+    /// </summary>
+    /// <returns>Number of real roots written in roots</returns>
+    static int solve_quadratic(double c2, double c1, double c0, double roots[2]);
+
+    /// <summary>
+    /// Solve c3*x^3 + c2*x^2 + c1*x + c0 = 0
+    /// </summary>
+    /// <returns>Number of real roots written in roots</returns>
+    static int solve_cubic(double c3, double c2, double c1, double c0, double roots[3]);
+
+    /// <summary>
+    /// Solve c4*x^4 + c3*x^3 + c2*x^2 + c1*x + c0 = 0 (Ferrari method with resolvent cubic)
+    /// </summary>
+    /// <returns>Number of real roots written in roots</returns>
+    static int solve_quartic(double c4, double c3, double c2, double c1, double c0, double roots[4]);
+
+private:
+    static double polish_quartic_root(double c4, double c3, double c2, double c1, double c0, double x);
+    static void sort_roots(double* roots, int count);
+};
@@ -0,0 +1,96 @@
+#include "spherical_sampling.h"
+
+#include "../constants.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+// computations are done in double whatever the rreal precision (small triangles lose precision quickly)
+
+static glm::dvec3 safe_normalize(const glm::dvec3& v)
+{
+    double len = glm::length(v);
+    return len > 0.0 ? v / len : glm::dvec3(0.0);
+}
+
+/// <summary>
+/// Angle at vertex a of spherical triangle (a, b, c) (angle between the great circles ab and ac)
+/// </summary>
+static double spherical_angle(const glm::dvec3& a, const glm::dvec3& b, const glm::dvec3& c)
+{
+    glm::dvec3 n_ab = safe_normalize(glm::cross(a, b));
+    glm::dvec3 n_ac = safe_normalize(glm::cross(a, c));
+
+    return std::acos(std::clamp(glm::dot(n_ab, n_ac), -1.0, 1.0));
+}
+
+double spherical_triangle_solid_angle(const point3& o, const point3& a, const point3& b, const point3& c)
+{
+    glm::dvec3 A = safe_normalize(glm::dvec3(a) - glm::dvec3(o));
+    glm::dvec3 B = safe_normalize(glm::dvec3(b) - glm::dvec3(o));
+    glm::dvec3 C = safe_normalize(glm::dvec3(c) - glm::dvec3(o));
+
+    double numerator = std::abs(glm::dot(A, glm::cross(B, C)));
+    double denominator = 1.0 + glm::dot(A, B) + glm::dot(A, C) + glm::dot(B, C);
+
+    return 2.0 * std::atan2(numerator, denominator);
+}
+
+vector3 sample_spherical_triangle(const point3& o, const point3& a, const point3& b, const point3& c, double u1, double u2)
+{
+    glm::dvec3 A = safe_normalize(glm::dvec3(a) - glm::dvec3(o));
+    glm::dvec3 B = safe_normalize(glm::dvec3(b) - glm::dvec3(o));
+    glm::dvec3 C = safe_normalize(glm::dvec3(c) - glm::dvec3(o));
+
+    // vertex angles and spherical area
+    double alpha = spherical_angle(A, B, C);
+    double beta = spherical_angle(B, C, A);
+    double gamma = spherical_angle(C, A, B);
+    double area = alpha + beta + gamma - M_PI;
+
+    // u1 selects the sub triangle (A, B, C') of area u1 x area
+    double sub_area = u1 * area;
+    double s = std::sin(sub_area - alpha);
+    double t = std::cos(sub_area - alpha);
+    double cos_alpha = std::cos(alpha);
+    double sin_alpha = std::sin(alpha);
+    double cos_c = glm::dot(A, B);
+
+    double u = t - cos_alpha;
+    double v = s + sin_alpha * cos_c;
+
+    double q_denominator = (v * s + u * t) * sin_alpha;
+    double q = q_denominator != 0.0 ? ((v * t - u * s) * cos_alpha - v) / q_denominator : 1.0;
+    q = std::clamp(q, -1.0, 1.0);
+
+    glm::dvec3 C_prime = q * A + std::sqrt(std::max(0.0, 1.0 - q * q)) * safe_normalize(C - glm::dot(C, A) * A);
+
+    // u2 selects the point on the arc from B to C'
+    double z = 1.0 - u2 * (1.0 - glm::dot(C_prime, B));
+    z = std::clamp(z, -1.0, 1.0);
+
+    glm::dvec3 P = z * B + std::sqrt(std::max(0.0, 1.0 - z * z)) * safe_normalize(C_prime - glm::dot(C_prime, B) * B);
+
+    return vector3(safe_normalize(P));
+}
+
+bool spherical_triangle_contains(const point3& o, const point3& a, const point3& b, const point3& c, const vector3& direction)
+{
+    glm::dvec3 A = glm::dvec3(a) - glm::dvec3(o);
+    glm::dvec3 B = glm::dvec3(b) - glm::dvec3(o);
+    glm::dvec3 C = glm::dvec3(c) - glm::dvec3(o);
+    glm::dvec3 d = glm::dvec3(direction);
+
+    // d = l1 A + l2 B + l3 C with all li > 0 means the ray crosses the triangle
+    double orientation = glm::dot(A, glm::cross(B, C));
+    if (orientation == 0.0)
+        return false;
+
+    double s1 = glm::dot(d, glm::cross(B, C)) * orientation;
+    double s2 = glm::dot(d, glm::cross(C, A)) * orientation;
+    double s3 = glm::dot(d, glm::cross(A, B)) * orientation;
+
+    return s1 >= 0.0 && s2 >= 0.0 && s3 >= 0.0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "types.h"
+
+/// <summary>
+/// Solid angle sampling of planar shapes seen from a point
+/// A triangle seen from o is a spherical triangle, directions are sampled uniformly inside it so that the pdf is simply 1 / solid angle
+/// https://www.graphics.cornell.edu/pubs/1995/Arv95c.pdf (Arvo 1995, stratified sampling of spherical triangles)
+/// </summary>
+
+/// <summary>
+/// Below this solid angle (steradians) spherical triangle sampling loses precision, area sampling must be used instead
+/// </summary>
+constexpr double MIN_SPHERICAL_SAMPLING_SOLID_ANGLE = 3e-4;
+
+/// <summary>
+/// Solid angle of triangle (a, b, c) seen from o (Van Oosterom & Strackee formula)
+/// </summary>
+double spherical_triangle_solid_angle(const point3& o, const point3& a, const point3& b, const point3& c);
+
+/// <summary>
+/// Unit direction from o uniformly distributed inside the spherical triangle (a, b, c), u1 and u2 are uniform in [0, 1)
+/// The mapping is area preserving, stratified u1 u2 give stratified directions
+/// </summary>
+vector3 sample_spherical_triangle(const point3& o, const point3& a, const point3& b, const point3& c, double u1, double u2);
+
+/// <summary>
+/// True if the ray from o with the given direction goes through triangle (a, b, c) (sign test, no intersection needed)
+/// </summary>
+bool spherical_triangle_contains(const point3& o, const point3& a, const point3& b, const point3& c, const vector3& direction);
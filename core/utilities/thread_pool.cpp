@@ -0,0 +1,82 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace
+{
+    // pool running the current thread (null outside the workers)
+    thread_local const thread_pool* t_pool = nullptr;
+}
+
+thread_pool::thread_pool(unsigned int nb_threads)
+{
+    nb_threads = std::max(nb_threads, 1u);
+
+    for (unsigned int i = 0; i < nb_threads; i++)
+        m_workers.emplace_back(&thread_pool::work, this);
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    // the queued tasks are still run
+    m_available.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void thread_pool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+
+    m_available.notify_one();
+}
+
+unsigned int thread_pool::size() const
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+unsigned int thread_pool::region_threads()
+{
+    unsigned int cores = std::max(std::thread::hardware_concurrency(), 1u);
+    if (!t_pool)
+        return cores;
+
+    // the cores are shared by the tasks running right now, a lone decode still gets all of them
+    unsigned int busy = std::max(t_pool->m_busy.load(), 1u);
+    return std::max(cores / busy, 1u);
+}
+
+void thread_pool::work()
+{
+    t_pool = this;
+
+    for (;;)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_available.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        m_busy++;
+        task();
+        m_busy--;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// Fixed set of worker threads running tasks in submission order (FIFO)
+/// A task may wait for a task submitted before it (it has already been started), never for a later one
+/// OpenMP parallel regions inside a task should ask region_threads() for their thread count (cores shared by the running tasks)
+/// </summary>
+class thread_pool
+{
+public:
+    explicit thread_pool(unsigned int nb_threads);
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    unsigned int size() const;
+
+    /// <summary>
+    /// Threads a parallel region started by the calling thread may use : the cores divided by the busy workers of its pool (all the cores outside a pool)
+    /// </summary>
+    static unsigned int region_threads();
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_available;
+    bool m_stopping = false;
+    std::atomic<unsigned int> m_busy{0};
+
+    void work();
+};
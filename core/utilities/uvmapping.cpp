@@ -85,7 +85,7 @@ void uvmapping::repeat_v(double rv)
 }
 
 
-void get_spherical_uv(const point3& p, double& u, double& v)
+void get_spherical_uv(const point3& p, rreal& u, rreal& v)
 {
 	// p: a given point on the sphere of radius one, centered at the origin.
 	// u: returned value [0,1] of angle around the Y axis from X=-1.
@@ -101,7 +101,7 @@ void get_spherical_uv(const point3& p, double& u, double& v)
 	v = theta / M_PI;
 }
 
-void get_spherical_uv(const point3& p, double texture_width, double texture_height, double render_width, double render_height, double& u, double& v)
+void get_spherical_uv(const point3& p, double texture_width, double texture_height, double render_width, double render_height, rreal& u, rreal& v)
 {
 	// p: a given point on the sphere of radius one, centered at the origin.
 	// u: returned value [0,1] of angle around the Y axis from X=-1.
@@ -147,7 +147,7 @@ vector3 from_spherical_uv(double u, double v)
 
 
 
-void get_sphere_uv(const point3& p, double& u, double& v, const uvmapping& mapping)
+void get_sphere_uv(const point3& p, rreal& u, rreal& v, const uvmapping& mapping)
 {
     // p: a given point on the sphere of radius one, centered at the origin.
     // u: returned value [0,1] of angle around the Y axis from X=-1.
@@ -173,7 +173,7 @@ void get_sphere_uv(const point3& p, double& u, double& v, const uvmapping& mappi
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_torus_uv(const vector3& p, vector3& c, double& u, double& v, double majorRadius, double minorRadius, const uvmapping& mapping)
+void get_torus_uv(const vector3& p, vector3& c, rreal& u, rreal& v, double majorRadius, double minorRadius, const uvmapping& mapping)
 {
 	//double phi = atan2(p.y, p.x);
 	//if (phi < 0) phi += 2 * M_PI; // Ensure phi is in [0, 2*pi]
@@ -228,7 +228,7 @@ void get_torus_uv(const vector3& p, vector3& c, double& u, double& v, double maj
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_cylinder_uv(const vector3& p, double& u, double& v, double radius, double height, const uvmapping& mapping)
+void get_cylinder_uv(const vector3& p, rreal& u, rreal& v, double radius, double height, const uvmapping& mapping)
 {
 	// Calculate the angle around the cylinder using atan2
 	double theta = std::atan2(p.x, p.z);
@@ -249,7 +249,7 @@ void get_cylinder_uv(const vector3& p, double& u, double& v, double radius, doub
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_disk_uv(const vector3& p, double& u, double& v, double radius, const uvmapping& mapping)
+void get_disk_uv(const vector3& p, rreal& u, rreal& v, double radius, const uvmapping& mapping)
 {
 	//// Calculate the angle around the disk using atan2
 	//double theta = std::atan2(p.x, p.z);
@@ -289,7 +289,7 @@ void get_disk_uv(const vector3& p, double& u, double& v, double radius, const uv
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_cone_uv(const vector3& p, double& u, double& v, double radius, double height, const uvmapping& mapping)
+void get_cone_uv(const vector3& p, rreal& u, rreal& v, double radius, double height, const uvmapping& mapping)
 {
 	// Calculate the angle around the cone using atan2
 	double theta = atan2(p.x, p.z);
@@ -312,7 +312,7 @@ void get_cone_uv(const vector3& p, double& u, double& v, double radius, double h
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_xy_rect_uv(double x, double y, double& u, double& v, float x0, float x1, float y0, float y1, const uvmapping& mapping)
+void get_xy_rect_uv(double x, double y, rreal& u, rreal& v, float x0, float x1, float y0, float y1, const uvmapping& mapping)
 {
 	// Calculate normalized coordinates (s, t) within the range [0, 1]
 	double s = (x - x0) / (x1 - x0);
@@ -327,7 +327,7 @@ void get_xy_rect_uv(double x, double y, double& u, double& v, float x0, float x1
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_xz_rect_uv(double x, double z, double& u, double& v, float x0, float x1, float z0, float z1, const uvmapping& mapping)
+void get_xz_rect_uv(double x, double z, rreal& u, rreal& v, float x0, float x1, float z0, float z1, const uvmapping& mapping)
 {
 	// Calculate normalized coordinates (s, t) within the range [0, 1]
 	double s = (x - x0) / (x1 - x0);
@@ -342,7 +342,7 @@ void get_xz_rect_uv(double x, double z, double& u, double& v, float x0, float x1
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_yz_rect_uv(double y, double z, double& u, double& v, float y0, float y1, float z0, float z1, const uvmapping& mapping)
+void get_yz_rect_uv(double y, double z, rreal& u, rreal& v, float y0, float y1, float z0, float z1, const uvmapping& mapping)
 {
 	// Calculate normalized coordinates (s, t) within the range [0, 1]
 	double s = (y - y0) / (y1 - y0);
@@ -357,7 +357,7 @@ void get_yz_rect_uv(double y, double z, double& u, double& v, float y0, float y1
 	v = mapping.scale_v() * t + mapping.offset_v();
 }
 
-void get_triangle_uv(const vector3 hitpoint, double& u, double& v, const vector3 verts[3], const vector2 vert_uvs[3])
+void get_triangle_uv(const vector3 hitpoint, rreal& u, rreal& v, const vector3 verts[3], const vector2 vert_uvs[3])
 {
 	// https://www.irisa.fr/prive/kadi/Cours_LR2V/Cours/RayTracing_Texturing.pdf
 	// https://computergraphics.stackexchange.com/questions/7738/how-to-assign-calculate-triangle-texture-coordinates
@@ -394,7 +394,7 @@ vector2 calculateTextureCoordinate(vector2 uv0, vector2 uv1, vector2 uv2, const
 /// <summary>
 /// TODO ! Could be enhanced by using stb_resize probably !
 /// </summary>
-void get_screen_uv(int x, int y, double texture_width, double texture_height, double render_width, double render_height, double& u, double& v)
+void get_screen_uv(int x, int y, double texture_width, double texture_height, double render_width, double render_height, rreal& u, rreal& v)
 {
 	// Calculate normalized coordinates (u, v) within the range [0, 1]
 	// Normalize pixel coordinates to [0, 1] with proper floating-point division